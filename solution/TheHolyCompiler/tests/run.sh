@@ -0,0 +1,119 @@
+#!/bin/bash
+# Compiles every test shader with the compiler given as the first argument
+# and fails if the compiler crashes, returns an error or reports one.
+
+THC=${1:?usage: run.sh <path to compiler>}
+DIR=$(cd "$(dirname "$0")" && pwd)
+OUT=$(mktemp -d)
+FAILED=0
+
+check() {
+	local name=$1
+	shift
+
+	local log
+	log=$("$THC" "$@" -out="$OUT/$name.spv" 2>&1)
+	local rc=$?
+
+	if [ $rc -ne 0 ] || echo "$log" | grep -q "ERROR"; then
+		echo "FAIL $name (exit code $rc)"
+		echo "$log"
+		FAILED=1
+	else
+		echo "ok   $name"
+	fi
+}
+
+# Prints how many instructions in the module match pattern. The first field is the opcode, the others are the
+# following words in decimal, "x" matches any word
+count_inst() {
+	od -An -tu4 -v "$1" | awk -v pattern="$2" '
+		{ for (i = 1; i <= NF; i++) words[n++] = $i }
+		END {
+			p = split(pattern, want, " ")
+			count = 0
+
+			for (i = 5; i < n; i += wc) {
+				wc = int(words[i] / 65536)
+
+				if (wc == 0) break
+
+				match_ = 1
+
+				for (j = 1; j <= p && match_; j++) {
+					if (want[j] == "x") continue
+
+					w = j == 1 ? words[i] % 65536 : words[i + j - 1]
+
+					if (j > wc || w != want[j]) match_ = 0
+				}
+
+				count += match_
+			}
+
+			print count
+		}'
+}
+
+# Fails the test if the output of the check called name doesn't have exactly count instructions matching pattern.
+# Linked checks write a module per stage, the optional fourth argument picks it
+expect() {
+	local name=$1
+	local pattern=$2
+	local count=$3
+	local file="$OUT/$name.spv${4:+.$4}"
+
+	local found
+	found=$(count_inst "$file" "$pattern")
+
+	if [ "$found" != "$count" ]; then
+		echo "FAIL $name (expected $count instructions matching \"$pattern\", found $found)"
+		FAILED=1
+	fi
+}
+
+check shader_vertex -vertex -D=VERT "$DIR/../test.thsl"
+check shader_fragment -fragment "$DIR/../test.thsl"
+check calls -fragment "$DIR/calls.thsl"
+check calls_optimized -O -fragment "$DIR/calls.thsl"
+check branches -fragment "$DIR/branches.thsl"
+check branches_optimized -O -fragment "$DIR/branches.thsl"
+check loops -fragment "$DIR/loops.thsl"
+check loops_optimized -O -fragment "$DIR/loops.thsl"
+check specconstants -fragment "$DIR/specconstants.thsl"
+check specconstants_optimized -O -fragment "$DIR/specconstants.thsl"
+check intmul -fragment "$DIR/intmul.thsl"
+check intmul_optimized -O -fragment "$DIR/intmul.thsl"
+# int vector * int scalar can't use OpVectorTimesScalar, it's float only
+expect intmul "142" 0
+expect intmul "132" 1
+check link -link "$DIR/link.vert.thsl" "$DIR/link.frag.thsl"
+check packvaryings -link -packvaryings "$DIR/packvaryings.vert.thsl" "$DIR/packvaryings.frag.thsl"
+# Five varyings packed into three locations, the ones emptied by packing are closed up
+expect packvaryings "71 x 30 2" 1 vert
+expect packvaryings "71 x 30 3" 0 vert
+expect packvaryings "71 x 30 4" 0 vert
+expect packvaryings "71 x 30 2" 1 frag
+expect packvaryings "71 x 30 3" 0 frag
+expect packvaryings "71 x 30 4" 0 frag
+check packuniforms -vertex -packuniforms "$DIR/packuniforms.thsl"
+check uniformblocks -fragment "$DIR/uniformblocks.thsl"
+# OpTypeStruct and Block decorations
+expect uniformblocks "30" 2
+expect uniformblocks "71 x 2" 2
+check compute -compute "$DIR/compute.thsl"
+check compute_optimized -O -compute "$DIR/compute.thsl"
+# LocalInvocationId
+expect compute "71 x 11 27" 1
+# shared is only a keyword in compute shaders and memoryBarrier can't order workgroup memory outside them
+check memorybarrier -fragment "$DIR/memorybarrier.thsl"
+expect memorybarrier "43 x x 2376" 0
+expect memorybarrier "43 x x 2120" 1
+check recompile -fragment "$DIR/recompile.thsl" -recompile="$DIR/recompile_edit.thsl"
+check recompile_globals -fragment "$DIR/recompile.thsl" -recompile="$DIR/recompile_globals.thsl"
+check recompile_dropcall -fragment "$DIR/recompile.thsl" -recompile="$DIR/recompile_dropcall.thsl"
+check recompile_addcall -fragment "$DIR/recompile.thsl" -recompile="$DIR/recompile_addcall.thsl"
+check recompile_addcall_debug -eDI -fragment "$DIR/recompile.thsl" -recompile="$DIR/recompile_addcall.thsl"
+
+rm -rf "$OUT"
+exit $FAILED
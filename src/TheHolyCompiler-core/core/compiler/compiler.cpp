@@ -27,6 +27,7 @@ SOFTWARE.
 #include <util/utils.h>
 #include <core/preprocessor/preprocessor.h>
 #include <util/log.h>
+#include <core/optimizer/optimizer.h>
 
 namespace thc {
 namespace core {
@@ -49,130 +50,146 @@ List<Token> Compiler::Tokenize() {
 	List<Token> tokens;
 
 	for (uint64 i = 0; i < lines.GetCount(); i++) {
-		const Line& l = lines[i];
-		const String& line = l.string;
+		if (incremental) lineTokenOffsets.Add(tokens.GetCount());
 
-		for (uint64 j = 0; j < line.length; j++) {
-			const char c0 = line[j];
-			const char c1 = j < line.length-1 ? line[j+1] : 0;
+		TokenizeLine(lines[i], tokens);
+	}
 
-			if (IsCharWhitespace(c0)) {
-				continue;
-			} else if (c0 == '(') {
-				tokens.Emplace(TokenType::ParenthesisOpen, "(", l, j+1);
-			} else if (c0 == ')') {
-				tokens.Emplace(TokenType::ParenthesisClose, ")", l, j+1);
-			} else if (c0 == '{') {
-				tokens.Emplace(TokenType::CurlyBracketOpen, "{", l, j+1);
-			} else if (c0 == '}') {
-				tokens.Emplace(TokenType::CurlyBracketClose, "}", l, j+1);
-			} else if (c0 == '[') {
-				tokens.Emplace(TokenType::BracketOpen, "[", l, j+1);
-			} else if (c0 == ']') {
-				tokens.Emplace(TokenType::BracketClose, "]", l, j+1);
-			} else if (c0 == ';') {
-				tokens.Emplace(TokenType::SemiColon, 0, ";", l, j+1);
-			} else if (c0 == '+' && c1 == '+') {
-				tokens.Emplace(TokenType::OperatorIncrement, "++", l, ++j);
-			} else if (c0 == '-' && c1 == '-') {
-				tokens.Emplace(TokenType::OperatorDecrement, "--", l, ++j);
-			} else if (c0 == '+' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorCompoundAdd, "+=", l, ++j);
-			} else if (c0 == '-' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorCompoundSub, "-=", l, ++j);
-			} else if (c0 == '*' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorCompoundMul, "*=", l, ++j);
-			} else if (c0 == '/' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorCompoundDiv, "/=", l, ++j);
-			} else if (c0 == '<' && c1 == '<') {
-				tokens.Emplace(TokenType::OperatorLeftShift, "<<", l, ++j);
-			} else if (c0 == '>' && c1 == '>') {
-				tokens.Emplace(TokenType::OperatorRightShift, ">>", l, ++j);
-			} else if (c0 == '<' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorLessEqual, "<=", l, ++j);
-			} else if (c0 == '>' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorGreaterEqual, ">=", l, ++j);
-			} else if (c0 == '&' && c1 == '&') {
-				tokens.Emplace(TokenType::OperatorLogicalAnd, "&&", l, ++j);
-			} else if (c0 == '|' && c1 == '|') {
-				tokens.Emplace(TokenType::OperatorLogicalOr, "||", l, ++j);
-			} else if (c0 == '=' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorEqual, "==", l, ++j);
-			} else if (c0 == '!' && c1 == '=') {
-				tokens.Emplace(TokenType::OperatorNotEqual, "!=", l, ++j);
-			} else if (c0 == '+') {
-				tokens.Emplace(TokenType::OperatorAdd, "+", l, j+1);
-			} else if (c0 == '*') {
-				tokens.Emplace(TokenType::OperatorMul, "*", l, j+1);
-			} else if (c0 == '/') {
-				tokens.Emplace(TokenType::OperatorDiv, "/", l, j+1);
-			} else if (c0 == '<') {
-				tokens.Emplace(TokenType::OperatorLess, "<", l, j+1);
-			} else if (c0 == '>') {
-				tokens.Emplace(TokenType::OperatorGreater, ">", l, j+1);
-			} else if (c0 == '!') {
-				tokens.Emplace(TokenType::OperatorLogicalNot, "!", l, j+1);
-			} else if (c0 == '&') {
-				tokens.Emplace(TokenType::OperatorBitwiseAnd, "&", l, j+1);
-			} else if (c0 == '|') {
-				tokens.Emplace(TokenType::OperatorBitwiseOr, "|", l, j+1);
-			} else if (c0 == '~') {
-				tokens.Emplace(TokenType::OperatorBitwiseNot, "~", l, j+1);
-			} else if (c0 == '^') {
-				tokens.Emplace(TokenType::OperatorBitwiseXor, "^", l, j+1);
-			} else if (c0 == '?') {
-				tokens.Emplace(TokenType::OperatorTernary1, "?", l, j+1);
-			} else if (c0 == ':') {
-				tokens.Emplace(TokenType::OperatorTernary2, ":", l, j+1);
-			} else if (c0 == '.') {
-				tokens.Emplace(TokenType::OperatorSelector, ".", l, j+1);
-			} else if (c0 == ',') {
-				tokens.Emplace(TokenType::Comma, ",", l, j+1);
-			} else if (c0 == '=') {
-				tokens.Emplace(TokenType::OperatorAssign, "=", l, j+1);
-			} else if (c0 >= '0' && c0 <= '9') {
-				uint64 len = 0;
-				
-				ValueResult res = Utils::StringToValue(line.str+j-1, &len, l, j);
+	if (incremental) {
+		lineTokenOffsets.Add(tokens.GetCount());
+		rawTokens = tokens;
+	}
 
-				Token tmp(TokenType::Value, res.value, line.SubString(j - (line[j - 1] == '-' ? 1 : 0), j + len - 1), l, j);
+	ProcessTokens(tokens);
 
-				switch (res.type) {
-					case ValueResultType::Float:
-						tmp.valueType = TokenType::TypeFloat;
-						break;
-					case ValueResultType::Int:
-						tmp.valueType = TokenType::TypeInt;
-						tmp.sign = res.sign;
-				}
+	return tokens;
+}
 
-				tokens.Emplace(tmp);
+void Compiler::TokenizeLine(const Line& l, List<Token>& tokens) {
+	const String& line = l.string;
+
+	for (uint64 j = 0; j < line.length; j++) {
+		const char c0 = line[j];
+		const char c1 = j < line.length-1 ? line[j+1] : 0;
+
+		if (IsCharWhitespace(c0)) {
+			continue;
+		} else if (c0 == '(') {
+			tokens.Emplace(TokenType::ParenthesisOpen, "(", l, j+1);
+		} else if (c0 == ')') {
+			tokens.Emplace(TokenType::ParenthesisClose, ")", l, j+1);
+		} else if (c0 == '{') {
+			tokens.Emplace(TokenType::CurlyBracketOpen, "{", l, j+1);
+		} else if (c0 == '}') {
+			tokens.Emplace(TokenType::CurlyBracketClose, "}", l, j+1);
+		} else if (c0 == '[') {
+			tokens.Emplace(TokenType::BracketOpen, "[", l, j+1);
+		} else if (c0 == ']') {
+			tokens.Emplace(TokenType::BracketClose, "]", l, j+1);
+		} else if (c0 == ';') {
+			tokens.Emplace(TokenType::SemiColon, 0, ";", l, j+1);
+		} else if (c0 == '+' && c1 == '+') {
+			tokens.Emplace(TokenType::OperatorIncrement, "++", l, ++j);
+		} else if (c0 == '-' && c1 == '-') {
+			tokens.Emplace(TokenType::OperatorDecrement, "--", l, ++j);
+		} else if (c0 == '+' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorCompoundAdd, "+=", l, ++j);
+		} else if (c0 == '-' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorCompoundSub, "-=", l, ++j);
+		} else if (c0 == '*' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorCompoundMul, "*=", l, ++j);
+		} else if (c0 == '/' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorCompoundDiv, "/=", l, ++j);
+		} else if (c0 == '<' && c1 == '<') {
+			tokens.Emplace(TokenType::OperatorLeftShift, "<<", l, ++j);
+		} else if (c0 == '>' && c1 == '>') {
+			tokens.Emplace(TokenType::OperatorRightShift, ">>", l, ++j);
+		} else if (c0 == '<' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorLessEqual, "<=", l, ++j);
+		} else if (c0 == '>' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorGreaterEqual, ">=", l, ++j);
+		} else if (c0 == '&' && c1 == '&') {
+			tokens.Emplace(TokenType::OperatorLogicalAnd, "&&", l, ++j);
+		} else if (c0 == '|' && c1 == '|') {
+			tokens.Emplace(TokenType::OperatorLogicalOr, "||", l, ++j);
+		} else if (c0 == '=' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorEqual, "==", l, ++j);
+		} else if (c0 == '!' && c1 == '=') {
+			tokens.Emplace(TokenType::OperatorNotEqual, "!=", l, ++j);
+		} else if (c0 == '+') {
+			tokens.Emplace(TokenType::OperatorAdd, "+", l, j+1);
+		} else if (c0 == '*') {
+			tokens.Emplace(TokenType::OperatorMul, "*", l, j+1);
+		} else if (c0 == '/') {
+			tokens.Emplace(TokenType::OperatorDiv, "/", l, j+1);
+		} else if (c0 == '<') {
+			tokens.Emplace(TokenType::OperatorLess, "<", l, j+1);
+		} else if (c0 == '>') {
+			tokens.Emplace(TokenType::OperatorGreater, ">", l, j+1);
+		} else if (c0 == '!') {
+			tokens.Emplace(TokenType::OperatorLogicalNot, "!", l, j+1);
+		} else if (c0 == '&') {
+			tokens.Emplace(TokenType::OperatorBitwiseAnd, "&", l, j+1);
+		} else if (c0 == '|') {
+			tokens.Emplace(TokenType::OperatorBitwiseOr, "|", l, j+1);
+		} else if (c0 == '~') {
+			tokens.Emplace(TokenType::OperatorBitwiseNot, "~", l, j+1);
+		} else if (c0 == '^') {
+			tokens.Emplace(TokenType::OperatorBitwiseXor, "^", l, j+1);
+		} else if (c0 == '?') {
+			tokens.Emplace(TokenType::OperatorTernary1, "?", l, j+1);
+		} else if (c0 == ':') {
+			tokens.Emplace(TokenType::OperatorTernary2, ":", l, j+1);
+		} else if (c0 == '.') {
+			tokens.Emplace(TokenType::OperatorSelector, ".", l, j+1);
+		} else if (c0 == ',') {
+			tokens.Emplace(TokenType::Comma, ",", l, j+1);
+		} else if (c0 == '=') {
+			tokens.Emplace(TokenType::OperatorAssign, "=", l, j+1);
+		} else if (c0 >= '0' && c0 <= '9') {
+			uint64 len = 0;
+			
+			ValueResult res = Utils::StringToValue(line.str+j-1, &len, l, j);
 
-				j += len-1;
+			Token tmp(TokenType::Value, res.value, line.SubString(j - (line[j - 1] == '-' ? 1 : 0), j + len - 1), l, j);
 
-			} else if (c0 == '-') {
-				tokens.Emplace(TokenType::OperatorSub, "-", l, j+1);
-			} else {
-				uint64 end = ~0;
+			switch (res.type) {
+				case ValueResultType::Float:
+					tmp.valueType = TokenType::TypeFloat;
+					break;
+				case ValueResultType::Int:
+					tmp.valueType = TokenType::TypeInt;
+					tmp.sign = res.sign;
+			}
 
-				for (uint64 c = j; c < line.length; c++) {
-					if (!IsCharAllowedInName(line[c], c == j ? true : false)) {
-						end = c;
-						break;
-					}
-				}
+			tokens.Emplace(tmp);
 
-				if (end == j) {
-					Log::CompilerError(l, j, "Unexpect symbol \"%c\"", c0);
-				}
+			j += len-1;
 
-				tokens.Emplace(TokenType::Name, 0, line.SubString(j, end-1), l, j+1);
+		} else if (c0 == '-') {
+			tokens.Emplace(TokenType::OperatorSub, "-", l, j+1);
+		} else {
+			uint64 end = ~0;
 
-				j = end-1;
+			for (uint64 c = j; c < line.length; c++) {
+				if (!IsCharAllowedInName(line[c], c == j ? true : false)) {
+					end = c;
+					break;
+				}
 			}
+
+			if (end == j) {
+				Log::CompilerError(l, j, "Unexpect symbol \"%c\"", c0);
+			}
+
+			tokens.Emplace(TokenType::Name, 0, line.SubString(j, end-1), l, j+1);
+
+			j = end-1;
 		}
 	}
+}
 
+void Compiler::ProcessTokens(List<Token>& tokens) {
 	for (uint64 i = 0; i < tokens.GetCount(); i++) {
 		Token& t = tokens[i];
 
@@ -190,8 +207,6 @@ List<Token> Compiler::Tokenize() {
 			}
 		}
 	}
-
-	return tokens;
 }
 
 void Compiler::ParseTokens(List<Token>& tokens) {
@@ -204,35 +219,49 @@ void Compiler::ParseTokens(List<Token>& tokens) {
 			ParseInOut(tokens, i--, VariableScope::In);
 		} else if (token.type == TokenType::DataOut) {
 			ParseInOut(tokens, i--, VariableScope::Out);
+		} else if (token.type == TokenType::DataShared) {
+			ParseShared(tokens, i--);
 		} else if (token.type == TokenType::DataStruct) {
 			CreateTypeStruct(tokens, i + 1, nullptr);
 			tokens.RemoveAt(i--);
 		} else if (token.type == TokenType::Name) {
 			const Token& t2 = tokens[i + 1];
 			if (t2.type == TokenType::ParenthesisOpen) {
-				ParseFunction(tokens, --i);
+				SkipFunction(tokens, --i);
 				i--;
-			} else {
-				TypeBase* type = CreateType(tokens, i - 1, nullptr);
+			} else if (t2.type != TokenType::Name) { //Struct return types are followed by the function name
+				Log::CompilerError(token, "Unexpected symbol \"%s\"", token.string.str);
+			}
+		} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::ModifierConst, TokenType::ModifierHighp, TokenType::ModifierMediump, TokenType::ModifierLowp) || Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::TypeBool, TokenType::TypeFloat, TokenType::TypeInt, TokenType::TypeMatrix, TokenType::TypeVector)) {
+			uint64 name = i;
 
-				Symbol* var = CreateGlobalVariable(type, VariableScope::Private, token.string);
-				var->variable.isConst = tokens[i - 1].type == TokenType::ModifierConst;
+			while (name < tokens.GetCount() && tokens[name].type != TokenType::Name && tokens[name].type != TokenType::SemiColon) name++;
 
-				if (t2.type == TokenType::SemiColon) {
-					continue;
-				} else if (t2.type == TokenType::OperatorAssign) {
-					 //TODO:
-				}
-			} 
+			if (name + 1 < tokens.GetCount() && tokens[name + 1].type == TokenType::ParenthesisOpen) {
+				//Return type of a function
+				i = name - 1;
+				continue;
+			}
+
+			ParseGlobalVariable(tokens, i--);
 		}
 	}
+
+	ParseReachableFunctions();
 }
 
 void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens, uint64 start, VariableStack* localVariables) {
-	uint64 closeBracket = ~0;
-
 	localVariables->PushStack(); //New stack frame
 
+	ParseStatements(declaration, tokens, start, localVariables);
+
+	localVariables->PopStack();
+}
+
+void Compiler::ParseStatements(FunctionDeclaration* declaration, List<Token>& tokens, uint64 start, VariableStack* localVariables) {
+	uint64 closeBracket = ~0;
+	bool relaxed = false; //Precision of the next declaration
+
 	for (uint64 i = start; i < tokens.GetCount(); i++) {
 		const Token& token = tokens[i];
 
@@ -240,6 +269,8 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 			//end of function
 			closeBracket = i;
 			break;
+		} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::ModifierHighp, TokenType::ModifierMediump, TokenType::ModifierLowp)) {
+			relaxed = ParsePrecision(tokens, i--);
 		} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::TypeBool, TokenType::TypeFloat, TokenType::TypeInt, TokenType::TypeMatrix, TokenType::TypeVector)) {
 			//variable declaration
 			TypeBase* t = CreateType(tokens, i, nullptr);
@@ -252,7 +283,14 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 
 			if (!localVariables->CheckName(name)) { }
 
-			CreateLocalVariable(t, name.string, localVariables);
+			Symbol* var = CreateLocalVariable(t, name.string, localVariables);
+
+			if (relaxed) {
+				var->variable.isRelaxed = true;
+				annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
+			}
+
+			relaxed = false;
 
 			const Token& next = tokens[i + 1];
 
@@ -265,17 +303,26 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 		} else if (token.type == TokenType::Name) {
 			const Token& next = tokens[i + 1];
 
-			uint64 index = typeDefinitions.Find<String>(token.string, findStructFunc);
+			TypeStruct* str = GetStruct(token.string);
 
 			if (next.type == TokenType::ParenthesisOpen) {
 				ParseInfo inf;
 				inf.start = i;
+				inf.len = 0;
 
 				ParseFunctionCall(tokens, &inf, localVariables);
 
-				tokens.Remove(i, i + inf.len);
-			} else if (index != ~0) {
-				TypeStruct* str = (TypeStruct*)typeDefinitions[index];
+				//Arguments may have consumed tokens, so the closing ")" has to be looked up again
+				uint64 close = FindMatchingToken(tokens, i + 1, TokenType::ParenthesisOpen, TokenType::ParenthesisClose);
+
+				if (close == ~0 || close + 1 >= tokens.GetCount() || tokens[close + 1].type != TokenType::SemiColon) {
+					Log::CompilerError(token, "Function call is missing \";\"");
+				}
+
+				tokens.Remove(i, close + 1);
+
+				i--;
+			} else if (str != nullptr) {
 				tokens.RemoveAt(i);
 
 				const Token& name = tokens[i];
@@ -303,7 +350,7 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 					Log::CompilerError(token, "Expression is missing \";\"");
 				}
 
-				inf.start = Utils::CompareEnums(tokens[i - 1].type, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement) ? i - 1 : i;
+				inf.start = i > start && Utils::CompareEnums(tokens[i - 1].type, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement) ? i - 1 : i;
 
 				ParseExpression(tokens, &inf, localVariables);
 
@@ -323,7 +370,7 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 					Log::CompilerError(token, "Function must return something that matches the return type");
 				}
 				
-				operation = new InstReturn;
+				operation = NewInst<InstReturn>();
 			} else {
 				if (returnVoid) {
 					Log::CompilerError(token, "Unexpected symbol \"%s\" expected \";\". Function has return type void", next.string.str);
@@ -347,7 +394,7 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 				ID* operandId;
 
 				if (res->symbolType == SymbolType::Variable) {
-					InstLoad* load = new InstLoad(type->typeId, res->id, 0);
+					InstLoad* load = NewInst<InstLoad>(type->typeId, res->id, 0);
 					instructions.Add(load);
 
 					operandId = load->id;
@@ -360,20 +407,42 @@ void Compiler::ParseBody(FunctionDeclaration* declaration, List<Token>& tokens,
 				}
 				
 
-				operation = new InstReturnValue(operandId);
+				operation = NewInst<InstReturnValue>(operandId);
 			}
 
 			instructions.Add(operation);
 
+			BeginBlock(NewInst<InstLabel>(), localVariables); //Anything after the return is unreachable
+
 		} else if (token.type == TokenType::ControlFlowIf) {
 			ParseIf(declaration, tokens, i--, localVariables);
+		} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::ControlFlowFor, TokenType::ControlFlowWhile, TokenType::BracketOpen)) {
+			ParseLoop(declaration, tokens, i--, localVariables);
+		} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::ControlFlowBreak, TokenType::ControlFlowContinue)) {
+			const Token& next = tokens[++i];
+
+			if (next.type != TokenType::SemiColon) {
+				Log::CompilerError(next, "Unexpected symbol \"%s\" expected \";\"", next.string.str);
+			}
+
+			if (loops.GetCount() == 0) {
+				Log::CompilerError(token, "\"%s\" must be inside a loop", token.string.str);
+				continue;
+			}
+
+			const Loop& loop = loops[loops.GetCount() - 1];
+
+			instructions.Add(NewInst<InstBranch>(token.type == TokenType::ControlFlowBreak ? loop.mergeBlock->id : loop.continueBlock->id));
+
+			BeginBlock(NewInst<InstLabel>(), localVariables); //Anything after the branch is unreachable
+		} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement)) {
+			//Pre increment/decrement, parsed with the name that follows
+			continue;
 		} else {
 			Log::CompilerError(token, "Unexpected symbol \"%s\"", token.string.str);
 		}
 	}
 
-	localVariables->PopStack();
-
 	tokens.Remove(start, closeBracket);
 }
 
@@ -392,64 +461,42 @@ void Compiler::ParseIf(FunctionDeclaration* declaration, List<Token>& tokens, ui
 		Log::CompilerError(parenthesisOpen, "\"(\" needs a closing \")\"");
 	}
 
-
-	Symbol* res = ParseExpression(tokens, &inf, localVariables);
-
-	if (!Utils::CompareEnums(res->type->type, CompareOperation::Or, Type::Int, Type::Float, Type::Bool)) {
-		Log::CompilerError(tokens[start + 2], "Expression must result in a scalar bool, int or float type. Is \"%s\"", res->type->typeString.str);
-	}
-
-	if (res->symbolType == SymbolType::Variable) {
-		InstLoad* load = new InstLoad(res->type->typeId, res->id, 0);
-		instructions.Add(load);
-
-		res->id = load->id;
-	}
-
-	if (res->type->type != Type::Bool) {
-		TypeBase* tmp = res->type;
-		res = ImplicitCast(CreateTypeBool(), res->type, res->id, &tokens[start + 2]);
-	}
+	ID* condition = ParseCondition(tokens, &inf, localVariables);
 
 	tokens.Remove(start, inf.end+1);
 
 	const Token& bracket = tokens[start];
 
-	InstBase* mergeBlock = new InstLabel;
-	InstBase* trueBlock = new InstLabel;
-	InstBase* falseBlock = new InstLabel;
+	InstBase* mergeBlock = NewInst<InstLabel>();
+	InstBase* trueBlock = NewInst<InstLabel>();
+	InstBase* falseBlock = NewInst<InstLabel>();
 
-	instructions.Add(new InstSelectionMerge(mergeBlock->id, 0));
-	instructions.Add(new InstBranchConditional(res->id, trueBlock->id, falseBlock->id, 1, 1));
-	instructions.Add(trueBlock);
+	instructions.Add(NewInst<InstSelectionMerge>(mergeBlock->id, 0));
+	instructions.Add(NewInst<InstBranchConditional>(condition, trueBlock->id, falseBlock->id, 1, 1));
+	BeginBlock(trueBlock, localVariables);
 
 	if (bracket.type == TokenType::CurlyBracketOpen) { 
 		tokens.RemoveAt(start);
-		ParseBody(declaration, tokens, start, localVariables);
-		ParseElse(declaration, tokens, start, localVariables, mergeBlock, falseBlock);
-	} else  {//One line if
-		ParseInfo inf;
-		inf.start = start;
-		inf.end = tokens.Find<TokenType>(TokenType::SemiColon, CmpFunc, start);
-
-		if (inf.end-- == ~0) {
+	} else  {//One line if, parsed as if it was inside brackets
+		uint64 end = FindStatementEnd(tokens, start);
+
+		if (end == ~0) {
 			Log::CompilerError(bracket, "Unexpected symbol \"%s\", expected expression or \"{\"", bracket.string.str);
 		}
 
-		ParseExpression(tokens, &inf, localVariables);
-
-		tokens.Remove(start, inf.end + 1);
-
-		ParseElse(declaration, tokens, start, localVariables, mergeBlock, falseBlock);
+		tokens.Insert(end + 1, Token(TokenType::CurlyBracketClose, "}", tokens[end].line, tokens[end].column));
 	}
 
-	instructions.Add(mergeBlock);
+	ParseBody(declaration, tokens, start, localVariables);
+	ParseElse(declaration, tokens, start, localVariables, mergeBlock, falseBlock);
+
+	BeginBlock(mergeBlock, localVariables);
 	
 }
 
 void Compiler::ParseElse(FunctionDeclaration* declaration, List<Token>& tokens, uint64 start, VariableStack* localVariables, InstBase* mergeBlock, InstBase* falseBlock) {
-	instructions.Add(new InstBranch(mergeBlock->id));
-	instructions.Add(falseBlock);
+	instructions.Add(NewInst<InstBranch>(mergeBlock->id));
+	BeginBlock(falseBlock, localVariables);
 	
 	const Token& els = tokens[start];
 
@@ -464,20 +511,85 @@ void Compiler::ParseElse(FunctionDeclaration* declaration, List<Token>& tokens,
 			tokens.RemoveAt(start);
 			ParseBody(declaration, tokens, start, localVariables);
 		} else {
-			ParseInfo inf;
-			inf.end = tokens.Find<TokenType>(TokenType::SemiColon, CmpFunc, start);
+			uint64 end = FindStatementEnd(tokens, start);
 
-			if (inf.end-- == ~0) {
+			if (end == ~0) {
 				Log::CompilerError(next, "Unexpected symbol \"%s\", expected expression or \"{\"", next.string.str);
 			}
 
-			ParseExpression(tokens, &inf, localVariables);
+			tokens.Insert(end + 1, Token(TokenType::CurlyBracketClose, "}", tokens[end].line, tokens[end].column));
 
-			tokens.Remove(start, inf.end + 1);
+			ParseBody(declaration, tokens, start, localVariables);
 		}
 	}
 
-	instructions.Add(new InstBranch(mergeBlock->id));
+	instructions.Add(NewInst<InstBranch>(mergeBlock->id));
+}
+
+ID* Compiler::ParseCondition(List<Token>& tokens, ParseInfo* info, VariableStack* localVariables) {
+	const Token first = tokens[info->start];
+
+	Symbol* res = ParseExpression(tokens, info, localVariables);
+
+	if (!Utils::CompareEnums(res->type->type, CompareOperation::Or, Type::Int, Type::Float, Type::Bool)) {
+		Log::CompilerError(first, "Expression must result in a scalar bool, int or float type. Is \"%s\"", res->type->typeString.str);
+	}
+
+	ID* id = res->id;
+
+	if (res->symbolType == SymbolType::Variable) {
+		InstLoad* load = NewInst<InstLoad>(res->type->typeId, res->id, 0);
+		instructions.Add(load);
+
+		id = load->id;
+	}
+
+	if (res->type->type != Type::Bool) {
+		id = ImplicitCastId(CreateTypeBool(), res->type, id, &first);
+	}
+
+	return id;
+}
+
+void Compiler::BeginBlock(InstBase* label, VariableStack* localVariables) {
+	instructions.Add(label);
+
+	for (uint64 i = 0; i < localVariables->variables.GetCount(); i++) {
+		localVariables->variables[i]->variable.loadId = nullptr;
+	}
+
+	for (uint64 i = 0; i < globalVariables.GetCount(); i++) {
+		globalVariables[i]->variable.loadId = nullptr;
+	}
+}
+
+uint64 Compiler::FindStatementEnd(const List<Token>& tokens, uint64 start) const {
+	if (start >= tokens.GetCount()) return ~0;
+
+	const Token& token = tokens[start];
+
+	if (token.type == TokenType::CurlyBracketOpen) {
+		return FindMatchingToken(tokens, start, TokenType::CurlyBracketOpen, TokenType::CurlyBracketClose);
+	} else if (token.type == TokenType::BracketOpen) {
+		//Attribute in front of a statement
+		uint64 close = FindMatchingToken(tokens, start, TokenType::BracketOpen, TokenType::BracketClose);
+
+		return close == ~0 ? ~0 : FindStatementEnd(tokens, close + 1);
+	} else if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::ControlFlowIf, TokenType::ControlFlowFor, TokenType::ControlFlowWhile)) {
+		uint64 close = FindMatchingToken(tokens, start, TokenType::ParenthesisOpen, TokenType::ParenthesisClose);
+
+		if (close == ~0) return ~0;
+
+		uint64 end = FindStatementEnd(tokens, close + 1);
+
+		if (token.type == TokenType::ControlFlowIf && end != ~0 && end + 1 < tokens.GetCount() && tokens[end + 1].type == TokenType::ControlFlowElse) {
+			return FindStatementEnd(tokens, end + 2);
+		}
+
+		return end;
+	}
+
+	return tokens.Find<TokenType>(TokenType::SemiColon, CmpFunc, start);
 }
 
 Compiler::Symbol* Compiler::ParseName(List<Token>& tokens, ParseInfo* info, VariableStack* localVariables) {
@@ -490,7 +602,9 @@ Compiler::Symbol* Compiler::ParseName(List<Token>& tokens, ParseInfo* info, Vari
 
 	if (var == nullptr) {
 		Log::CompilerError(name, "Unexpected symbol \"%s\" expected a variable", name.string.str);
-	} 
+	} else if (var->symbolType == SymbolType::Constant || var->symbolType == SymbolType::Result) {
+		Log::CompilerError(name, "Members of global constant \"%s\" can't be accessed", name.string.str);
+	}
 
 	Token op = tokens[info->start + offset++];
 
@@ -530,12 +644,15 @@ Compiler::Symbol* Compiler::ParseName(List<Token>& tokens, ParseInfo* info, Vari
 
 				accessIds.Add(CreateConstantS32((int32)index));
 			} else if (op.type == TokenType::BracketOpen) {
+				//The index is still parsed when the subscript is invalid so the tokens line up afterwards
+				TypeArray* arr = nullptr;
+
 				if (curr->type != Type::Array) {
 					Log::CompilerError(op, "\"%s\" is not an array", n.str);
+				} else {
+					arr = (TypeArray*)curr;
 				}
 
-				TypeArray* arr = (TypeArray*)curr;
-
 				ParseInfo inf;
 				inf.start = info->start+offset;
 				inf.end = tokens.Find<TokenType>(TokenType::BracketClose, CmpFunc, info->start+offset);
@@ -556,19 +673,21 @@ Compiler::Symbol* Compiler::ParseName(List<Token>& tokens, ParseInfo* info, Vari
 					}
 				}
 
-				if (index->symbolType == SymbolType::Variable) {
-					InstLoad* load = new InstLoad(index->type->typeId, index->id, 0);
-					instructions.Add(load);
+				if (arr != nullptr) {
+					if (index->symbolType == SymbolType::Variable) {
+						InstLoad* load = NewInst<InstLoad>(index->type->typeId, index->id, 0);
+						instructions.Add(load);
 
-					accessIds.Add(load->id);
-				} else {
-					accessIds.Add(index->id);
+						accessIds.Add(load->id);
+					} else {
+						accessIds.Add(index->id);
+					}
+
+					curr = arr->elementType;
 				}
 
 				n.Append("[]");
 
-				curr = arr->elementType;
-
 				offset = (inf.end - info->start)+2;
 			} else {
 				break;
@@ -580,7 +699,7 @@ Compiler::Symbol* Compiler::ParseName(List<Token>& tokens, ParseInfo* info, Vari
 		if (accessIds.GetCount() != 0) {
 			TypePointer* pointer = CreateTypePointer(curr, var->variable.scope);
 
-			InstInBoundsAccessChain* access = new InstInBoundsAccessChain(pointer->typeId, var->id, (uint32)accessIds.GetCount(), accessIds.GetData());
+			InstInBoundsAccessChain* access = NewInst<InstInBoundsAccessChain>(pointer->typeId, var->id, (uint32)accessIds.GetCount(), accessIds.GetData());
 
 			instructions.Add(access);
 			
@@ -625,22 +744,37 @@ bool Compiler::Process() {
 
 	List<Token> tokens = Tokenize();
 
+	if (incremental) RecordFunctions(tokens);
+
 	ParseTokens(tokens);
 
 	return true;
 }
 
-bool Compiler::GenerateFile(const String& filename) {
+bool Compiler::Generate(List<uint32>& code) {
+	FunctionDeclaration* decl = GetFunctionDeclaration("main");
+
+	if (decl == nullptr) {
+		Log::Error("No main function defined!");
+		return false;
+	}
+
+	if (!decl->defined) {
+		Log::Error("Main function not defined!");
+		return false;
+	}
+
+	//Built again on every call, everything in it except extendedInstructionSet is deleted once it's encoded
 	List<InstBase*> capabilities;
 
-	capabilities.Add(new InstCapability(THC_SPIRV_CAPABILITY_SHADER));
-	if (CompilerOptions::Float16()) capabilities.Add(new InstCapability(THC_SPIRV_CAPABILITY_FLOAT16));
-	if (CompilerOptions::Float64()) capabilities.Add(new InstCapability(THC_SPIRV_CAPABILITY_FLOAT64));
-	if (CompilerOptions::Int8()) capabilities.Add(new InstCapability(THC_SPIRV_CAPABILITY_INT8));
-	if (CompilerOptions::Int16()) capabilities.Add(new InstCapability(THC_SPIRV_CAPABILITY_INT16));
-	if (CompilerOptions::Int64()) capabilities.Add(new InstCapability(THC_SPIRV_CAPABILITY_INT64));
+	capabilities.Add(NewInst<InstCapability>(THC_SPIRV_CAPABILITY_SHADER));
+	if (CompilerOptions::Float16()) capabilities.Add(NewInst<InstCapability>(THC_SPIRV_CAPABILITY_FLOAT16));
+	if (CompilerOptions::Float64()) capabilities.Add(NewInst<InstCapability>(THC_SPIRV_CAPABILITY_FLOAT64));
+	if (CompilerOptions::Int8()) capabilities.Add(NewInst<InstCapability>(THC_SPIRV_CAPABILITY_INT8));
+	if (CompilerOptions::Int16()) capabilities.Add(NewInst<InstCapability>(THC_SPIRV_CAPABILITY_INT16));
+	if (CompilerOptions::Int64()) capabilities.Add(NewInst<InstCapability>(THC_SPIRV_CAPABILITY_INT64));
 	if (extendedInstructionSet) capabilities.Add(extendedInstructionSet);
-	capabilities.Add(new InstMemoryModel(THC_SPIRV_ADDRESSING_MODEL_LOGICAL, THC_SPIRV_MEMORY_MODEL_GLSL450));
+	capabilities.Add(NewInst<InstMemoryModel>(THC_SPIRV_ADDRESSING_MODEL_LOGICAL, THC_SPIRV_MEMORY_MODEL_GLSL450));
 
 	List<ID*> ids;
 
@@ -657,19 +791,65 @@ bool Compiler::GenerateFile(const String& filename) {
 	findIds(VariableScope::Out);
 	findIds(VariableScope::In);
 
-	uint32 executionMode = CompilerOptions::VertexShader() ? THC_SPIRV_EXECUTION_MODEL_VERTEX : CompilerOptions::FragmentShader() ? THC_SPIRV_EXECUTION_MODEL_FRAGMENT : ~0;
-	
-	FunctionDeclaration* decl = GetFunctionDeclaration("main");
+	uint32 executionMode = CompilerOptions::VertexShader() ? THC_SPIRV_EXECUTION_MODEL_VERTEX : CompilerOptions::FragmentShader() ? THC_SPIRV_EXECUTION_MODEL_FRAGMENT : CompilerOptions::ComputeShader() ? THC_SPIRV_EXECUTION_MODEL_GL_COMPUTE : ~0;
 
-	if (decl == nullptr) {
-		Log::Error("No main function defined!");
+	capabilities.Add(NewInst<InstEntryPoint>(executionMode, decl->id, "main", (uint32)ids.GetCount(), ids.GetData()));
+	if (CompilerOptions::FragmentShader()) capabilities.Add(NewInst<InstExecutionMode>(decl->id, THC_SPIRV_EXECUTION_MODE_ORIGIN_UPPER_LEFT, 0, nullptr));
+	if (CompilerOptions::ComputeShader()) capabilities.Add(NewInst<InstExecutionMode>(decl->id, THC_SPIRV_EXECUTION_MODE_LOCAL_SIZE, 3, localSize));
+
+	struct Header {
+		uint32 magic = THC_SPIRV_MAGIC_NUMBER;
+		uint32 version = 0x00010000;
+		uint32 gen = THC_GENERATOR_ID;
+		uint32 bound = 0;
+		uint32 schema = 0;
+	} header;
+
+	header.bound = idAllocator.GetCount()+1;
+
+	List<InstBase*>* sections[] = { &capabilities, &debugInstructions, &annotationIstructions, &typeInstructions, &instructions };
+
+	if (!CompilerOptions::DebugInformation()) sections[1] = nullptr;
+
+	uint64 size = sizeof(Header) >> 2;
+
+	for (List<InstBase*>* section : sections) {
+		if (section == nullptr) continue;
+
+		for (uint64 i = 0; i < section->GetCount(); i++) {
+			size += (*section)[i]->wordCount;
+		}
+	}
+
+	uint64 offset = code.GetCount();
+
+	code.Reserve(offset + size);
+	code.Resize(offset + (sizeof(Header) >> 2));
+	memcpy(code.GetData() + offset, &header, sizeof(Header));
+
+	for (List<InstBase*>* section : sections) {
+		if (section == nullptr) continue;
+
+		for (uint64 i = 0; i < section->GetCount(); i++) {
+			(*section)[i]->Encode(code);
+		}
+	}
+
+	for (uint64 i = 0; i < capabilities.GetCount(); i++) {
+		if (capabilities[i] != extendedInstructionSet) delete capabilities[i];
 	}
 
-	if (!decl->defined) Log::Error("Main function not defined!");
+	//Always compacted, the ids, types and constants of replaced function bodies would otherwise stay in the module
+	if (CompilerOptions::Optimize()) {
+		optimizer::Optimizer::Run(code, offset);
+	} else {
+		optimizer::Optimizer::Compact(code, offset);
+	}
 
-	capabilities.Add(new InstEntryPoint(executionMode, decl->id, "main", (uint32)ids.GetCount(), ids.GetData()));
-	if (CompilerOptions::FragmentShader()) capabilities.Add(new InstExecutionMode(decl->id, THC_SPIRV_EXECUTION_MODE_ORIGIN_UPPER_LEFT, 0, nullptr));
+	return true;
+}
 
+static bool WriteFile(const String& filename, const List<uint32>& code) {
 	FILE* file = fopen(filename.str, "wb");
 
 	if (file == nullptr) {
@@ -677,51 +857,69 @@ bool Compiler::GenerateFile(const String& filename) {
 		return false;
 	}
 
-	struct Header {
-		uint32 magic = THC_SPIRV_MAGIC_NUMBER;
-		uint32 version = 0x00010000;
-		uint32 gen = THC_GENERATOR_ID;
-		uint32 bound = IDManager::GetCount()+1;
-		uint32 schema = 0;
-	} header;
-
-	fwrite(&header, sizeof(Header), 1, file);
+	fwrite(code.GetData(), code.GetSize(), 1, file);
+	fclose(file);
 
-	List<uint32> code;
+	return true;
+}
 
-	uint32 writtenInstructions = 0;
+bool Compiler::WriteLayoutFile(const String& filename) const {
+	FILE* file = fopen(filename.str, "wb");
 
-	auto writeCode = [&writtenInstructions, &code, &file](List<InstBase*>& list) {
-		uint32 tmp[128];
+	if (file == nullptr) {
+		Log::Error("Failed to open file \"%s\"", filename.str);
+		return false;
+	}
 
-		for (uint64 i = 0; i < list.GetCount(); i++) {
-			InstBase* inst = list[i];
+	for (uint64 i = 0; i < blockLayouts.GetCount(); i++) {
+		const BlockLayout& layout = blockLayouts[i];
 
-			inst->GetInstWords(tmp);
+		fprintf(file, "%s binding=%u set=%u size=%u\n", layout.name.str, layout.binding, layout.set, layout.type->GetSize());
 
-			code.Add(tmp, inst->wordCount);
+		for (uint64 j = 0; j < layout.type->members.GetCount(); j++) {
+			const StructMember& m = layout.type->members[j];
 
-			writtenInstructions++;
+			fprintf(file, "\t%s index=%llu declared=%u offset=%u size=%u\n", m.name.str, j, m.index, m.offset, m.type->GetSize());
 		}
+	}
 
-		fwrite(code.GetData(), code.GetSize(), 1, file);
+	fclose(file);
 
-		code.Clear();
-	};
+	return true;
+}
 
-	writeCode(capabilities);
-	if (CompilerOptions::DebugInformation()) writeCode(debugInstructions);
-	writeCode(annotationIstructions);
-	writeCode(typeInstructions);
-	writeCode(instructions);
+bool Compiler::GenerateFile(const String& filename) {
+	List<uint32> code(0x1000);
 
-	fclose(file);
+	if (!Generate(code)) return false;
 
-	return true;
+	if (CompilerOptions::PackUniforms() && !WriteLayoutFile(filename + ".layout")) return false;
+
+	return WriteFile(filename, code);
 }
 
-Compiler::Compiler(const String& code, const String& filename, const List<String>& defines, const List<String>& includes) : code(code), filename(filename), defines(defines), includes(includes) {
+Compiler::Compiler(const String& code, const String& filename, const List<String>& defines, const List<String>& includes, bool incremental) : code(code), filename(filename), defines(defines), includes(includes), localSize{ 1, 1, 1 }, incremental(incremental), globalHash(0) {
+
+}
+
+bool Compiler::Compile(const String& code, const String& filename, const List<String>& defines, const List<String>& includes, List<uint32>& spirv, List<Diagnostic>* diagnostics) {
+	List<Diagnostic> messages(16);
+
+	Log::SetDiagnostics(&messages);
+
+	Compiler c(code, filename, defines, includes);
+
+	bool res = c.Process() && c.Generate(spirv);
+
+	Log::SetDiagnostics(nullptr);
+
+	for (uint64 i = 0; i < messages.GetCount(); i++) {
+		if (messages[i].level == LogLevel::Error) res = false;
+	}
+
+	if (diagnostics) diagnostics->Add(messages);
 
+	return res;
 }
 
 bool Compiler::Run(const String& code, const String& filename, const List<String>& defines, const List<String>& includes, const String& outFile) {
@@ -738,6 +936,36 @@ bool Compiler::Run(const String& filename, const List<String>& defines, const Li
 	return Run(Utils::ReadFile(filename), filename, defines, includes, outFile);
 }
 
+bool Compiler::Link(const String& vertexFile, const String& fragmentFile, const List<String>& defines, const List<String>& includes, const String& outFile) {
+	List<uint32> vertex(0x1000);
+	List<uint32> fragment(0x1000);
+
+	//The stage is a global option, it's switched while each stage is compiled
+	CompilerOptions::vertexShader = true;
+	CompilerOptions::fragmentShader = false;
+
+	Compiler v(Utils::ReadFile(vertexFile), vertexFile, defines, includes);
+
+	bool res = v.Process() && v.Generate(vertex);
+
+	CompilerOptions::vertexShader = false;
+	CompilerOptions::fragmentShader = true;
+
+	Compiler f(Utils::ReadFile(fragmentFile), fragmentFile, defines, includes);
+
+	res = res && f.Process() && f.Generate(fragment);
+
+	CompilerOptions::fragmentShader = false;
+
+	if (!res) return false;
+
+	optimizer::Optimizer::Link(vertex, fragment);
+
+	if (CompilerOptions::PackUniforms() && (!v.WriteLayoutFile(outFile + ".vert.layout") || !f.WriteLayoutFile(outFile + ".frag.layout"))) return false;
+
+	return WriteFile(outFile + ".vert", vertex) && WriteFile(outFile + ".frag", fragment);
+}
+
 }
 }
 }
\ No newline at end of file
@@ -25,12 +25,17 @@ SOFTWARE.
 #pragma once
 
 #include <util/string.h>
+#include <util/map.h>
 #include <core/parsing/token.h>
 #include <core/type/types.h>
 #include "options.h"
 #include "idmanager.h"
 
 namespace thc {
+namespace utils {
+struct Diagnostic;
+}
+
 namespace core {
 namespace compiler {
 
@@ -42,10 +47,17 @@ private: //Type stuff
 
 		ID* typeId; //OpType id
 
+		virtual ~TypeBase() {}
+
 		virtual bool operator==(const TypeBase* const other) const;
 		virtual bool operator!=(const TypeBase* const other) const;
 
+		//Must be equal for types where operator== returns true
+		virtual uint64 Hash() const;
+
+		//Size and base alignment inside a uniform block with the std140 layout
 		virtual uint32 GetSize() const = 0;
+		virtual uint32 GetAlignment() const = 0;
 	};
 
 	struct TypePrimitive : public TypeBase {
@@ -56,15 +68,23 @@ private: //Type stuff
 		uint8 rows;
 		uint8 columns;
 
+		TypePrimitive() {}
+		TypePrimitive(type::Type type, type::Type componentType, uint8 bits, uint8 sign, uint8 rows, uint8 columns);
+
 		bool operator==(const TypeBase* const other) const override;
 		bool operator!=(const TypeBase* const other) const override;
+		uint64 Hash() const override;
 		
 		uint32 GetSize() const override;
+		uint32 GetAlignment() const override; //For matrices this is also the stride between columns
 	};
 
 	struct StructMember {
 		utils::String name;
 		TypeBase* type;
+		bool isRelaxed; //mediump or lowp
+		uint32 index; //Position in the declaration, members of blocks may be reordered
+		uint32 offset;
 
 		bool operator==(const StructMember& other) const;
 		bool operator!=(const StructMember& other) const;
@@ -73,10 +93,13 @@ private: //Type stuff
 	struct TypeStruct : public TypeBase {
 		utils::List<StructMember> members;
 
+		//Structs are compared by name, two structs with the same members are still different types
 		bool operator==(const TypeBase* const other) const override;
 		bool operator!=(const TypeBase* const other) const override;
+		uint64 Hash() const override;
 
 		uint32 GetSize() const override;
+		uint32 GetAlignment() const override;
 
 		uint32 GetMemberIndex(const utils::String& name);
 	};
@@ -85,20 +108,30 @@ private: //Type stuff
 		uint32 elementCount;
 		TypeBase* elementType;
 
+		TypeArray() {}
+		TypeArray(TypeBase* elementType, uint32 elementCount);
+
 		bool operator==(const TypeBase* const other) const override;
 		bool operator!=(const TypeBase* const other) const override;
+		uint64 Hash() const override;
 
 		uint32 GetSize() const override;
+		uint32 GetAlignment() const override;
 	};
 
 	struct TypePointer : public TypeBase {
 		TypeBase* baseType;
 		uint32 storageClass;
 
+		TypePointer() {}
+		TypePointer(TypeBase* baseType, uint32 storageClass);
+
 		bool operator==(const TypeBase* const other) const override;
 		bool operator!=(const TypeBase* const other) const override;
+		uint64 Hash() const override;
 
 		uint32 GetSize() const override { return ~0; }
+		uint32 GetAlignment() const override { return ~0; }
 	};
 
 	enum class ImageType : uint8 {
@@ -120,10 +153,15 @@ private: //Type stuff
 
 		ID* imageId;
 
+		TypeImage() {}
+		TypeImage(ImageType imageType, uint8 depth, uint8 arrayed, uint8 multiSampled, uint8 sampled);
+
 		bool operator==(const TypeBase* const other) const override;
 		bool operator!=(const TypeBase* const other) const override;
+		uint64 Hash() const override;
 
 		uint32 GetSize() const override { return ~0; }
+		uint32 GetAlignment() const override { return ~0; }
 	};
 
 	/*struct TypeFunction : public TypeBase {
@@ -136,32 +174,78 @@ private: //Type stuff
 		uint32 GetSize() const override { return ~0; }
 	};*/
 
-	utils::List<TypeBase*> typeDefinitions;
+	//Hashes and compares the type that is pointed to
+	struct TypeKey {
+		const TypeBase* type;
+
+		uint64 Hash() const { return type->Hash(); }
+		bool operator==(const TypeKey& other) const { return *type == other.type; }
+	};
+
+	struct InstTypeKey {
+		const type::InstTypeBase* type;
+
+		uint64 Hash() const { return type->Hash(); }
+		bool operator==(const InstTypeKey& other) const { return type->opCode == other.type->opCode && *type == other.type; }
+	};
+
+	utils::Map<TypeKey, TypeBase*> typeDefinitions;
+	utils::Map<utils::String, TypeStruct*> structDefinitions;
+	utils::Map<InstTypeKey, type::InstTypeBase*> typeInstructionTable;
 
+	//data is the literal words for OpConstant and the constituent ids for OpConstantComposite
+	struct ConstantKey {
+		uint32 opCode;
+		ID* typeId;
+		const void* data;
+		uint64 size;
+
+		uint64 Hash() const { return utils::HashBytes(data, size, utils::HashCombine(utils::HashCombine(0, opCode), (uint64)typeId)); }
+		bool operator==(const ConstantKey& other) const { return opCode == other.opCode && typeId == other.typeId && size == other.size && (size == 0 || memcmp(data, other.data, size) == 0); }
+	};
+
+	utils::Map<ConstantKey, instruction::InstBase*> constants;
+	utils::Map<uint32, instruction::InstBase*> constantDefinitions; //Constant instructions by id
 	
 	utils::List<instruction::InstBase*> debugInstructions;
 	utils::List<instruction::InstBase*> annotationIstructions;
 	utils::List<instruction::InstBase*> typeInstructions;
 	utils::List<instruction::InstBase*> instructions;
 
+	IDAllocator idAllocator; //Every module numbers its ids from 1
+
+	//Instructions are only created through this, so result ids come from the allocator of the module they belong to
+	template<typename T, typename ...Args>
+	T* NewInst(Args&&... args) {
+		T* inst = new T(std::forward<Args>(args)...);
+
+		if (inst->hasResultId) inst->id = idAllocator.Allocate();
+
+		return inst;
+	}
+
 	void CheckTypeExist(type::InstTypeBase** type); 
-	void CheckTypeExist(TypeBase** type);
-	void CheckConstantExist(instruction::InstBase** constant);
-	inline void CheckConstantExist(instruction::InstConstant** constant) { CheckConstantExist((instruction::InstBase**)constant); }
-	inline void CheckConstantExist(instruction::InstConstantComposite** constant) { CheckConstantExist((instruction::InstBase**)constant); }
+	TypeBase* FindType(const TypeBase& type) const; //returns nullptr if the type hasn't been created
+	void AddType(TypeBase* type);
+	TypeStruct* GetStruct(const utils::String& name) const; //returns nullptr if there is no struct with that name
 	
 
 	TypePrimitive* CreateTypeBool();
 	//start is the index of the type
 	TypePrimitive* CreateTypePrimitive(utils::List<parsing::Token>& tokens, uint64 start, uint64* len);
 	TypePrimitive* CreateTypePrimitiveScalar(type::Type type, uint8 bits, uint8 sign);
+	TypePrimitive* CreateTypeVoid();
 	TypePrimitive* CreateTypePrimitiveVector(type::Type componentType, uint8 bits, uint8 sign, uint8 rows);
 	TypePrimitive* CreateTypePrimtiveMatrix(type::Type componentType, uint8 bits, uint8 sign, uint8 rows, uint8 columns);
 
 	TypePrimitive* ModifyTypePrimitiveBitWidth(TypePrimitive* base, uint8 bits);
 	
-	//start is the index of the name of the struct
-	TypeStruct* CreateTypeStruct(utils::List<parsing::Token>& tokens, uint64 start, uint64* len);
+	//start is the index of the name of the struct. Members of blocks are reordered to take less space if -packuniforms is set
+	TypeStruct* CreateTypeStruct(utils::List<parsing::Token>& tokens, uint64 start, uint64* len, bool isBlock = false);
+	//Orders the members so the std140 layout needs as little padding as possible
+	static void PackStructMembers(utils::List<StructMember>& members);
+
+	static uint32 RoundUp(uint32 value, uint32 alignment) { return (value + alignment - 1) / alignment * alignment; }
 	//start is start of type
 	TypeArray* CreateTypeArray(utils::List<parsing::Token>& tokens, uint64 start, uint64* len);
 	//start is start of sampeler
@@ -171,9 +255,6 @@ private: //Type stuff
 
 	utils::String GetTypeString(const TypeBase* const type) const;
 
-private:
-	static bool findStructFunc(TypeBase* const& curr, const utils::String& name);
-
 private: //Variable stuff
 	enum class VariableScope {
 		None,
@@ -182,6 +263,7 @@ private: //Variable stuff
 		Private,
 		Uniform,
 		UniformConstant,
+		Workgroup,
 		Function
 	};
 
@@ -217,6 +299,7 @@ private: //Variable stuff
 			utils::String name = "";
 
 			bool isConst;
+			bool isRelaxed = false; //mediump or lowp
 				
 			ID* loadId = nullptr;
 		};
@@ -267,6 +350,7 @@ private: //Variable stuff
 	};
 	*/
 	utils::List<Symbol*> globalVariables;
+	utils::Map<utils::String, Symbol*> globalVariableNames;
 
 	class VariableStack;
 	Symbol* GetVariable(const utils::String& name, VariableStack* localVariables) const;
@@ -291,9 +375,14 @@ private:
 	public:
 		utils::List<instruction::InstBase*> variableInstructions;
 		utils::List<Symbol*> variables;
+		utils::List<uint64> shadowed; //Index of the variable with the same name that variables[i] hides, ~0 if none
 		utils::List<uint64> offsets;
 
+		utils::Map<utils::String, uint64> names; //Index of the innermost variable with that name
+
 		Compiler* compiler;
+	private:
+		void Declare(Symbol* variable);
 	public:
 		VariableStack(Compiler* compiler, const utils::List<Symbol*>& parameters);
 		~VariableStack();
@@ -320,19 +409,26 @@ private: //Function stuff
 		utils::List<Symbol*> parameters;
 
 		bool defined;
+		bool reachable; //Called from main or a function reachable from main
 
 		ID* typeId;
 		ID* id;
 
 		utils::List<instruction::InstBase*> declInstructions;
+		utils::List<instruction::InstBase*> nameInstructions; //Only emitted if the function gets defined
+
+		utils::List<parsing::Token> definition; //Skipped definition, parsed once the function is reachable
 
 		bool operator==(const FunctionDeclaration* const other) const;
 	};
 
 	utils::List<FunctionDeclaration*> functionDeclarations;
+	utils::List<FunctionDeclaration*> reachableFunctions; //Waiting for their definition to be parsed
+	utils::List<FunctionDeclaration*> calledFunctions; //Calls in the body being parsed, in the order they were parsed
 
 	FunctionDeclaration* GetFunctionDeclaration(const utils::String& name); 
 	void CreateFunctionType(FunctionDeclaration* decl);
+	void MarkReachable(FunctionDeclaration* decl);
 
 	static bool CheckParameterName(const utils::List<Symbol*>& params, const utils::String& name); //return true if name is available
 
@@ -384,6 +480,7 @@ private: //Constants
 	ID* CreateConstant(const TypeBase* const type, float32 value);
 	ID* CreateConstantComposite(const TypeBase* const type, const utils::List<uint32>& values);
 	ID* CreateConstantComposite(const TypeBase* const type, const uint32** values);
+	ID* CreateConstantComposite(const TypeBase* const type, const utils::List<ID*>& constituents);
 	ID* CreateConstantCompositeVector(const TypeBase* const type, const uint32** values);
 	ID* CreateConstantCompositeMatrix(const TypeBase* const type, const uint32** values);
 	ID* CreateConstantCompositeArray( const TypeBase* const type, const uint32** values);
@@ -391,6 +488,14 @@ private: //Constants
 
 	bool IsTypeComposite(const TypeBase* const type) const;
 
+	//Appends the components of a constant, returns false if id isn't a constant
+	bool GetConstantValues(uint32 id, utils::List<uint32>& values) const;
+	ID* CreateConstantFromValues(const TypePrimitive* type, const utils::List<uint32>& values);
+	//Returns the constant result of instruction or nullptr if any operand isn't a constant
+	ID* FoldConstant(const instruction::InstBase* instruction, const TypePrimitive* type, const TypePrimitive* operandType);
+	//Folds the instruction if possible, otherwise it's added to the function
+	Symbol* CreateOperationResult(TypeBase* type, instruction::InstBase* instruction, const TypePrimitive* operandType = nullptr);
+
 private: //Composites
 
 
@@ -452,13 +557,37 @@ private:
 
 	utils::List<uint64> locations;
 
+	//Blocks reordered by -packuniforms, the host needs to know where the members ended up
+	struct BlockLayout {
+		utils::String name;
+		uint32 binding;
+		uint32 set;
+		TypeStruct* type;
+	};
+
+	utils::List<BlockLayout> blockLayouts;
+
+	//LocalSize execution mode of a compute shader, set by "layout (local_size_x = 8, ...) in;"
+	uint32 localSize[3];
+
+	//One line per block followed by one line per member in the new order
+	bool WriteLayoutFile(const utils::String& filename) const;
+
 	utils::List<parsing::Token> Tokenize();
+	void TokenizeLine(const parsing::Line& line, utils::List<parsing::Token>& tokens);
+	void ProcessTokens(utils::List<parsing::Token>& tokens);
 	void ParseTokens(utils::List<parsing::Token>& tokens);
 	void ParseLayout(utils::List<parsing::Token>& tokens, uint64 start);
 	void ParseInOut(utils::List<parsing::Token>& tokens, uint64 start, VariableScope scope);
+	void ParseShared(utils::List<parsing::Token>& tokens, uint64 start);
+	//start is the index of "const" or the type, specId is the constant_id of a specialization constant
+	void ParseGlobalVariable(utils::List<parsing::Token>& tokens, uint64 start, uint32 specId = ~0);
 	void ParseFunction(utils::List<parsing::Token>& tokens, uint64 start);
+	void SkipFunction(utils::List<parsing::Token>& tokens, uint64 start);
+	void ParseReachableFunctions();
 	void CreateFunctionDeclaration(FunctionDeclaration* decl);
 	void ParseBody(FunctionDeclaration* declaration, utils::List<parsing::Token>& tokens, uint64 start, VariableStack* localVariables);
+	void ParseStatements(FunctionDeclaration* declaration, utils::List<parsing::Token>& tokens, uint64 start, VariableStack* localVariables); //Same as ParseBody but without a new stack frame
 	void ParseIf(FunctionDeclaration* declaration, utils::List<parsing::Token>& tokens, uint64 start, VariableStack* localVariables);
 	void ParseElse(FunctionDeclaration* declaration, utils::List<parsing::Token>& tokens, uint64 start, VariableStack* localVariables, instruction::InstBase* mergeBlock, instruction::InstBase* falseBlock);
 	
@@ -468,6 +597,7 @@ private:
 		uint64 len;
 	};
 
+	ID* ParseCondition(utils::List<parsing::Token>& tokens, ParseInfo* info, VariableStack* localVariables); //Returns the id of a scalar bool
 	Symbol* ParseName(utils::List<parsing::Token>& tokens, ParseInfo* info, VariableStack* localVariables); //struct member selection, array subscripting and function calls
 	Symbol* ParseExpression(utils::List<parsing::Token>& tokens, ParseInfo* info, VariableStack* localVariables);
 	Symbol* ParseFunctionCall(utils::List<parsing::Token>& tokens, ParseInfo* info, VariableStack* localVariables);
@@ -478,11 +608,40 @@ private:
 
 	static utils::String GetFunctionSignature(FunctionDeclaration* decl);
 	static utils::String GetFunctionSignature(utils::List<Symbol*> parameters, const utils::String& functionName);
+private: //Control flow
+	struct Loop {
+		instruction::InstBase* mergeBlock; //Target of break
+		instruction::InstBase* continueBlock; //Target of continue
+	};
+
+	utils::List<Loop> loops; //Loops around the statement being parsed, innermost last
+
+	//start is the index of "for", "while" or the attribute in front of them
+	void ParseLoop(FunctionDeclaration* declaration, utils::List<parsing::Token>& tokens, uint64 start, VariableStack* localVariables);
+	//Emits every iteration of the loop, returns false without emitting anything if the trip count isn't known or too large
+	bool UnrollLoop(FunctionDeclaration* declaration, const utils::List<parsing::Token>& init, const utils::List<parsing::Token>& condition, const utils::List<parsing::Token>& step, const utils::List<parsing::Token>& body, VariableStack* localVariables, bool force);
+	//Adds the label and forgets previous loads since they might not dominate the new block
+	void BeginBlock(instruction::InstBase* label, VariableStack* localVariables);
+	//Returns the index of the last token in the statement at start or ~0
+	uint64 FindStatementEnd(const utils::List<parsing::Token>& tokens, uint64 start) const;
+
+private: //Global constants
+	utils::List<uint32> specIds;
+
+	//start and end are inclusive, returns the id of a constant or a specialization constant if the expression uses one
+	ID* ParseConstantInitializer(utils::List<parsing::Token>& tokens, uint64 start, uint64 end, TypePrimitive* type);
+	//value must be a constant, vector components get consecutive spec ids
+	ID* CreateSpecConstant(const TypePrimitive* type, ID* value, uint32 specId, const parsing::Token& token);
+	//Global constants are results and are never loaded
+	Symbol* CreateGlobalConstant(const TypeBase* const type, ID* id, const utils::String& name);
+
 private: //Misc
 	bool IsCharAllowedInName(const char c, bool first = true) const;
 	bool IsCharWhitespace(const char c) const;
 	void ProcessName(parsing::Token& t) const;
 	uint64 FindMatchingToken(const utils::List<parsing::Token>& tokens, uint64 start, parsing::TokenType open, parsing::TokenType close) const;
+	//Removes a precision qualifier at index if there is one, returns true if it's mediump or lowp
+	bool ParsePrecision(utils::List<parsing::Token>& tokens, uint64 index);
 	ID* GetExpressionOperandId(const Expression* e, TypePrimitive** type, bool swizzle, ID** ogID = nullptr);
 	ID* LoadVariable(Symbol* var, bool usePreviousLoad = false);
 	void StoreVariable(Symbol* var, ID* storeId, bool setAsLoadId = false);
@@ -492,13 +651,71 @@ private: //Misc
 	ID* GetSwizzledVector(TypePrimitive** type, ID* load, const utils::List<uint32>& indices);
 	void CheckIntrin(const parsing::Token& intrin, const Symbol* var);
 
+private: //Incremental compilation
+	struct FunctionRange {
+		uint64 start; //Index of the return type
+		uint64 body;  //Index of "{", ~0 if it's only a declaration
+		uint64 end;   //Index of the closing "}" or ";"
+	};
+
+	struct FunctionRecord {
+		utils::String name;
+		uint64 hash; //Hash of the body tokens
+		utils::List<parsing::Token> tokens; //Return type to closing "}"
+
+		FunctionDeclaration* declaration;
+		uint64 order; //Functions are emitted in the order a full compile would parse them
+		utils::List<FunctionDeclaration*> calls; //Every call in the body, in the order they were parsed
+
+		utils::List<instruction::InstBase*> instructions; //OpFunction to OpFunctionEnd
+		utils::List<instruction::InstBase*> debugInstructions; //Names emitted while parsing the body
+		utils::List<instruction::InstBase*> annotationInstructions; //Decorations emitted while parsing the body
+	};
+
+	bool incremental;
+	uint64 globalHash;
+
+	utils::List<parsing::Token> rawTokens; //Tokens before ProcessTokens
+	utils::List<uint64> lineTokenOffsets; //Index into rawTokens for every line + end
+
+	utils::List<FunctionRecord*> functionRecords;
+
+	utils::List<FunctionRange> FindFunctionRanges(const utils::List<parsing::Token>& tokens) const;
+	//end is exclusive
+	static uint64 HashTokens(const utils::List<parsing::Token>& tokens, uint64 start, uint64 end, uint64 hash = 0xCBF29CE484222325);
+	//Hashes everything except function bodies
+	static uint64 HashGlobals(const utils::List<parsing::Token>& tokens, const utils::List<FunctionRange>& ranges);
+
+	utils::List<parsing::Token> TokenizeChanged(const utils::List<parsing::Line>& newLines);
+	void RecordFunctions(const utils::List<parsing::Token>& tokens);
+	//Deletes everything parsing the body created, the declaration is kept
+	void RemoveFunctionBody(FunctionRecord* record);
+	void RecompileFunction(uint64 record);
+	//Sets the order of every function reachable from main to the order a full compile parses them in, the others get ~0
+	void OrderFunctions();
+	void Reset();
+
 public:
 	bool Process();
+	//Appends the module to code
+	bool Generate(utils::List<uint32>& code);
 	bool GenerateFile(const utils::String& filename);
 
-	Compiler(const utils::String& code, const utils::String& filename, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes);
+	//Requires the compiler to be created with incremental = true and Process to have been called. Only functions whose body changed are parsed again
+	bool Recompile(const utils::String& code);
+	//Recompiles and generates the module into spirv without touching the disk. Returns false if any errors were reported
+	bool Recompile(const utils::String& code, utils::List<uint32>& spirv, utils::List<utils::Diagnostic>* diagnostics = nullptr);
+
+	//Recompiles filename incrementally with the code of editedFile and checks the result against a full compile of editedFile, ids and the order of types and constants may differ
+	static bool CheckRecompile(const utils::String& filename, const utils::String& editedFile, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes, const utils::String& outFile);
+
+	Compiler(const utils::String& code, const utils::String& filename, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes, bool incremental = false);
+	//Compiles the code into spirv without writing anything to disk. Returns false if any errors were reported
+	static bool Compile(const utils::String& code, const utils::String& filename, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes, utils::List<uint32>& spirv, utils::List<utils::Diagnostic>* diagnostics = nullptr);
 	static bool Run(const utils::String& code, const utils::String& filename, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes, const utils::String& outFile);
 	static bool Run(const utils::String& filename, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes, const utils::String& outFile);
+	//Compiles both stages and removes the varyings the other stage doesn't use. The stages are written to outFile.vert and outFile.frag
+	static bool Link(const utils::String& vertexFile, const utils::String& fragmentFile, const utils::List<utils::String>& defines, const utils::List<utils::String>& includes, const utils::String& outFile);
 
 };
 
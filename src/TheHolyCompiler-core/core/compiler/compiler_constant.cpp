@@ -0,0 +1,276 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "compiler.h"
+#include <util/utils.h>
+#include <util/log.h>
+
+namespace thc {
+namespace core {
+namespace compiler {
+
+using namespace utils;
+using namespace parsing;
+using namespace type;
+using namespace instruction;
+
+auto  CmpFunc = [](const Token& curr, const TokenType& c) -> bool {
+	return curr.type == c;
+};
+
+//Operations OpSpecConstantOp allows with the Shader capability that the expression parser can produce
+static bool IsSpecConstantOperation(uint32 opCode) {
+	switch (opCode) {
+		case THC_SPIRV_OPCODE_OpSConvert:
+		case THC_SPIRV_OPCODE_OpUConvert:
+		case THC_SPIRV_OPCODE_OpFConvert:
+		case THC_SPIRV_OPCODE_OpSNegate:
+		case THC_SPIRV_OPCODE_OpNot:
+		case THC_SPIRV_OPCODE_OpIAdd:
+		case THC_SPIRV_OPCODE_OpISub:
+		case THC_SPIRV_OPCODE_OpIMul:
+		case THC_SPIRV_OPCODE_OpUDiv:
+		case THC_SPIRV_OPCODE_OpSDiv:
+		case THC_SPIRV_OPCODE_OpUMod:
+		case THC_SPIRV_OPCODE_OpSRem:
+		case THC_SPIRV_OPCODE_OpSMod:
+		case THC_SPIRV_OPCODE_OpShiftRightLogical:
+		case THC_SPIRV_OPCODE_OpShiftRightArithmetic:
+		case THC_SPIRV_OPCODE_OpShiftLeftLogical:
+		case THC_SPIRV_OPCODE_OpBitwiseOr:
+		case THC_SPIRV_OPCODE_OpBitwiseXor:
+		case THC_SPIRV_OPCODE_OpBitwiseAnd:
+		case THC_SPIRV_OPCODE_OpLogicalOr:
+		case THC_SPIRV_OPCODE_OpLogicalAnd:
+		case THC_SPIRV_OPCODE_OpLogicalNot:
+		case THC_SPIRV_OPCODE_OpLogicalEqual:
+		case THC_SPIRV_OPCODE_OpLogicalNotEqual:
+		case THC_SPIRV_OPCODE_OpSelect:
+		case THC_SPIRV_OPCODE_OpIEqual:
+		case THC_SPIRV_OPCODE_OpINotEqual:
+		case THC_SPIRV_OPCODE_OpULessThan:
+		case THC_SPIRV_OPCODE_OpSLessThan:
+		case THC_SPIRV_OPCODE_OpUGreaterThan:
+		case THC_SPIRV_OPCODE_OpSGreaterThan:
+		case THC_SPIRV_OPCODE_OpULessThanEqual:
+		case THC_SPIRV_OPCODE_OpSLessThanEqual:
+		case THC_SPIRV_OPCODE_OpUGreaterThanEqual:
+		case THC_SPIRV_OPCODE_OpSGreaterThanEqual:
+			return true;
+	}
+
+	return false;
+}
+
+void Compiler::ParseGlobalVariable(List<Token>& tokens, uint64 start, uint32 specId) {
+	uint64 offset = 0;
+
+	bool isConst = tokens[start].type == TokenType::ModifierConst;
+
+	if (isConst) offset++;
+
+	bool relaxed = ParsePrecision(tokens, start + offset);
+
+	TypePrimitive* type = CreateTypePrimitive(tokens, start + offset, nullptr);
+
+	//Copied since the initializer is parsed in place
+	const Token name = tokens[start + offset++];
+
+	if (name.type != TokenType::Name) {
+		Log::CompilerError(name, "Unexpected symbol \"%s\" expected a valid name", name.string.str);
+	}
+
+	if (!CheckGlobalName(name.string)) {
+		Log::CompilerError(name, "Redefinition of global variable \"%s\"", name.string.str);
+	}
+
+	const Token& next = tokens[start + offset++];
+
+	if (next.type == TokenType::SemiColon) {
+		if (isConst) {
+			Log::CompilerError(name, "Constant \"%s\" must be initialized", name.string.str);
+		}
+
+		Symbol* var = CreateGlobalVariable(type, VariableScope::Private, name.string);
+
+		if (relaxed) {
+			var->variable.isRelaxed = true;
+			annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
+		}
+	} else if (next.type == TokenType::OperatorAssign) {
+		if (!isConst) {
+			Log::CompilerError(next, "Only constant global variables can be initialized");
+		}
+
+		uint64 end = tokens.Find<TokenType>(TokenType::SemiColon, CmpFunc, start + offset);
+
+		if (end == ~0) {
+			Log::CompilerError(name, "Expression is missing \";\"");
+			return;
+		}
+
+		ID* id = ParseConstantInitializer(tokens, start + offset, end - 1, type);
+
+		if (specId != ~0) {
+			id = CreateSpecConstant(type, id, specId, name);
+		}
+
+		CreateGlobalConstant(type, id, name.string);
+
+		offset = tokens.Find<TokenType>(TokenType::SemiColon, CmpFunc, start + offset) - start + 1;
+	} else {
+		Log::CompilerError(next, "Unexpected symbol \"%s\" expected \";\" or \"=\"", next.string.str);
+	}
+
+	tokens.Remove(start, start + offset - 1);
+}
+
+ID* Compiler::ParseConstantInitializer(List<Token>& tokens, uint64 start, uint64 end, TypePrimitive* type) {
+	const Token first = tokens[start];
+
+	uint64 offset = instructions.GetCount();
+
+	VariableStack localVariables(this, List<Symbol*>());
+
+	ParseInfo info;
+	info.start = start;
+	info.end = end;
+	info.len = 0;
+
+	Symbol* res = ParseExpression(tokens, &info, &localVariables);
+
+	if (res->symbolType == SymbolType::Variable || res->symbolType == SymbolType::Parameter) {
+		Log::CompilerError(first, "Initializer of a global constant must be a constant expression");
+		return res->id;
+	}
+
+	ID* id = res->id;
+
+	if (*res->type != type) {
+		id = ImplicitCastId(type, res->type, id, &first);
+	}
+
+	//Operations on plain constants are folded while parsing, anything left uses a specialization constant and becomes one itself
+	for (uint64 i = offset; i < instructions.GetCount(); i++) {
+		InstBase* inst = instructions[i];
+
+		if (inst->opCode == THC_SPIRV_OPCODE_OpCompositeConstruct) {
+			InstCompositeConstruct* construct = (InstCompositeConstruct*)inst;
+			InstSpecConstantComposite* composite = NewInst<InstSpecConstantComposite>(construct->resultTypeId, construct->constituentCount, construct->constituentId);
+
+			composite->id = construct->id;
+
+			typeInstructions.Add(composite);
+		} else if (IsSpecConstantOperation(inst->opCode)) {
+			typeInstructions.Add(NewInst<InstSpecConstantOp>(inst));
+		} else if (inst->opCode == THC_SPIRV_OPCODE_OpLoad) {
+			Log::CompilerError(first, "Initializer of a global constant can't use variables");
+		} else {
+			Log::CompilerError(first, "%s isn't allowed in the initializer of a global constant", inst->GetName());
+		}
+	}
+
+	if (instructions.GetCount() > offset) {
+		instructions.Remove(offset, instructions.GetCount() - 1);
+	}
+
+	return id;
+}
+
+ID* Compiler::CreateSpecConstant(const TypePrimitive* type, ID* value, uint32 specId, const Token& token) {
+	List<uint32> values;
+
+	if (!Utils::CompareEnums(type->type, CompareOperation::Or, Type::Bool, Type::Int, Type::Float, Type::Vector)) {
+		Log::CompilerError(token, "Specialization constant \"%s\" must be a scalar or a vector", token.string.str);
+		return value;
+	} else if (!GetConstantValues(value->id, values) || values.GetCount() != (type->type == Type::Vector ? type->rows : 1)) {
+		Log::CompilerError(token, "Default value of specialization constant \"%s\" must be a constant of 32 bits or less", token.string.str);
+		return value;
+	}
+
+	TypePrimitive* componentType = (TypePrimitive*)type;
+
+	if (type->type == Type::Vector) {
+		componentType = type->componentType == Type::Bool ? CreateTypeBool() : CreateTypePrimitiveScalar(type->componentType, type->bits, type->sign);
+	}
+
+	List<ID*> ids;
+
+	//Vectors can't be specialized as a whole, each component is a specialization constant of its own
+	for (uint64 i = 0; i < values.GetCount(); i++) {
+		uint32 id = specId + (uint32)i;
+
+		InstBase* constant = nullptr;
+
+		if (componentType->type == Type::Bool) {
+			if (values[i]) {
+				constant = NewInst<InstSpecConstantTrue>(componentType->typeId);
+			} else {
+				constant = NewInst<InstSpecConstantFalse>(componentType->typeId);
+			}
+		} else {
+			constant = NewInst<InstSpecConstant>(componentType->typeId, 1, &values[i]);
+		}
+
+		if (specIds.Find(id) != ~0) {
+			Log::CompilerWarning(token, "\"layout (constant_id = %u)\" already used", id);
+		} else {
+			specIds.Add(id);
+		}
+
+		annotationIstructions.Add(NewInst<InstDecorate>(constant->id, THC_SPIRV_DECORATION_SPEC_ID, &id, 1));
+		typeInstructions.Add(constant);
+
+		ids.Add(constant->id);
+	}
+
+	if (ids.GetCount() == 1) return ids[0];
+
+	InstSpecConstantComposite* composite = NewInst<InstSpecConstantComposite>(type->typeId, (uint32)ids.GetCount(), ids.GetData());
+
+	typeInstructions.Add(composite);
+
+	return composite->id;
+}
+
+Compiler::Symbol* Compiler::CreateGlobalConstant(const TypeBase* const type, ID* id, const String& name) {
+	bool constant = constantDefinitions.Get(id->id) != nullptr;
+
+	Symbol* var = new Symbol(constant ? SymbolType::Constant : SymbolType::Result, const_cast<TypeBase*>(type), id);
+	var->variable.scope = VariableScope::None;
+	var->variable.name = name;
+	var->variable.isConst = true;
+	var->variable.loadId = nullptr;
+
+	//Plain constants are shared by every use of the value
+	if (!constant) debugInstructions.Add(NewInst<InstName>(id, name.str));
+
+	if (CheckGlobalName(name)) globalVariableNames.Set(name, var);
+
+	return var;
+}
+
+}
+}
+}
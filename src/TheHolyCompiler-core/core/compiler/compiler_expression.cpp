@@ -41,6 +41,7 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 	List<Expression> expressions;
 	List<Symbol*> tmpVariables;
 	List<InstBase*> postIncrements;
+	List<Symbol*> postIncrementVariables;
 
 
 	for (uint64 i = info->start; i <= info->end; i++) {
@@ -67,7 +68,11 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 				}
 			}
 			
-			if (next.type == TokenType::OperatorSelector || next.type == TokenType::BracketOpen && c != ~0) { //Member selection in a struct and/or array subscripting
+			//Global constants aren't variables, a swizzle on them is handled like on any other result
+			Symbol* global = c != ~0 ? GetVariable(t.string, localVariables) : nullptr;
+			bool globalConstant = global && (global->symbolType == SymbolType::Constant || global->symbolType == SymbolType::Result);
+
+			if (!globalConstant && (next.type == TokenType::OperatorSelector || next.type == TokenType::BracketOpen && c != ~0)) { //Member selection in a struct and/or array subscripting
 				ParseInfo inf;
 				inf.start = i;
 
@@ -102,13 +107,15 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 					info->end -= inf.len;
 					info->len += inf.len;
 					i = inf.end-1;
-				} else { //Variable
+				} else { //Variable or global constant
 					e.type = ExpressionType::Variable;
 					e.symbol = GetVariable(t.string, localVariables);
 					e.parent = t;
 
 					if (e.symbol == nullptr) {
 						Log::CompilerError(t, "Unexpected symbol \"%s\" expected a variable or constant", t.string.str);
+					} else if (e.symbol->symbolType == SymbolType::Constant || e.symbol->symbolType == SymbolType::Result) {
+						e.type = e.symbol->symbolType == SymbolType::Constant ? ExpressionType::Constant : ExpressionType::Result;
 					}
 				}
 			}
@@ -204,27 +211,29 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 
 				Symbol* var = left.symbol;
 
-				InstLoad* load = new InstLoad(var->type->typeId, var->id, 0);
+				InstLoad* load = NewInst<InstLoad>(var->type->typeId, var->id, 0);
 				InstBase* operation = nullptr;
 
 				switch (var->type->type) {
 					case Type::Int:
-						operation = new InstIAdd(var->type->typeId, load->id, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1U : ~0U));
+						operation = NewInst<InstIAdd>(var->type->typeId, load->id, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1U : ~0U));
 						break;
 					case Type::Float:
-						operation = new InstFAdd(var->type->typeId, load->id, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1.0f : -1.0f));
+						operation = NewInst<InstFAdd>(var->type->typeId, load->id, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1.0f : -1.0f));
 						break;
 				}
 
-				InstStore* store = new InstStore(var->id, operation->id, 0);
+				InstStore* store = NewInst<InstStore>(var->id, operation->id, 0);
 
 				instructions.Add(load);
 				instructions.Add(operation);
 
 				postIncrements.Add(store);
+				postIncrementVariables.Add(var);
 
+				//The expression uses the value from before the increment
 				left.type = ExpressionType::Result;
-				left.symbol = new Symbol(SymbolType::Result, var->type, operation->id);
+				left.symbol = new Symbol(SymbolType::Result, var->type, load->id);
 
 				expressions.RemoveAt(i--);
 			} else if (!rightVar) {
@@ -323,16 +332,16 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 
 				switch (var->type->type) {
 					case Type::Int:
-						operation = new InstIAdd(var->type->typeId, load, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1U : ~0U));
+						operation = NewInst<InstIAdd>(var->type->typeId, load, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1U : ~0U));
 						break;
 					case Type::Float:
-						operation = new InstFAdd(var->type->typeId, load, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1.0f : -1.0f));
+						operation = NewInst<InstFAdd>(var->type->typeId, load, CreateConstant(var->type, e.operatorType == TokenType::OperatorIncrement ? 1.0f : -1.0f));
 						break;
 				}
 
 				instructions.Add(operation);
 
-				StoreVariable(var, operation->id, true);
+				StoreVariable(var, operation->id);
 
 				//right.type = ExpressionType::Result;
 				//right.symbol = new Symbol(SymbolType::Result, var->type, operation->id);
@@ -375,9 +384,9 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 					}
 				}
 
-				operation = new InstSNegate(type->typeId, operandId);
+				operation = NewInst<InstSNegate>(type->typeId, operandId);
 			} else if (type->componentType == Type::Float) {
-				operation = new InstFNegate(type->typeId, operandId);
+				operation = NewInst<InstFNegate>(type->typeId, operandId);
 			} else {
 				Log::CompilerError(e.parent, "Right hand operand must be a scalar or vector of type integer or float");
 			}
@@ -421,13 +430,13 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 
 			switch (rType->type) {
 				case Type::Bool:
-					operation = new InstLogicalNot(retTypeId, operandId);
+					operation = NewInst<InstLogicalNot>(retTypeId, operandId);
 					break;
 				case Type::Int:
-					operation = new InstINotEqual(retTypeId, operandId, constantId);
+					operation = NewInst<InstINotEqual>(retTypeId, operandId, constantId);
 					break;
 				case Type::Float:
-					operation = new InstFOrdNotEqual(retTypeId, operandId, constantId);
+					operation = NewInst<InstFOrdNotEqual>(retTypeId, operandId, constantId);
 					break;
 			}
 
@@ -456,7 +465,7 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 				Log::CompilerError(e.parent, "Right hand operand must be a scalar or vector of type integer");
 			}
 
-			InstNot* operation = new InstNot(type->typeId, operandId);
+			InstNot* operation = NewInst<InstNot>(type->typeId, operandId);
 			instructions.Add(operation);
 
 			right.type = ExpressionType::Result;
@@ -580,9 +589,9 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 			}
 
 			if (e.operatorType == TokenType::OperatorRightShift) {
-				instruction = new InstShiftRightLogical(lType->typeId, lOperandId, rId);
+				instruction = NewInst<InstShiftRightLogical>(lType->typeId, lOperandId, rId);
 			} else {
-				instruction = new InstShiftLeftLogical(lType->typeId, lOperandId, rId);
+				instruction = NewInst<InstShiftLeftLogical>(lType->typeId, lOperandId, rId);
 			}
 
 			instructions.Add(instruction);
@@ -652,11 +661,11 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 					TypePrimitive* tmp = nullptr;
 
 					if (lType->bits > rType->bits) {
-						convInst = rType->sign ? new InstSConvert((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 1))->typeId, rOperandId) : (InstBase*)new InstUConvert((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 0))->typeId, rOperandId);
+						convInst = rType->sign ? NewInst<InstSConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 1))->typeId, rOperandId) : (InstBase*)NewInst<InstUConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 0))->typeId, rOperandId);
 						rId = convInst->id;
 						Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", rType->typeString.str, tmp->typeString.str);
 					} else if (lType->bits < rType->bits) {
-						convInst = lType->sign ? new InstSConvert((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 1))->typeId, lOperandId) : (InstBase*)new InstUConvert((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 0))->typeId, lOperandId);
+						convInst = lType->sign ? NewInst<InstSConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 1))->typeId, lOperandId) : (InstBase*)NewInst<InstUConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 0))->typeId, lOperandId);
 						lId = convInst->id;
 						Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", lType->typeString.str, tmp->typeString.str);
 					}
@@ -673,31 +682,31 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 			if (floatCmp) {
 				switch (e.operatorType) {
 					case TokenType::OperatorLess:
-						instruction = new InstFOrdLessThan(retTypeId, lId, rId);
+						instruction = NewInst<InstFOrdLessThan>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorLessEqual:
-						instruction = new InstFOrdLessThanEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstFOrdLessThanEqual>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorGreater:
-						instruction = new InstFOrdGreaterThan(retTypeId, lId, rId);
+						instruction = NewInst<InstFOrdGreaterThan>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorGreaterEqual:
-						instruction = new InstFOrdGreaterThanEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstFOrdGreaterThanEqual>(retTypeId, lId, rId);
 						break;
 				}
 			} else {
 				switch (e.operatorType) {
 					case TokenType::OperatorLess:
-						instruction = lType->sign ? new InstSLessThan(retTypeId, lId, rId) : (InstBase*)new InstULessThan(retTypeId, lId, rId);
+						instruction = lType->sign ? NewInst<InstSLessThan>(retTypeId, lId, rId) : (InstBase*)NewInst<InstULessThan>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorLessEqual:
-						instruction = lType->sign ? new InstSLessThanEqual(retTypeId, lId, rId) : (InstBase*)new InstULessThanEqual(retTypeId, lId, rId);
+						instruction = lType->sign ? NewInst<InstSLessThanEqual>(retTypeId, lId, rId) : (InstBase*)NewInst<InstULessThanEqual>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorGreater:
-						instruction = lType->sign ? new InstSGreaterThan(retTypeId, lId, rId) : (InstBase*)new InstUGreaterThan(retTypeId, lId, rId);
+						instruction = lType->sign ? NewInst<InstSGreaterThan>(retTypeId, lId, rId) : (InstBase*)NewInst<InstUGreaterThan>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorGreaterEqual:
-						instruction = lType->sign ? new InstSGreaterThanEqual(retTypeId, lId, rId) : (InstBase*)new InstUGreaterThanEqual(retTypeId, lId, rId);
+						instruction = lType->sign ? NewInst<InstSGreaterThanEqual>(retTypeId, lId, rId) : (InstBase*)NewInst<InstUGreaterThanEqual>(retTypeId, lId, rId);
 						break;
 				}
 			}
@@ -769,11 +778,11 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 					TypePrimitive* tmp = nullptr;
 
 					if (lType->bits > rType->bits) {
-						convInst = rType->sign ? new InstSConvert((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 1))->typeId, rOperandId) : (InstBase*)new InstUConvert((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 0))->typeId, rOperandId);
+						convInst = rType->sign ? NewInst<InstSConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 1))->typeId, rOperandId) : (InstBase*)NewInst<InstUConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, lType->bits, 0))->typeId, rOperandId);
 						rId = convInst->id;
 						Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", rType->typeString.str, tmp->typeString.str);
 					} else if (lType->bits < rType->bits) {
-						convInst = lType->sign ? new InstSConvert((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 1))->typeId, lOperandId) : (InstBase*)new InstUConvert((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 0))->typeId, lOperandId);
+						convInst = lType->sign ? NewInst<InstSConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 1))->typeId, lOperandId) : (InstBase*)NewInst<InstUConvert>((tmp = CreateTypePrimitiveScalar(Type::Int, rType->bits, 0))->typeId, lOperandId);
 						lId = convInst->id;
 						Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", lType->typeString.str, tmp->typeString.str);
 					}
@@ -798,28 +807,28 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 			if (cmpType == 1) {
 				switch (e.operatorType) {
 					case TokenType::OperatorEqual:
-						instruction = new InstFOrdEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstFOrdEqual>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorNotEqual:
-						instruction = new InstFOrdNotEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstFOrdNotEqual>(retTypeId, lId, rId);
 						break;
 				}
 			} else if (cmpType == 0) {
 				switch (e.operatorType) {
 					case TokenType::OperatorEqual:
-						instruction = new InstIEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstIEqual>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorNotEqual:
-						instruction = new InstINotEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstINotEqual>(retTypeId, lId, rId);
 						break;
 				}
 			} else {
 				switch (e.operatorType) {
 					case TokenType::OperatorEqual:
-						instruction = new InstLogicalEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstLogicalEqual>(retTypeId, lId, rId);
 						break;
 					case TokenType::OperatorNotEqual:
-						instruction = new InstLogicalNotEqual(retTypeId, lId, rId);
+						instruction = NewInst<InstLogicalNotEqual>(retTypeId, lId, rId);
 						break;
 				}
 			}
@@ -868,12 +877,12 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 			InstBase* conv = nullptr;
 
 			if (lType->bits != rType->bits) {
-				conv = rType->sign ? new InstSConvert(lType->typeId, rOperandId) : (InstBase*)new InstUConvert(lType->typeId, rOperandId);
+				conv = rType->sign ? NewInst<InstSConvert>(lType->typeId, rOperandId) : (InstBase*)NewInst<InstUConvert>(lType->typeId, rOperandId);
 				rId = conv->id;
 				Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", rType->typeString.str, lType->typeString.str);
 			}
 
-			InstBase* inst = new InstBitwiseAnd(lType->typeId, lOperandId, rId);
+			InstBase* inst = NewInst<InstBitwiseAnd>(lType->typeId, lOperandId, rId);
 
 			if (conv) instructions.Add(conv);
 			instructions.Add(inst);
@@ -919,12 +928,12 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 			InstBase* conv = nullptr;
 
 			if (lType->bits != rType->bits) {
-				conv = rType->sign ? new InstSConvert(lType->typeId, rOperandId) : (InstBase*)new InstUConvert(lType->typeId, rOperandId);
+				conv = rType->sign ? NewInst<InstSConvert>(lType->typeId, rOperandId) : (InstBase*)NewInst<InstUConvert>(lType->typeId, rOperandId);
 				rId = conv->id;
 				Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", rType->typeString.str, lType->typeString.str);
 			}
 
-			InstBase* inst = new InstBitwiseXor(lType->typeId, lOperandId, rId);
+			InstBase* inst = NewInst<InstBitwiseXor>(lType->typeId, lOperandId, rId);
 
 			if (conv) instructions.Add(conv);
 			instructions.Add(inst);
@@ -970,12 +979,12 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 			InstBase* conv = nullptr;
 
 			if (lType->bits != rType->bits) {
-				conv = rType->sign ? new InstSConvert(lType->typeId, rOperandId) : (InstBase*)new InstUConvert(lType->typeId, rOperandId);
+				conv = rType->sign ? NewInst<InstSConvert>(lType->typeId, rOperandId) : (InstBase*)NewInst<InstUConvert>(lType->typeId, rOperandId);
 				rId = conv->id;
 				Log::CompilerWarning(right.parent, "Implicit conversion from %s to %s", rType->typeString.str, lType->typeString.str);
 			}
 
-			InstBase* inst = new InstBitwiseOr(lType->typeId, lOperandId, rId);
+			InstBase* inst = NewInst<InstBitwiseOr>(lType->typeId, lOperandId, rId);
 
 			if (conv) instructions.Add(conv);
 			instructions.Add(inst);
@@ -1033,7 +1042,7 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 				delete r;
 			}
 
-			InstBase* instruction = new InstLogicalAnd(retType->typeId, lId, rId);
+			InstBase* instruction = NewInst<InstLogicalAnd>(retType->typeId, lId, rId);
 
 			instructions.Add(instruction);
 
@@ -1090,7 +1099,7 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 				delete r;
 			}
 
-			InstBase* instruction = new InstLogicalOr(retType->typeId, lId, rId);
+			InstBase* instruction = NewInst<InstLogicalOr>(retType->typeId, lId, rId);
 
 			instructions.Add(instruction);
 
@@ -1233,7 +1242,7 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 						tmp->id = GetSwizzledVector(&rType, rOperandId, right.symbol->swizzleIndices);
 					}
 
-					inst = new InstCompositeInsert(lBaseType->typeId, tmp->id, lBaseId, 1, lIndices.GetData());
+					inst = NewInst<InstCompositeInsert>(lBaseType->typeId, tmp->id, lBaseId, 1, lIndices.GetData());
 				} else {
 					for (uint64 i = 0; i < rows; i++) {
 						uint64 lIndex = lIndices.Find((uint32)i);
@@ -1246,7 +1255,7 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 						}
 					}
 
-					inst = new InstVectorShuffle(lBaseType->typeId, lBaseId, tmp->id, (uint32)rows, indices.GetData());
+					inst = NewInst<InstVectorShuffle>(lBaseType->typeId, lBaseId, tmp->id, (uint32)rows, indices.GetData());
 				} 
 
 				instructions.Add(inst);
@@ -1266,6 +1275,10 @@ Compiler::Symbol* Compiler::ParseExpression(List<Token>& tokens, ParseInfo* info
 
 	instructions.Add(postIncrements);
 
+	for (uint64 i = 0; i < postIncrementVariables.GetCount(); i++) {
+		postIncrementVariables[i]->variable.loadId = nullptr;
+	}
+
 	if (expressions.GetCount() > 1) {
 		const Expression& e = expressions[1];
 		Log::CompilerError(e.parent, "Unexpected symbol \"%s\"", e.parent.string.str);
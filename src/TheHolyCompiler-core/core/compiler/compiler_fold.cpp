@@ -0,0 +1,306 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "compiler.h"
+#include <util/log.h>
+#include <util/utils.h>
+
+namespace thc {
+namespace core {
+namespace compiler {
+
+using namespace utils;
+using namespace instruction;
+using namespace type;
+
+#define AS_FLOAT(value) (*(float32*)&(value))
+#define AS_INT(value) (*(int32*)&(value))
+
+//Folds one 32 bit component, returns false if the result isn't well defined
+static bool FoldComponent(uint32 opCode, Type componentType, uint32 a, uint32 b, uint32* result) {
+	float32 f = 0.0F;
+	int32 i = 0;
+
+	switch (opCode) {
+		case THC_SPIRV_OPCODE_OpIAdd:
+			*result = a + b;
+			return true;
+		case THC_SPIRV_OPCODE_OpISub:
+			*result = a - b;
+			return true;
+		case THC_SPIRV_OPCODE_OpIMul:
+			*result = a * b;
+			return true;
+		case THC_SPIRV_OPCODE_OpUDiv:
+			if (b == 0) return false;
+
+			*result = a / b;
+			return true;
+		case THC_SPIRV_OPCODE_OpSDiv:
+			if (b == 0 || (AS_INT(a) == INT32_MIN && AS_INT(b) == -1)) return false;
+
+			i = AS_INT(a) / AS_INT(b);
+			*result = *(uint32*)&i;
+			return true;
+		case THC_SPIRV_OPCODE_OpFAdd:
+			f = AS_FLOAT(a) + AS_FLOAT(b);
+			break;
+		case THC_SPIRV_OPCODE_OpFSub:
+			f = AS_FLOAT(a) - AS_FLOAT(b);
+			break;
+		case THC_SPIRV_OPCODE_OpFMul:
+			f = AS_FLOAT(a) * AS_FLOAT(b);
+			break;
+		case THC_SPIRV_OPCODE_OpFDiv:
+			if (AS_FLOAT(b) == 0.0F) return false;
+
+			f = AS_FLOAT(a) / AS_FLOAT(b);
+			break;
+		case THC_SPIRV_OPCODE_OpVectorTimesScalar:
+			f = AS_FLOAT(a) * AS_FLOAT(b);
+			break;
+		case THC_SPIRV_OPCODE_OpConvertFToS:
+			f = AS_FLOAT(a);
+
+			if (!(f >= -2147483648.0F && f < 2147483648.0F)) return false;
+
+			i = (int32)f;
+			*result = *(uint32*)&i;
+			return true;
+		case THC_SPIRV_OPCODE_OpConvertFToU:
+			f = AS_FLOAT(a);
+
+			if (!(f >= 0.0F && f < 4294967296.0F)) return false;
+
+			*result = (uint32)f;
+			return true;
+		case THC_SPIRV_OPCODE_OpConvertSToF:
+			f = (float32)AS_INT(a);
+			break;
+		case THC_SPIRV_OPCODE_OpConvertUToF:
+			f = (float32)a;
+			break;
+		case THC_SPIRV_OPCODE_OpSConvert:
+		case THC_SPIRV_OPCODE_OpUConvert:
+		case THC_SPIRV_OPCODE_OpFConvert:
+			*result = a;
+			return true;
+		case THC_SPIRV_OPCODE_OpINotEqual:
+			*result = a != b;
+			return true;
+		case THC_SPIRV_OPCODE_OpFOrdNotEqual:
+			*result = AS_FLOAT(a) == AS_FLOAT(a) && AS_FLOAT(b) == AS_FLOAT(b) && AS_FLOAT(a) != AS_FLOAT(b);
+			return true;
+		default:
+			return false;
+	}
+
+	*result = *(uint32*)&f;
+
+	return true;
+}
+
+bool Compiler::GetConstantValues(uint32 id, List<uint32>& values) const {
+	InstBase* const* definition = constantDefinitions.Get(id);
+
+	if (definition == nullptr) return false;
+
+	const InstBase* inst = *definition;
+
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpConstantTrue:
+			values.Add(1);
+			return true;
+		case THC_SPIRV_OPCODE_OpConstantFalse:
+			values.Add(0);
+			return true;
+		case THC_SPIRV_OPCODE_OpConstant:
+		{
+			const InstConstant* constant = (const InstConstant*)inst;
+
+			if (constant->valueCount != 1) return false;
+
+			values.Add(constant->values[0]);
+			return true;
+		}
+		case THC_SPIRV_OPCODE_OpConstantComposite:
+		{
+			const InstConstantComposite* composite = (const InstConstantComposite*)inst;
+
+			for (uint32 i = 0; i < composite->constituentCount; i++) {
+				if (!GetConstantValues(composite->constituentId[i]->id, values)) return false;
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+ID* Compiler::CreateConstantFromValues(const TypePrimitive* type, const List<uint32>& values) {
+	if (type->componentType == Type::Bool) {
+		if (type->type == Type::Bool) return CreateConstantBool(values[0] != 0);
+
+		List<ID*> ids;
+
+		for (uint64 i = 0; i < values.GetCount(); i++) {
+			ids.Add(CreateConstantBool(values[i] != 0));
+		}
+
+		return CreateConstantComposite(type, ids);
+	}
+
+	if (IsTypeComposite(type)) return CreateConstantComposite(type, values);
+
+	return CreateConstant(type, values[0]);
+}
+
+ID* Compiler::FoldConstant(const InstBase* instruction, const TypePrimitive* type, const TypePrimitive* operandType) {
+	if (instruction == nullptr || instruction->wordCount < 4 || instruction->wordCount > 5) return nullptr;
+
+	//Wider constants take more than one word
+	if ((type->componentType != Type::Bool && type->bits != 32) || (operandType->componentType != Type::Bool && operandType->bits != 32)) return nullptr;
+
+	uint32 words[5];
+
+	instruction->GetInstWords(words);
+
+	uint32 operandCount = instruction->wordCount - 3;
+
+	List<uint32> a(16);
+	List<uint32> b(16);
+
+	if (!GetConstantValues(words[3], a)) return nullptr;
+	if (operandCount > 1 && !GetConstantValues(words[4], b)) return nullptr;
+
+	uint64 expected = type->type == Type::Matrix ? type->rows * type->columns : type->type == Type::Vector ? type->rows : 1;
+
+	List<uint32> result(expected);
+
+	switch (instruction->opCode) {
+		case THC_SPIRV_OPCODE_OpMatrixTimesVector:
+		{
+			if (type->componentType != Type::Float || b.GetCount() == 0 || a.GetCount() % b.GetCount() != 0) return nullptr;
+
+			uint64 rows = a.GetCount() / b.GetCount();
+
+			for (uint64 r = 0; r < rows; r++) {
+				float32 sum = 0.0F;
+
+				for (uint64 c = 0; c < b.GetCount(); c++) {
+					sum += AS_FLOAT(a[c * rows + r]) * AS_FLOAT(b[c]);
+				}
+
+				result.Add(*(uint32*)&sum);
+			}
+
+			break;
+		}
+		case THC_SPIRV_OPCODE_OpVectorTimesMatrix:
+		{
+			if (type->componentType != Type::Float || a.GetCount() == 0 || b.GetCount() % a.GetCount() != 0) return nullptr;
+
+			uint64 rows = a.GetCount();
+
+			for (uint64 c = 0; c < b.GetCount() / rows; c++) {
+				float32 sum = 0.0F;
+
+				for (uint64 r = 0; r < rows; r++) {
+					sum += AS_FLOAT(a[r]) * AS_FLOAT(b[c * rows + r]);
+				}
+
+				result.Add(*(uint32*)&sum);
+			}
+
+			break;
+		}
+		case THC_SPIRV_OPCODE_OpMatrixTimesMatrix:
+		{
+			if (type->componentType != Type::Float || type->type != Type::Matrix) return nullptr;
+
+			uint64 rows = type->rows;
+			uint64 inner = a.GetCount() / rows;
+
+			if (inner * rows != a.GetCount() || b.GetCount() != inner * type->columns) return nullptr;
+
+			for (uint64 c = 0; c < type->columns; c++) {
+				for (uint64 r = 0; r < rows; r++) {
+					float32 sum = 0.0F;
+
+					for (uint64 k = 0; k < inner; k++) {
+						sum += AS_FLOAT(a[k * rows + r]) * AS_FLOAT(b[c * inner + k]);
+					}
+
+					result.Add(*(uint32*)&sum);
+				}
+			}
+
+			break;
+		}
+		default:
+		{
+			uint64 count = a.GetCount();
+
+			if (operandCount > 1) {
+				if (b.GetCount() > count) count = b.GetCount();
+
+				if ((a.GetCount() != count && a.GetCount() != 1) || (b.GetCount() != count && b.GetCount() != 1)) return nullptr;
+			}
+
+			for (uint64 i = 0; i < count; i++) {
+				uint32 x = a[a.GetCount() == 1 ? 0 : i];
+				uint32 y = operandCount > 1 ? b[b.GetCount() == 1 ? 0 : i] : 0;
+				uint32 r = 0;
+
+				if (!FoldComponent(instruction->opCode, type->componentType, x, y, &r)) return nullptr;
+
+				result.Add(r);
+			}
+		}
+	}
+
+	if (result.GetCount() != expected) return nullptr;
+
+	return CreateConstantFromValues(type, result);
+}
+
+Compiler::Symbol* Compiler::CreateOperationResult(TypeBase* type, InstBase* instruction, const TypePrimitive* operandType) {
+	ID* constant = FoldConstant(instruction, (TypePrimitive*)type, operandType ? operandType : (TypePrimitive*)type);
+
+	if (constant) {
+		delete instruction;
+
+		return new Symbol(SymbolType::Result, type, constant);
+	}
+
+	instructions.Add(instruction);
+
+	return new Symbol(SymbolType::Result, type, instruction->id);
+}
+
+}
+}
+}
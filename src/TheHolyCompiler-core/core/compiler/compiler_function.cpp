@@ -40,6 +40,48 @@ auto  CmpFunc = [](const Token& curr, const TokenType& c) -> bool {
 	return curr.type == c;
 };
 
+//Returns true if the body starting at start assigns, increments or decrements name or one of its members
+static bool IsWritten(const List<Token>& tokens, uint64 start, const String& name) {
+	uint64 depth = 0;
+
+	for (uint64 i = start; i < tokens.GetCount(); i++) {
+		const Token& t = tokens[i];
+
+		if (t.type == TokenType::CurlyBracketOpen) {
+			depth++;
+		} else if (t.type == TokenType::CurlyBracketClose) {
+			if (depth-- == 0) break;
+		} else if (t.type == TokenType::Name && t.string == name) {
+			if (i > start && Utils::CompareEnums(tokens[i - 1].type, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement)) return true;
+
+			uint64 next = i + 1;
+			uint64 brackets = 0;
+
+			//Skip member selection and subscripts
+			for (; next < tokens.GetCount(); next++) {
+				TokenType type = tokens[next].type;
+
+				if (type == TokenType::BracketOpen) {
+					brackets++;
+				} else if (type == TokenType::BracketClose && brackets > 0) {
+					brackets--;
+				} else if (brackets == 0 && type != TokenType::OperatorSelector && !(type == TokenType::Name && tokens[next - 1].type == TokenType::OperatorSelector)) {
+					break;
+				}
+			}
+
+			if (next >= tokens.GetCount()) break;
+
+			TokenType type = tokens[next].type;
+
+			if (type >= TokenType::OperatorAssign && type <= TokenType::OperatorCompoundDiv) return true;
+			if (Utils::CompareEnums(type, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement)) return true;
+		}
+	}
+
+	return false;
+}
+
 void Compiler::ParseFunction(List<Token>& tokens, uint64 start) {
 	uint64 offset = 0;
 
@@ -88,6 +130,8 @@ void Compiler::ParseFunction(List<Token>& tokens, uint64 start) {
 			offset--;
 		}
 
+		param->parameter.isRelaxed = ParsePrecision(tokens, start + offset);
+
 		TypeBase* type = CreateType(tokens, start + offset, nullptr);
 
 		if (type == nullptr) {
@@ -169,6 +213,12 @@ naughtyLabel:
 					Log::CompilerError(name, "Parameter %u needs a name!", i);
 				}
 			}
+
+			for (uint64 i = 0; i < old->parameters.GetCount(); i++) {
+				delete old->parameters[i];
+			}
+
+			delete old;
 		}
 
 		instructions.Add(decl->declInstructions);
@@ -177,25 +227,92 @@ naughtyLabel:
 			Log::CompilerError(tokens[start], "Redefinition");
 		}
 
+		uint64 first = instructions.GetCount() - decl->declInstructions.GetCount();
+		uint64 firstDebug = debugInstructions.GetCount();
+		uint64 firstAnnotation = annotationIstructions.GetCount();
+
+		debugInstructions.Add(decl->nameInstructions);
+
 		VariableStack localVariables(this, decl->parameters);
 
-		instructions.Add(new InstLabel);
+		instructions.Add(NewInst<InstLabel>());
 
 		uint64 index = instructions.GetCount();
 
+		//A value parameter is only an id, so if the body writes to it a local copy is used instead. Otherwise the new value wouldn't be visible after an if or in the next iteration of a loop
+		for (uint64 i = 0; i < decl->parameters.GetCount(); i++) {
+			Symbol* param = decl->parameters[i];
+
+			if (param->parameter.isReference || !IsWritten(tokens, start + offset, param->parameter.name)) continue;
+
+			Symbol* copy = CreateLocalVariable(param->type, param->parameter.name, &localVariables);
+
+			if (param->parameter.isRelaxed) {
+				copy->variable.isRelaxed = true;
+				annotationIstructions.Add(NewInst<InstDecorate>(copy->id, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
+			}
+
+			StoreVariable(copy, param->id);
+		}
+
+		calledFunctions.Clear();
+
 		ParseBody(decl, tokens, start + offset, &localVariables);
 
 		instructions.InsertList(index, localVariables.variableInstructions); //Add all OpVariable instructions at the beginning of the first block
 
 		InstBase* last = instructions[instructions.GetCount() - 1];
+		InstBase* prev = instructions[instructions.GetCount() - 2];
 
-		if (last->opCode != THC_SPIRV_OPCODE_OpReturn && last->opCode != THC_SPIRV_OPCODE_OpReturnValue) {
-			instructions.Add(new InstReturn());
+		if (last->opCode == THC_SPIRV_OPCODE_OpLabel && (prev->opCode == THC_SPIRV_OPCODE_OpReturn || prev->opCode == THC_SPIRV_OPCODE_OpReturnValue)) {
+			//Nothing follows the last return, so the block started after it isn't needed
+			delete instructions.RemoveAt(instructions.GetCount() - 1);
+		} else if (decl->returnType->type == Type::Void) {
+			instructions.Add(NewInst<InstReturn>());
+		} else {
+			//Every path already returned, only unreachable blocks can end up here
+			instructions.Add(NewInst<InstUnreachable>());
 		}
 
-		instructions.Add(new InstFunctionEnd);
+		instructions.Add(NewInst<InstFunctionEnd>());
 
 		decl->defined = true;
+
+		if (incremental) {
+			FunctionRecord* record = nullptr;
+
+			for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+				if (functionRecords[i]->name == decl->name) {
+					record = functionRecords[i];
+					break;
+				}
+			}
+
+			THC_ASSERT(record != nullptr);
+
+			if (record->declaration == nullptr) {
+				record->order = 0;
+
+				for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+					if (functionRecords[i]->declaration) record->order++;
+				}
+			}
+
+			record->declaration = decl;
+			record->calls = calledFunctions;
+
+			for (uint64 i = first; i < instructions.GetCount(); i++) {
+				record->instructions.Add(instructions[i]);
+			}
+
+			for (uint64 i = firstDebug; i < debugInstructions.GetCount(); i++) {
+				record->debugInstructions.Add(debugInstructions[i]);
+			}
+
+			for (uint64 i = firstAnnotation; i < annotationIstructions.GetCount(); i++) {
+				record->annotationInstructions.Add(annotationIstructions[i]);
+			}
+		}
 	} else if (bracket.type != TokenType::SemiColon) {
 		Log::CompilerError(bracket, "Unexpected symbol \"%s\" expected \";\" or \"{\"", bracket.string.str);
 	}
@@ -203,36 +320,120 @@ naughtyLabel:
 	tokens.Remove(start, start + offset - 1);
 }
 
+void Compiler::SkipFunction(List<Token>& tokens, uint64 start) {
+	const Token& open = tokens[start + 2];
+
+	uint64 close = FindMatchingToken(tokens, start + 2, TokenType::ParenthesisOpen, TokenType::ParenthesisClose);
+
+	if (close == ~0 || close + 1 >= tokens.GetCount()) {
+		Log::CompilerError(open, "\"(\" needs a closing \")\"");
+	}
+
+	if (tokens[close + 1].type != TokenType::CurlyBracketOpen) {
+		ParseFunction(tokens, start);
+		return;
+	}
+
+	uint64 end = FindMatchingToken(tokens, close + 1, TokenType::CurlyBracketOpen, TokenType::CurlyBracketClose);
+
+	if (end == ~0) {
+		Log::CompilerError(tokens[close + 1], "\"{\" needs a closing \"}\"");
+	}
+
+	List<Token> definition(end - start + 1);
+
+	for (uint64 i = start; i <= end; i++) {
+		definition.Add(tokens[i]);
+	}
+
+	FunctionDeclaration* decl = GetFunctionDeclaration(definition[1].string);
+
+	if (decl == nullptr) {
+		//Only declare it for now, the body is parsed if it's reachable from main
+		tokens.Remove(close + 2, end);
+
+		Token& semiColon = tokens[close + 1];
+
+		semiColon.type = TokenType::SemiColon;
+		semiColon.string = ";";
+
+		ParseFunction(tokens, start);
+
+		decl = GetFunctionDeclaration(definition[1].string);
+	} else {
+		tokens.Remove(start, end);
+	}
+
+	if (decl->defined || decl->definition.GetCount() != 0) {
+		Log::CompilerError(definition[0], "Redefinition");
+	}
+
+	decl->definition = std::move(definition);
+
+	if (decl->reachable) {
+		reachableFunctions.Add(decl);
+	}
+}
+
+void Compiler::MarkReachable(FunctionDeclaration* decl) {
+	if (decl->reachable) return;
+
+	decl->reachable = true;
+
+	reachableFunctions.Add(decl);
+}
+
+void Compiler::ParseReachableFunctions() {
+	FunctionDeclaration* entry = GetFunctionDeclaration("main");
+
+	if (entry) MarkReachable(entry);
+
+	while (reachableFunctions.GetCount() != 0) {
+		FunctionDeclaration* decl = reachableFunctions.RemoveAt(reachableFunctions.GetCount() - 1);
+
+		if (decl->definition.GetCount() == 0) continue;
+
+		List<Token> tokens(std::move(decl->definition));
+
+		ParseFunction(tokens, 0);
+	}
+}
+
 void Compiler::CreateFunctionDeclaration(FunctionDeclaration* decl) {
 	if (decl->declInstructions.GetCount() != 0) {
 		return;
 	}
 
 	decl->defined = false;
+	decl->reachable = false;
 
 	CreateFunctionType(decl);
 
-	InstFunction* func = new InstFunction(decl->returnType->typeId, THC_SPIRV_FUNCTION_CONTROL_NONE, decl->typeId);
+	InstFunction* func = NewInst<InstFunction>(decl->returnType->typeId, THC_SPIRV_FUNCTION_CONTROL_NONE, decl->typeId);
 	decl->declInstructions.Add(func);
 
-	debugInstructions.Add(new InstName(func->id, decl->name.str));
+	decl->nameInstructions.Add(NewInst<InstName>(func->id, decl->name.str));
 
 	decl->id = func->id;
 
 	for (uint64 i = 0; i < decl->parameters.GetCount(); i++) {
 		Symbol* v = decl->parameters[i];
 
-		InstFunctionParameter* pa = new InstFunctionParameter(v->type->typeId);
+		InstFunctionParameter* pa = NewInst<InstFunctionParameter>(v->type->typeId);
 
 		v->id= pa->id;
 
+		if (v->parameter.isRelaxed) {
+			annotationIstructions.Add(NewInst<InstDecorate>(pa->id, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
+		}
+
 		if (v->type->type == Type::Pointer) {
 			v->type = ((TypePointer*)v->type)->baseType;
 		}
 
 		decl->declInstructions.Add(pa);
 
-		debugInstructions.Add(new InstName(pa->id, (decl->name + "_" + v->parameter.name).str));
+		decl->nameInstructions.Add(NewInst<InstName>(pa->id, (decl->name + "_" + v->parameter.name).str));
 	}
 
 	functionDeclarations.Add(decl);
@@ -261,6 +462,10 @@ Compiler::Symbol* Compiler::ParseFunctionCall(List<Token>& tokens, ParseInfo* in
 		Log::CompilerError(functionName, "No function called \"%s\" exists", functionName.string.str);
 	}
 
+	MarkReachable(decl);
+
+	if (incremental) calledFunctions.Add(decl);
+
 	String declSig = GetFunctionSignature(decl);
 
 	if (arguments.GetCount() != decl->parameters.GetCount()) {
@@ -314,7 +519,7 @@ Compiler::Symbol* Compiler::ParseFunctionCall(List<Token>& tokens, ParseInfo* in
 		
 	}
 
-	InstFunctionCall* call = new InstFunctionCall(decl->returnType->typeId, decl->id, (uint32)ids.GetCount(), ids.GetData());
+	InstFunctionCall* call = NewInst<InstFunctionCall>(decl->returnType->typeId, decl->id, (uint32)ids.GetCount(), ids.GetData());
 	instructions.Add(call);
 	
 	return new Symbol(SymbolType::Result, decl->returnType, call->id);
@@ -441,9 +646,9 @@ Compiler::Symbol* Compiler::ParseExtFunctionCall(const Token& functionName, List
 
 	}
 
-	if (extendedInstructionSet == nullptr) extendedInstructionSet = new InstExtInstImport("GLSL.std.450");
+	if (extendedInstructionSet == nullptr) extendedInstructionSet = NewInst<InstExtInstImport>("GLSL.std.450");
 
-	InstBase* call = new InstExtInst(arguments[0]->type->typeId, extendedInstructionSet->id, decl.opCode, decl.params, ids.GetData());
+	InstBase* call = NewInst<InstExtInst>(arguments[0]->type->typeId, extendedInstructionSet->id, decl.opCode, decl.params, ids.GetData());
 	instructions.Add(call);
 
 	return new Symbol(SymbolType::Result, arguments[0]->type, call->id);
@@ -498,10 +703,42 @@ Compiler::Symbol* Compiler::ParseBuiltinFunctionCall(const Token& functionName,
 
 		TypeBase* retType = CreateTypePrimitiveVector(Type::Float, 32, 0, 4);
 
-		InstBase* func = new InstImageSampledImplicitLod(retType->typeId, ids[0], ids[1], 0, 0, nullptr);
+		InstBase* func = NewInst<InstImageSampledImplicitLod>(retType->typeId, ids[0], ids[1], 0, 0, nullptr);
 		instructions.Add(func);
 
 		res = new Symbol(SymbolType::Result, retType, func->id);
+	} else if (functionName.string == "barrier" || functionName.string == "memoryBarrier" || functionName.string == "memoryBarrierShared" || functionName.string == "groupMemoryBarrier") {
+		if (arguments.GetCount() != 0) {
+			Log::CompilerError(functionName, "Function \"%s\" does not take %llu arguments", functionName.string.str, arguments.GetCount());
+		}
+
+		if (!CompilerOptions::ComputeShader() && !(functionName.string == "memoryBarrier")) {
+			Log::CompilerError(functionName, "Function \"%s\" can only be used in a compute shader", functionName.string.str);
+		}
+
+		TypeBase* uintType = CreateTypePrimitiveScalar(Type::Int, 32, 0);
+
+		//Same scopes and semantics as glslang emits for the GLSL functions, the other stages have no workgroup memory for memoryBarrier to order
+		const uint32 workgroupMemory = THC_SPIRV_MEMORY_SEMANTIC_ACQUIRE_RELEASE | THC_SPIRV_MEMORY_SEMANTIC_WORKGROUP_MEMORY;
+		const uint32 allMemory = (CompilerOptions::ComputeShader() ? workgroupMemory : THC_SPIRV_MEMORY_SEMANTIC_ACQUIRE_RELEASE) | THC_SPIRV_MEMORY_SEMANTIC_UNIFORM_MEMORY | THC_SPIRV_MEMORY_SEMANTIC_IMAGE_MEMORY;
+
+		InstBase* barrier = nullptr;
+
+		if (functionName.string == "barrier") {
+			ID* scope = CreateConstant(uintType, (uint32)THC_SPIRV_SCOPE_WORKGROUP);
+
+			barrier = NewInst<InstControlBarrier>(scope, scope, CreateConstant(uintType, workgroupMemory));
+		} else if (functionName.string == "memoryBarrier") {
+			barrier = NewInst<InstMemoryBarrier>(CreateConstant(uintType, (uint32)THC_SPIRV_SCOPE_DEVICE), CreateConstant(uintType, allMemory));
+		} else if (functionName.string == "memoryBarrierShared") {
+			barrier = NewInst<InstMemoryBarrier>(CreateConstant(uintType, (uint32)THC_SPIRV_SCOPE_DEVICE), CreateConstant(uintType, workgroupMemory));
+		} else {
+			barrier = NewInst<InstMemoryBarrier>(CreateConstant(uintType, (uint32)THC_SPIRV_SCOPE_WORKGROUP), CreateConstant(uintType, allMemory));
+		}
+
+		instructions.Add(barrier);
+
+		res = new Symbol(SymbolType::Result, CreateTypeVoid(), nullptr);
 	}
 
 	return res;
@@ -527,7 +764,18 @@ Compiler::Symbol* Compiler::ParseTypeConstructor(List<Token>& tokens, ParseInfo*
 			Symbol* arg = arguments[i];
 			TypePrimitive* t = (TypePrimitive*)arg->type;
 
-			if (arg->swizzleIndices.GetCount() != 0) arg->id = GetSwizzledVector(&t, LoadVariable(arg, true), arg->swizzleIndices);
+			ID* id = arg->id;
+
+			//Constants and results can be swizzled too, only variables need a load
+			if (arg->symbolType == SymbolType::Variable || (arg->symbolType == SymbolType::Parameter && arg->parameter.isReference)) {
+				id = LoadVariable(arg, true);
+			}
+
+			if (arg->swizzleIndices.GetCount() != 0) {
+				id = GetSwizzledVector(&t, id, arg->swizzleIndices);
+			}
+
+			ids.Add(id);
 
 			if (type->componentType != t->componentType || type->bits != t->bits) {
 				Log::CompilerError(tmp, "Argument \"%s\"(%llu) is not compatible with \"%s\"", t->typeString.str, i, type->typeString.str);
@@ -542,8 +790,6 @@ Compiler::Symbol* Compiler::ParseTypeConstructor(List<Token>& tokens, ParseInfo*
 		if (numComponents != type->rows) {
 			Log::CompilerError(tmp, "Total component count must be %llu is %u", type->rows, numComponents);
 		}
-
-		ids = Compiler::GetIDs(arguments);
 	} else if (type->type == Type::Matrix) {
 		if (arguments.GetCount() != type->columns) {
 			Log::CompilerError(tmp, "Argument count must be %llu is %u", arguments.GetCount(), type->columns);
@@ -557,23 +803,26 @@ Compiler::Symbol* Compiler::ParseTypeConstructor(List<Token>& tokens, ParseInfo*
 			}
 
 			if (arguments[i]->symbolType != SymbolType::Constant) res->symbolType = SymbolType::Result;
-		}
 
-		ids = Compiler::GetIDs(arguments);
+			if (arguments[i]->symbolType == SymbolType::Variable || (arguments[i]->symbolType == SymbolType::Parameter && arguments[i]->parameter.isReference)) {
+				ids.Add(LoadVariable(arguments[i], true));
+			} else {
+				ids.Add(arguments[i]->id);
+			}
+		}
 	} else {
 		Log::CompilerError(tmp, "\"%s\" doesn't have a constructor", type->typeString.str);
 	}
 
 	if (ids.GetCount() > 1) {
 		if (res->symbolType == SymbolType::Constant) {
-			inst = new InstConstantComposite(type->typeId, (uint32)ids.GetCount(), ids.GetData());
-			CheckConstantExist(&inst);
+			res->id = CreateConstantComposite(type, ids);
 		} else {
-			inst = new InstCompositeConstruct(type->typeId, (uint32)ids.GetCount(), ids.GetData());
+			inst = NewInst<InstCompositeConstruct>(type->typeId, (uint32)ids.GetCount(), ids.GetData());
 			instructions.Add(inst);
-		}
 
-		res->id = inst->id;
+			res->id = inst->id;
+		}
 	} else {
 		res->id = ids[0];
 	}
@@ -600,6 +849,12 @@ List<Compiler::Symbol*> Compiler::ParseParameters(List<Token>& tokens, ParseInfo
 
 	List<Symbol*> parameterResults;
 
+	if (parenthesisClose == offset) {
+		info->end = parenthesisClose;
+
+		return std::move(parameterResults);
+	}
+
 	bool moreParams = true;
 
 	do {
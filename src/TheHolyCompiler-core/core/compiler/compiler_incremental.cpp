@@ -0,0 +1,654 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "compiler.h"
+#include <util/utils.h>
+#include <core/preprocessor/preprocessor.h>
+#include <util/log.h>
+#include <core/optimizer/ir.h>
+
+namespace thc {
+namespace core {
+namespace compiler {
+
+using namespace utils;
+using namespace parsing;
+using namespace instruction;
+
+List<Compiler::FunctionRange> Compiler::FindFunctionRanges(const List<Token>& tokens) const {
+	List<FunctionRange> ranges;
+
+	uint64 depth = 0;
+
+	for (uint64 i = 1; i + 1 < tokens.GetCount(); i++) {
+		const Token& token = tokens[i];
+
+		if (token.type == TokenType::CurlyBracketOpen) {
+			depth++;
+		} else if (token.type == TokenType::CurlyBracketClose) {
+			depth--;
+		} else if (depth == 0 && token.type == TokenType::Name && tokens[i + 1].type == TokenType::ParenthesisOpen) {
+			FunctionRange range;
+
+			range.start = i - 1;
+
+			uint64 close = FindMatchingToken(tokens, i + 1, TokenType::ParenthesisOpen, TokenType::ParenthesisClose);
+
+			if (close == ~0 || close + 1 >= tokens.GetCount()) {
+				Log::CompilerError(tokens[i + 1], "\"(\" needs a closing \")\"");
+			}
+
+			if (tokens[close + 1].type == TokenType::CurlyBracketOpen) {
+				range.body = close + 1;
+				range.end = FindMatchingToken(tokens, range.body, TokenType::CurlyBracketOpen, TokenType::CurlyBracketClose);
+
+				if (range.end == ~0) {
+					Log::CompilerError(tokens[range.body], "\"{\" needs a closing \"}\"");
+				}
+			} else {
+				range.body = ~0;
+				range.end = close + 1;
+			}
+
+			ranges.Add(range);
+
+			i = range.end;
+		}
+	}
+
+	return ranges;
+}
+
+uint64 Compiler::HashTokens(const List<Token>& tokens, uint64 start, uint64 end, uint64 hash) {
+	for (uint64 i = start; i < end; i++) {
+		const Token& t = tokens[i];
+
+		hash = (hash ^ (uint64)t.type) * 0x100000001B3;
+
+		for (uint64 j = 0; j < t.string.length; j++) {
+			hash = (hash ^ (uint8)t.string[j]) * 0x100000001B3;
+		}
+	}
+
+	return hash;
+}
+
+uint64 Compiler::HashGlobals(const List<Token>& tokens, const List<FunctionRange>& ranges) {
+	uint64 hash = 0xCBF29CE484222325;
+	uint64 offset = 0;
+
+	for (uint64 i = 0; i < ranges.GetCount(); i++) {
+		const FunctionRange& range = ranges[i];
+
+		if (range.body == ~0) continue;
+
+		hash = HashTokens(tokens, offset, range.body, hash);
+		offset = range.end + 1;
+	}
+
+	return HashTokens(tokens, offset, tokens.GetCount(), hash);
+}
+
+List<Token> Compiler::TokenizeChanged(const List<Line>& newLines) {
+	uint64 oldCount = lines.GetCount();
+	uint64 newCount = newLines.GetCount();
+	uint64 min = oldCount < newCount ? oldCount : newCount;
+
+	auto sameLine = [](const Line& a, const Line& b) -> bool {
+		return a.string == b.string && a.sourceFile == b.sourceFile;
+	};
+
+	uint64 prefix = 0;
+	uint64 suffix = 0;
+
+	while (prefix < min && sameLine(lines[prefix], newLines[prefix])) prefix++;
+	while (suffix < min - prefix && sameLine(lines[oldCount - suffix - 1], newLines[newCount - suffix - 1])) suffix++;
+
+	List<Token> tokens(rawTokens.GetCount() + THC_PREALLOC_COUNT);
+	List<uint64> offsets(newCount + 1);
+
+	auto reuse = [&](uint64 oldLine, uint64 newLine) {
+		offsets.Add(tokens.GetCount());
+
+		for (uint64 i = lineTokenOffsets[oldLine]; i < lineTokenOffsets[oldLine + 1]; i++) {
+			tokens.Add(rawTokens[i]);
+			tokens[tokens.GetCount() - 1].line = newLines[newLine];
+		}
+	};
+
+	for (uint64 i = 0; i < prefix; i++) {
+		reuse(i, i);
+	}
+
+	for (uint64 i = prefix; i < newCount - suffix; i++) {
+		offsets.Add(tokens.GetCount());
+		TokenizeLine(newLines[i], tokens);
+	}
+
+	for (uint64 i = newCount - suffix; i < newCount; i++) {
+		reuse(i + oldCount - newCount, i);
+	}
+
+	offsets.Add(tokens.GetCount());
+
+	lines = newLines;
+	rawTokens = tokens;
+	lineTokenOffsets = std::move(offsets);
+
+	ProcessTokens(tokens);
+
+	return tokens;
+}
+
+void Compiler::RecordFunctions(const List<Token>& tokens) {
+	List<FunctionRange> ranges = FindFunctionRanges(tokens);
+
+	for (uint64 i = 0; i < ranges.GetCount(); i++) {
+		const FunctionRange& range = ranges[i];
+
+		if (range.body == ~0) continue;
+
+		FunctionRecord* record = new FunctionRecord;
+
+		record->name = tokens[range.start + 1].string;
+		record->hash = HashTokens(tokens, range.body, range.end + 1);
+		record->declaration = nullptr;
+
+		for (uint64 j = range.start; j <= range.end; j++) {
+			record->tokens.Add(tokens[j]);
+		}
+
+		functionRecords.Add(record);
+	}
+
+	globalHash = HashGlobals(tokens, ranges);
+}
+
+void Compiler::RemoveFunctionBody(FunctionRecord* record) {
+	FunctionDeclaration* decl = record->declaration;
+
+	List<InstBase*> names(debugInstructions.GetCount());
+
+	for (uint64 i = 0; i < debugInstructions.GetCount(); i++) {
+		InstBase* inst = debugInstructions[i];
+
+		if (record->debugInstructions.Find(inst) == ~0) {
+			names.Add(inst);
+		} else if (decl->nameInstructions.Find(inst) == ~0) {
+			delete inst;
+		}
+	}
+
+	debugInstructions = std::move(names);
+
+	List<InstBase*> decorations(annotationIstructions.GetCount());
+
+	for (uint64 i = 0; i < annotationIstructions.GetCount(); i++) {
+		InstBase* inst = annotationIstructions[i];
+
+		if (record->annotationInstructions.Find(inst) == ~0) {
+			decorations.Add(inst);
+		} else {
+			delete inst;
+		}
+	}
+
+	annotationIstructions = std::move(decorations);
+
+	for (uint64 i = 0; i < record->instructions.GetCount(); i++) {
+		InstBase* inst = record->instructions[i];
+
+		if (decl->declInstructions.Find(inst) == ~0) delete inst;
+	}
+
+	record->instructions.Clear();
+	record->debugInstructions.Clear();
+	record->annotationInstructions.Clear();
+	record->calls.Clear();
+
+	decl->defined = false;
+}
+
+void Compiler::RecompileFunction(uint64 index) {
+	FunctionRecord* record = functionRecords[index];
+	FunctionDeclaration* decl = record->declaration;
+
+	RemoveFunctionBody(record);
+
+	//Previous loads belong to the old body
+	for (uint64 i = 0; i < decl->parameters.GetCount(); i++) {
+		decl->parameters[i]->variable.loadId = nullptr;
+	}
+
+	for (uint64 i = 0; i < globalVariables.GetCount(); i++) {
+		globalVariables[i]->variable.loadId = nullptr;
+	}
+
+	List<Token> tokens(record->tokens);
+
+	ParseFunction(tokens, 0);
+}
+
+void Compiler::OrderFunctions() {
+	auto getRecord = [this](const FunctionDeclaration* decl) -> FunctionRecord* {
+		for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+			if (functionRecords[i]->declaration == decl) return functionRecords[i];
+		}
+
+		return nullptr;
+	};
+
+	for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+		functionRecords[i]->order = ~0;
+	}
+
+	FunctionDeclaration* entry = GetFunctionDeclaration("main");
+
+	if (entry == nullptr) return;
+
+	//Same as ParseReachableFunctions, every call marks the function and the last one marked is parsed next
+	List<FunctionDeclaration*> reached(functionRecords.GetCount());
+	List<FunctionDeclaration*> stack(functionRecords.GetCount());
+
+	reached.Add(entry);
+	stack.Add(entry);
+
+	uint64 order = 0;
+
+	while (stack.GetCount() != 0) {
+		FunctionRecord* record = getRecord(stack.RemoveAt(stack.GetCount() - 1));
+
+		if (record == nullptr) continue;
+
+		record->order = order++;
+
+		for (uint64 i = 0; i < record->calls.GetCount(); i++) {
+			FunctionDeclaration* decl = record->calls[i];
+
+			if (reached.Find(decl) != ~0) continue;
+
+			reached.Add(decl);
+			stack.Add(decl);
+		}
+	}
+}
+
+void Compiler::Reset() {
+	auto deleteInstructions = [](List<InstBase*>& list) {
+		for (uint64 i = 0; i < list.GetCount(); i++) {
+			delete list[i];
+		}
+
+		list.Clear();
+	};
+
+	//Record instructions are also in instructions
+	deleteInstructions(debugInstructions);
+	deleteInstructions(annotationIstructions);
+	deleteInstructions(typeInstructions);
+	deleteInstructions(instructions);
+
+	delete extendedInstructionSet;
+
+	//structDefinitions only points into typeDefinitions
+	typeDefinitions.ForEach([](const TypeKey& key, TypeBase* type) {
+		delete type;
+	});
+
+	for (uint64 i = 0; i < globalVariables.GetCount(); i++) {
+		delete globalVariables[i];
+	}
+
+	for (uint64 i = 0; i < functionDeclarations.GetCount(); i++) {
+		FunctionDeclaration* decl = functionDeclarations[i];
+
+		for (uint64 j = 0; j < decl->parameters.GetCount(); j++) {
+			delete decl->parameters[j];
+		}
+
+		//Defined functions have their declaration in instructions and their names in debugInstructions
+		if (!decl->defined) {
+			deleteInstructions(decl->declInstructions);
+			deleteInstructions(decl->nameInstructions);
+		}
+
+		delete decl;
+	}
+
+	for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+		delete functionRecords[i];
+	}
+
+	typeDefinitions.Clear();
+	structDefinitions.Clear();
+	typeInstructionTable.Clear();
+	constants.Clear();
+	constantDefinitions.Clear();
+	globalVariables.Clear();
+	globalVariableNames.Clear();
+	functionDeclarations.Clear();
+	reachableFunctions.Clear();
+	functionRecords.Clear();
+	calledFunctions.Clear();
+	locations.Clear();
+	specIds.Clear();
+	blockLayouts.Clear();
+	loops.Clear();
+
+	extendedInstructionSet = nullptr;
+
+	localSize[0] = localSize[1] = localSize[2] = 1;
+}
+
+bool Compiler::Recompile(const String& code) {
+	if (!incremental) {
+		Log::Error("Recompile requires a compiler created with incremental compilation enabled");
+		return false;
+	}
+
+	this->code = code;
+
+	List<Token> tokens = TokenizeChanged(preprocessor::PreProcessor::Run(code, filename, defines, includes));
+	List<FunctionRange> ranges = FindFunctionRanges(tokens);
+
+	uint64 definitions = 0;
+
+	for (uint64 i = 0; i < ranges.GetCount(); i++) {
+		if (ranges[i].body != ~0) definitions++;
+	}
+
+	if (HashGlobals(tokens, ranges) != globalHash || definitions != functionRecords.GetCount()) {
+		//Globals, types or function signatures changed, every function may depend on it
+		Reset();
+		RecordFunctions(tokens);
+		ParseTokens(tokens);
+
+		return true;
+	}
+
+	//Calls only reference the id of the declaration, which is kept. So only the edited functions need to be parsed again
+	uint64 index = 0;
+
+	for (uint64 i = 0; i < ranges.GetCount(); i++) {
+		const FunctionRange& range = ranges[i];
+
+		if (range.body == ~0) continue;
+
+		FunctionRecord* record = functionRecords[index];
+
+		uint64 hash = HashTokens(tokens, range.body, range.end + 1);
+
+		if (hash != record->hash) {
+			record->hash = hash;
+			record->tokens.Clear();
+
+			for (uint64 j = range.start; j <= range.end; j++) {
+				record->tokens.Add(tokens[j]);
+			}
+
+			if (record->declaration) {
+				RecompileFunction(index);
+			} else {
+				//Not reachable yet, keep the new definition until something calls it
+				GetFunctionDeclaration(record->name)->definition = record->tokens;
+			}
+		}
+
+		index++;
+	}
+
+	ParseReachableFunctions();
+	OrderFunctions();
+
+	uint64 count = 0;
+
+	for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+		FunctionRecord* record = functionRecords[i];
+
+		if (record->declaration == nullptr) continue;
+
+		if (record->order == ~0) {
+			//No call to it is left, it's parsed again once one comes back
+			FunctionDeclaration* decl = record->declaration;
+
+			RemoveFunctionBody(record);
+
+			decl->reachable = false;
+			decl->definition = record->tokens;
+			record->declaration = nullptr;
+		} else {
+			count++;
+		}
+	}
+
+	List<FunctionRecord*> ordered(count);
+
+	ordered.Resize(count);
+
+	uint64 debugCount = debugInstructions.GetCount();
+	uint64 annotationCount = annotationIstructions.GetCount();
+
+	for (uint64 i = 0; i < functionRecords.GetCount(); i++) {
+		FunctionRecord* record = functionRecords[i];
+
+		if (record->declaration == nullptr) continue;
+
+		debugCount -= record->debugInstructions.GetCount();
+		annotationCount -= record->annotationInstructions.GetCount();
+
+		ordered[record->order] = record;
+	}
+
+	//Names and decorations of the globals come first because a full compile parses them before any body, the bodies follow in the order they are parsed
+	debugInstructions.Resize(debugCount);
+	annotationIstructions.Resize(annotationCount);
+	instructions.Clear();
+
+	for (uint64 i = 0; i < ordered.GetCount(); i++) {
+		FunctionRecord* record = ordered[i];
+
+		instructions.Add(record->instructions);
+		debugInstructions.Add(record->debugInstructions);
+		annotationIstructions.Add(record->annotationInstructions);
+	}
+
+	return true;
+}
+
+static bool ReadWords(const String& filename, List<uint32>& words) {
+	FILE* file = fopen(filename.str, "rb");
+
+	if (file == nullptr) {
+		Log::Error("Failed to open file \"%s\"", filename.str);
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	uint64 size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	words.Resize(size / sizeof(uint32));
+
+	fread(words.GetData(), words.GetSize(), 1, file);
+	fclose(file);
+
+	return true;
+}
+
+//Types and constants are created when they're first used, so an edited body can add them in a different order than a full compile. They are matched by their operands, everything else has to be in the same place. Ids only have to map one to one
+static bool CompareModules(optimizer::Module& a, optimizer::Module& b) {
+	using optimizer::Instruction;
+
+	List<uint32> forward(a.bound);
+	List<uint32> backward(b.bound);
+
+	for (uint32 i = 0; i < a.bound; i++) forward.Add(0);
+	for (uint32 i = 0; i < b.bound; i++) backward.Add(0);
+
+	auto isMapped = [&](uint32 ia, uint32 ib) -> bool {
+		return ia == 0 ? ib == 0 : forward[ia] == ib;
+	};
+
+	auto mapId = [&](uint32 ia, uint32 ib) -> bool {
+		if (ia == 0 || ib == 0) return ia == ib;
+
+		if (forward[ia] == 0 && backward[ib] == 0) {
+			forward[ia] = ib;
+			backward[ib] = ia;
+		}
+
+		return forward[ia] == ib;
+	};
+
+	//Operands that aren't ids have to be equal, ids are only checked against the ids mapped so far unless bind is set
+	auto matches = [&](Instruction* ia, Instruction* ib, bool bind) -> bool {
+		if (ia->opCode != ib->opCode || ia->operandCount != ib->operandCount) return false;
+		if (!(bind ? mapId(ia->resultType, ib->resultType) : isMapped(ia->resultType, ib->resultType))) return false;
+
+		List<uint32*> ids(8);
+
+		ia->ForEachId([&ids](uint32& id) { ids.Add(&id); });
+
+		uint64 next = 0;
+
+		for (uint32 i = 0; i < ia->operandCount; i++) {
+			uint32 wa = ia->operands[i];
+			uint32 wb = ib->operands[i];
+
+			if (next < ids.GetCount() && ids[next] == ia->operands + i) {
+				next++;
+
+				if (!(bind ? mapId(wa, wb) : isMapped(wa, wb))) return false;
+			} else if (wa != wb) {
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	List<Instruction*> globals(256);
+
+	for (Instruction* inst = b.globals.first; inst; inst = inst->next) {
+		globals.Add(inst);
+	}
+
+	//Operands of a global are always defined before it, so they are already mapped
+	for (Instruction* ia = a.globals.first; ia; ia = ia->next) {
+		uint64 j = 0;
+
+		while (j < globals.GetCount() && !(matches(ia, globals[j], false) && mapId(ia->result, globals[j]->result))) j++;
+
+		if (j == globals.GetCount()) {
+			Log::Error("Recompiled module has a %s the full compile doesn't have", GetOpCodeName(ia->opCode));
+			return false;
+		}
+
+		globals.RemoveAt(j);
+	}
+
+	if (globals.GetCount() != 0) {
+		Log::Error("Full compile has a %s the recompiled module doesn't have", GetOpCodeName(globals[0]->opCode));
+		return false;
+	}
+
+	auto collect = [](optimizer::Module& module, List<Instruction*>& list) {
+		module.ForEachInstruction([&module, &list](Instruction* inst) {
+			if (inst->list != &module.globals) list.Add(inst);
+		});
+	};
+
+	List<Instruction*> instA(1024);
+	List<Instruction*> instB(1024);
+
+	collect(a, instA);
+	collect(b, instB);
+
+	if (instA.GetCount() != instB.GetCount()) {
+		Log::Error("Recompiled module has %llu instructions outside the globals, full compile has %llu", instA.GetCount(), instB.GetCount());
+		return false;
+	}
+
+	for (uint64 i = 0; i < instA.GetCount(); i++) {
+		if (!matches(instA[i], instB[i], true) || !mapId(instA[i]->result, instB[i]->result)) {
+			Log::Error("Recompiled module differs from full compile at %s (instruction %llu)", GetOpCodeName(instA[i]->opCode), i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Compiler::CheckRecompile(const String& filename, const String& editedFile, const List<String>& defines, const List<String>& includes, const String& outFile) {
+	Compiler c(Utils::ReadFile(filename), filename, defines, includes, true);
+
+	if (!c.Process()) return true;
+	if (!c.Recompile(Utils::ReadFile(editedFile))) return false;
+	if (!c.GenerateFile(outFile)) return false;
+
+	String fullFile = outFile + ".full";
+
+	if (!Run(editedFile, defines, includes, fullFile)) return false;
+
+	List<uint32> a;
+	List<uint32> b;
+
+	bool read = ReadWords(outFile, a) && ReadWords(fullFile, b);
+
+	remove(fullFile.str);
+
+	if (!read) return false;
+
+	optimizer::Module recompiled;
+	optimizer::Module full;
+
+	if (!recompiled.Load(a.GetData(), a.GetCount()) || !full.Load(b.GetData(), b.GetCount())) {
+		Log::Error("Failed to load the modules for comparison");
+		return false;
+	}
+
+	return CompareModules(recompiled, full);
+}
+
+bool Compiler::Recompile(const String& code, List<uint32>& spirv, List<Diagnostic>* diagnostics) {
+	List<Diagnostic> messages(16);
+
+	Log::SetDiagnostics(&messages);
+
+	bool res = Recompile(code) && Generate(spirv);
+
+	Log::SetDiagnostics(nullptr);
+
+	for (uint64 i = 0; i < messages.GetCount(); i++) {
+		if (messages[i].level == LogLevel::Error) res = false;
+	}
+
+	if (diagnostics) diagnostics->Add(messages);
+
+	return res;
+}
+
+}
+}
+}
@@ -35,7 +35,11 @@ using namespace parsing;
 
 Compiler::VariableStack::VariableStack(Compiler* compiler, const List<Symbol*>& parameters) : compiler(compiler) {
 	PushStack();
-	variables.Add(parameters);
+
+	for (uint64 i = 0; i < parameters.GetCount(); i++) {
+		Declare(parameters[i]);
+	}
+
 	PushStack();
 }
 
@@ -55,29 +59,19 @@ bool Compiler::VariableStack::CheckName(const Token& name) {
 
 bool Compiler::VariableStack::CheckName(const String& name, const Token& token) {
 	uint64 stackOffset = offsets[offsets.GetCount() - 1];
+	uint64 paramOffset = offsets[1];
 
 	bool res = true;
 
-	for (uint64 i = stackOffset; i < variables.GetCount(); i++) {
-		Symbol* var = variables[i];
-		if (var->variable.name == name) {
-			Log::CompilerError(token, "Redefinition of variable \"%s\"", name.str);
-		}
-	}
-
-	uint64 paramOffset = offsets[1];
+	const uint64* index = names.Get(name);
 
-	for (int64 i = stackOffset - 1; i >= (int64)paramOffset; i--) {
-		Symbol* var = variables[i];
-		if (var->variable.name == name) {
+	if (index != nullptr) {
+		if (*index >= stackOffset) {
+			Log::CompilerError(token, "Redefinition of variable \"%s\"", name.str);
+		} else if (*index >= paramOffset) {
 			Log::CompilerWarning(token, "Overriding local variable \"%s\"", name.str);
 			res = false;
-		}
-	}
-
-	for (uint64 i = 0; i < paramOffset; i++) {
-		Symbol* var = variables[i];
-		if (var->parameter.name == name) {
+		} else {
 			Log::CompilerWarning(token, "Overriding parameter \"%s\"", name.str);
 			res = false;
 		}
@@ -96,21 +90,40 @@ void Compiler::VariableStack::PopStack() {
 
 	if (of == count) return;
 
+	for (uint64 i = count; i > of; i--) {
+		const String& name = variables[i - 1]->variable.name;
+		uint64 prev = shadowed[i - 1];
+
+		if (prev == ~0) {
+			names.Remove(name);
+		} else {
+			names.Set(name, prev);
+		}
+	}
+
 	variables.Remove(of, count - 1);
+	shadowed.Remove(of, count - 1);
 }
 
-void Compiler::VariableStack::AddVariable(Symbol* variable, InstBase* inst) {
+void Compiler::VariableStack::Declare(Symbol* variable) {
+	const String& name = variable->variable.name;
+	const uint64* prev = names.Get(name);
+
+	shadowed.Add(prev ? *prev : ~0);
+	names.Set(name, variables.GetCount());
+
 	variables.Add(variable);
+}
+
+void Compiler::VariableStack::AddVariable(Symbol* variable, InstBase* inst) {
+	Declare(variable);
 	variableInstructions.Add(inst);
 }
 
 Compiler::Symbol* Compiler::VariableStack::GetVariable(const String& name) {
-	for (int64 i = variables.GetCount() - 1; i >= 0; i--) {
-		Symbol* var = variables[i];
-		if (var->variable.name == name) return var;
-	}
+	const uint64* index = names.Get(name);
 
-	return nullptr;
+	return index ? variables[*index] : nullptr;
 }
 
 uint64 Compiler::VariableStack::GetSize() const {
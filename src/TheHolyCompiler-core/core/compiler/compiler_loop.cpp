@@ -0,0 +1,396 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "compiler.h"
+#include <util/utils.h>
+#include <util/log.h>
+
+#define THC_UNROLL_MAX_ITERATIONS 32 //Loops with more iterations are only unrolled with [[unroll]]
+#define THC_UNROLL_MAX_TOKENS 2048 //Max iterations * body tokens for loops without [[unroll]]
+#define THC_UNROLL_MAX_FORCED_ITERATIONS 1024
+
+namespace thc {
+namespace core {
+namespace compiler {
+
+using namespace utils;
+using namespace parsing;
+using namespace type;
+using namespace instruction;
+
+//end is inclusive
+static void CopyTokens(const List<Token>& tokens, uint64 start, uint64 end, List<Token>& dst) {
+	for (uint64 i = start; i <= end && i < tokens.GetCount(); i++) {
+		dst.Add(tokens[i]);
+	}
+}
+
+static Token CreateToken(TokenType type, const char* string, const Token& position) {
+	return Token(type, string, position.line, position.column);
+}
+
+//Reads an integer literal with an optional minus in front of it
+static bool ReadInteger(const List<Token>& tokens, uint64& index, int64* value) {
+	bool negative = tokens[index].type == TokenType::OperatorNegate;
+
+	uint64 i = negative ? index + 1 : index;
+
+	if (i >= tokens.GetCount()) return false;
+
+	const Token& t = tokens[i];
+
+	if (t.type != TokenType::Value || t.valueType != TokenType::TypeInt) return false;
+
+	*value = negative ? -(int64)t.value : (int64)t.value;
+	index = i + 1;
+
+	return true;
+}
+
+static bool EvaluateCondition(TokenType op, int64 value, int64 bound) {
+	switch (op) {
+		case TokenType::OperatorLess:
+			return value < bound;
+		case TokenType::OperatorLessEqual:
+			return value <= bound;
+		case TokenType::OperatorGreater:
+			return value > bound;
+		case TokenType::OperatorGreaterEqual:
+			return value >= bound;
+		case TokenType::OperatorNotEqual:
+			return value != bound;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+void Compiler::ParseLoop(FunctionDeclaration* declaration, List<Token>& tokens, uint64 start, VariableStack* localVariables) {
+	uint32 loopControl = THC_SPIRV_LOOP_CONTROL_NONE;
+
+	if (tokens[start].type == TokenType::BracketOpen) {
+		const Token& bracket = tokens[start];
+
+		if (start + 5 >= tokens.GetCount() || tokens[start + 1].type != TokenType::BracketOpen || tokens[start + 2].type != TokenType::Name || tokens[start + 3].type != TokenType::BracketClose || tokens[start + 4].type != TokenType::BracketClose) {
+			Log::CompilerError(bracket, "Unexpected symbol \"%s\" expected \"[[unroll]]\" or \"[[dont_unroll]]\"", bracket.string.str);
+		}
+
+		const Token& attribute = tokens[start + 2];
+
+		if (attribute.string == "unroll") {
+			loopControl = THC_SPIRV_LOOP_CONTROL_UNROLL;
+		} else if (attribute.string == "dont_unroll") {
+			loopControl = THC_SPIRV_LOOP_CONTROL_DONT_UNROLL;
+		} else {
+			Log::CompilerError(attribute, "Unknown loop attribute \"%s\"", attribute.string.str);
+		}
+
+		tokens.Remove(start, start + 4);
+
+		const Token& loop = tokens[start];
+
+		if (!Utils::CompareEnums(loop.type, CompareOperation::Or, TokenType::ControlFlowFor, TokenType::ControlFlowWhile)) {
+			Log::CompilerError(loop, "Unexpected symbol \"%s\" expected \"for\" or \"while\" after a loop attribute", loop.string.str);
+		}
+	}
+
+	const Token loop = tokens[start];
+	const Token& parenthesisOpen = tokens[start + 1];
+
+	if (parenthesisOpen.type != TokenType::ParenthesisOpen) {
+		Log::CompilerError(parenthesisOpen, "Unexpected symbol \"%s\" expected \"(\"", parenthesisOpen.string.str);
+	}
+
+	uint64 close = FindMatchingToken(tokens, start, TokenType::ParenthesisOpen, TokenType::ParenthesisClose);
+
+	if (close == ~0) {
+		Log::CompilerError(parenthesisOpen, "\"(\" needs a closing \")\"");
+	}
+
+	List<Token> init;
+	List<Token> condition;
+	List<Token> step;
+	List<Token> body;
+
+	uint64 conditionStart = start + 2;
+	uint64 conditionEnd = close;
+
+	if (loop.type == TokenType::ControlFlowFor) {
+		uint64 semiColons[2];
+		uint64 count = 0;
+
+		for (uint64 i = start + 2; i < close; i++) {
+			if (tokens[i].type != TokenType::SemiColon) continue;
+
+			if (count == 2) {
+				Log::CompilerError(tokens[i], "Unexpected symbol \"%s\" expected \")\"", tokens[i].string.str);
+			}
+
+			semiColons[count++] = i;
+		}
+
+		if (count != 2) {
+			Log::CompilerError(loop, "\"for\" must be followed by \"(init; condition; step)\"");
+		}
+
+		//Both are parsed as statements, so they need to end with ";" unless they are empty
+		if (semiColons[0] > start + 2) CopyTokens(tokens, start + 2, semiColons[0], init);
+
+		if (close > semiColons[1] + 1) {
+			CopyTokens(tokens, semiColons[1] + 1, close - 1, step);
+			step.Add(CreateToken(TokenType::SemiColon, ";", tokens[close]));
+		}
+
+		conditionStart = semiColons[0] + 1;
+		conditionEnd = semiColons[1];
+	} else if (close == start + 2) {
+		Log::CompilerError(loop, "\"while\" needs a condition");
+	}
+
+	init.Add(CreateToken(TokenType::CurlyBracketClose, "}", tokens[close]));
+	step.Add(CreateToken(TokenType::CurlyBracketClose, "}", tokens[close]));
+
+	if (conditionEnd > conditionStart) {
+		CopyTokens(tokens, conditionStart, conditionEnd - 1, condition);
+	}
+
+	condition.Add(CreateToken(TokenType::SemiColon, ";", tokens[conditionEnd]));
+
+	uint64 end = FindStatementEnd(tokens, close + 1);
+
+	if (end == ~0) {
+		Log::CompilerError(tokens[close], "Expected a statement or \"{\" after \"%s\"", loop.string.str);
+	}
+
+	if (tokens[close + 1].type == TokenType::CurlyBracketOpen) {
+		CopyTokens(tokens, close + 2, end, body);
+	} else {
+		CopyTokens(tokens, close + 1, end, body);
+		body.Add(CreateToken(TokenType::CurlyBracketClose, "}", tokens[end]));
+	}
+
+	tokens.Remove(start, end);
+
+	localVariables->PushStack(); //Variables declared in init only exist inside the loop
+
+	if (loopControl == THC_SPIRV_LOOP_CONTROL_DONT_UNROLL || !UnrollLoop(declaration, init, condition, step, body, localVariables, loopControl == THC_SPIRV_LOOP_CONTROL_UNROLL)) {
+		ParseStatements(declaration, init, 0, localVariables);
+
+		InstBase* headerBlock = NewInst<InstLabel>();
+		InstBase* bodyBlock = NewInst<InstLabel>();
+		InstBase* continueBlock = NewInst<InstLabel>();
+		InstBase* mergeBlock = NewInst<InstLabel>();
+
+		instructions.Add(NewInst<InstBranch>(headerBlock->id));
+		BeginBlock(headerBlock, localVariables);
+
+		if (condition.GetCount() > 1) {
+			ParseInfo inf;
+			inf.start = 0;
+			inf.end = condition.GetCount() - 2;
+			inf.len = 0;
+
+			ID* conditionId = ParseCondition(condition, &inf, localVariables);
+
+			instructions.Add(NewInst<InstLoopMerge>(mergeBlock->id, continueBlock->id, loopControl));
+			instructions.Add(NewInst<InstBranchConditional>(conditionId, bodyBlock->id, mergeBlock->id, 1, 1));
+		} else {
+			//No condition, only break or return leaves the loop
+			instructions.Add(NewInst<InstLoopMerge>(mergeBlock->id, continueBlock->id, loopControl));
+			instructions.Add(NewInst<InstBranch>(bodyBlock->id));
+		}
+
+		BeginBlock(bodyBlock, localVariables);
+
+		Loop l;
+		l.mergeBlock = mergeBlock;
+		l.continueBlock = continueBlock;
+
+		loops.Add(l);
+
+		ParseBody(declaration, body, 0, localVariables);
+
+		loops.RemoveAt(loops.GetCount() - 1);
+
+		instructions.Add(NewInst<InstBranch>(continueBlock->id));
+		BeginBlock(continueBlock, localVariables);
+
+		ParseStatements(declaration, step, 0, localVariables);
+
+		instructions.Add(NewInst<InstBranch>(headerBlock->id));
+		BeginBlock(mergeBlock, localVariables);
+	}
+
+	localVariables->PopStack();
+}
+
+bool Compiler::UnrollLoop(FunctionDeclaration* declaration, const List<Token>& init, const List<Token>& condition, const List<Token>& step, const List<Token>& body, VariableStack* localVariables, bool force) {
+	//Only loops like "for (int32 i = a; i < b; i++)" where a and b are literals and the body doesn't write i
+	if (init.GetCount() < 6 || init[0].type != TokenType::TypeInt || init[1].type != TokenType::Name || init[2].type != TokenType::OperatorAssign) return false;
+	if (init[0].bits > 32) return false;
+
+	const Token& type = init[0];
+	const String& name = init[1].string;
+
+	int64 first;
+	uint64 index = 3;
+
+	if (!ReadInteger(init, index, &first) || init[index].type != TokenType::SemiColon || index + 2 != init.GetCount()) return false;
+
+	if (condition.GetCount() < 4 || condition[0].type != TokenType::Name || !(condition[0].string == name)) return false;
+
+	TokenType op = condition[1].type;
+
+	if (!Utils::CompareEnums(op, CompareOperation::Or, TokenType::OperatorLess, TokenType::OperatorLessEqual, TokenType::OperatorGreater, TokenType::OperatorGreaterEqual, TokenType::OperatorNotEqual)) return false;
+
+	int64 bound;
+	index = 2;
+
+	if (!ReadInteger(condition, index, &bound) || index + 1 != condition.GetCount()) return false;
+
+	int64 increment = 0;
+
+	if (step.GetCount() == 4) {
+		//i++, i--, ++i or --i
+		const Token& a = step[0];
+		const Token& b = step[1];
+
+		const Token& var = a.type == TokenType::Name ? a : b;
+		const Token& operation = a.type == TokenType::Name ? b : a;
+
+		if (var.type != TokenType::Name || !(var.string == name)) return false;
+
+		if (operation.type == TokenType::OperatorIncrement) {
+			increment = 1;
+		} else if (operation.type == TokenType::OperatorDecrement) {
+			increment = -1;
+		}
+	} else if (step.GetCount() >= 5 && step[0].type == TokenType::Name && step[0].string == name && Utils::CompareEnums(step[1].type, CompareOperation::Or, TokenType::OperatorCompoundAdd, TokenType::OperatorCompoundSub)) {
+		//i += n or i -= n
+		index = 2;
+
+		if (!ReadInteger(step, index, &increment) || index + 2 != step.GetCount()) return false;
+
+		if (step[1].type == TokenType::OperatorCompoundSub) increment = -increment;
+	}
+
+	if (increment == 0) return false;
+
+	for (uint64 i = 0; i < body.GetCount(); i++) {
+		const Token& t = body[i];
+
+		if (Utils::CompareEnums(t.type, CompareOperation::Or, TokenType::ControlFlowBreak, TokenType::ControlFlowContinue)) return false;
+		if (t.type != TokenType::Name || !(t.string == name)) continue;
+
+		TokenType prev = i > 0 ? body[i - 1].type : TokenType::None;
+		TokenType next = body[i + 1].type;
+
+		if (Utils::CompareEnums(prev, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement)) return false;
+		if (next >= TokenType::OperatorAssign && next <= TokenType::OperatorCompoundDiv) return false;
+		if (Utils::CompareEnums(next, CompareOperation::Or, TokenType::OperatorIncrement, TokenType::OperatorDecrement)) return false;
+
+		if (Utils::CompareEnums(prev, CompareOperation::Or, TokenType::ParenthesisOpen, TokenType::Comma) && Utils::CompareEnums(next, CompareOperation::Or, TokenType::ParenthesisClose, TokenType::Comma)) {
+			//Passed to a function, which could take it as a reference
+			uint64 depth = 0;
+			uint64 open = i - 1;
+
+			for (; open != ~0; open--) {
+				if (body[open].type == TokenType::ParenthesisClose) {
+					depth++;
+				} else if (body[open].type == TokenType::ParenthesisOpen) {
+					if (depth-- == 0) break;
+				}
+			}
+
+			if (open == ~0 || open == 0) return false;
+
+			const Token& function = body[open - 1];
+
+			if (function.type == TokenType::Name) {
+				bool found = false;
+
+				for (uint64 j = 0; j < functionDeclarations.GetCount(); j++) {
+					FunctionDeclaration* decl = functionDeclarations[j];
+
+					if (!(decl->name == function.string)) continue;
+
+					found = true;
+
+					for (uint64 k = 0; k < decl->parameters.GetCount(); k++) {
+						if (decl->parameters[k]->parameter.isReference) return false;
+					}
+				}
+
+				//Builtin and extended instructions may write to their arguments
+				if (!found) return false;
+			} else if (!(function.type >= TokenType::TypeBool && function.type <= TokenType::TypeMatrix)) {
+				//Anything but a type constructor
+				return false;
+			}
+		}
+	}
+
+	int64 min = type.sign ? -(1LL << (type.bits - 1)) : 0;
+	int64 max = type.sign ? (1LL << (type.bits - 1)) - 1 : (1LL << type.bits) - 1;
+
+	if (first < min || first > max) return false;
+
+	uint64 maxIterations = force ? THC_UNROLL_MAX_FORCED_ITERATIONS : THC_UNROLL_MAX_ITERATIONS;
+
+	List<int64> values;
+
+	for (int64 value = first; EvaluateCondition(op, value, bound); value += increment) {
+		//Wrapping around is left to the loop
+		if (value < min || value > max || values.GetCount() == maxIterations) return false;
+
+		values.Add(value);
+	}
+
+	if (!force && values.GetCount() * body.GetCount() > THC_UNROLL_MAX_TOKENS) return false;
+
+	List<Token> tokens(init);
+
+	ParseStatements(declaration, tokens, 0, localVariables);
+
+	Symbol* var = localVariables->GetVariable(name);
+
+	for (uint64 i = 0; i < values.GetCount(); i++) {
+		ID* id = CreateConstant(var->type, (uint32)values[i]);
+
+		StoreVariable(var, id);
+
+		var->variable.loadId = id; //Reads of the counter become the constant
+
+		tokens = body;
+
+		ParseBody(declaration, tokens, 0, localVariables);
+	}
+
+	return true;
+}
+
+}
+}
+}
@@ -35,66 +35,35 @@ using namespace parsing;
 using namespace instruction;
 using namespace type;
 
-bool Compiler::findStructFunc(TypeBase* const& curr, const String& name) {
-	if (curr->type == Type::Struct) {
-		return curr->typeString == name;
-	}
-
-	return false;
-};
-
 void Compiler::CheckTypeExist(InstTypeBase** type) {
-	auto cmp = [](InstBase* const& curr, InstTypeBase* const& type) -> bool {
-		if (curr->type != InstType::Type) return false;
-
-		InstTypeBase* t = (InstTypeBase*)curr;
+	InstTypeBase* const* existing = typeInstructionTable.Get({ *type });
 
-		if (t->type == type->type) {
-			return *t == type;
-		}
-		
-		return false;
-	};
-
-	uint64 index = typeInstructions.Find<InstTypeBase*>(*type, cmp);
-
-	if (index == ~0) {
+	if (existing == nullptr) {
+		typeInstructionTable.Set({ *type }, *type);
 		typeInstructions.Add(*type);
 	} else {
 		delete *type;
 
-		*type = (InstTypeBase*)typeInstructions[index];
+		*type = *existing;
 	}
 }
 
-void Compiler::CheckTypeExist(TypeBase** type) {
-	auto cmp = [](TypeBase* const& curr, TypeBase* const& type) -> bool {
-		return *curr == type;
-	};
+Compiler::TypeBase* Compiler::FindType(const TypeBase& type) const {
+	TypeBase* const* existing = typeDefinitions.Get({ &type });
 
-	uint64 index = typeDefinitions.Find<TypeBase*>(*type, cmp);
+	return existing ? *existing : nullptr;
+}
 
-	if (index == ~0) {
-		typeDefinitions.Add(*type);
-	} else {
-		delete *type;
+void Compiler::AddType(TypeBase* type) {
+	THC_ASSERT(FindType(*type) == nullptr);
 
-		*type = (TypeBase*)typeDefinitions[index];
-	}
+	typeDefinitions.Set({ type }, type);
 }
 
-void Compiler::CheckConstantExist(InstBase** constant) {
-	uint64 index = typeInstructions.Find<InstBase*>(*constant, [](InstBase* const& curr, InstBase* const& inst) -> bool {
-		return *curr == inst;
-	});
-
-	if (index == ~0) {
-		typeInstructions.Add(*constant);
-	} else {
-		delete *constant;
+Compiler::TypeStruct* Compiler::GetStruct(const String& name) const {
+	TypeStruct* const* str = structDefinitions.Get(name);
 
-		*constant = typeInstructions[index];
-	}
+	return str ? *str : nullptr;
 }
 
 Compiler::TypePrimitive* Compiler::CreateTypePrimitive(List<Token>& tokens, uint64 start, uint64* len) {
@@ -106,30 +75,9 @@ Compiler::TypePrimitive* Compiler::CreateTypePrimitive(List<Token>& tokens, uint
 	if (!Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::TypeBool, TokenType::TypeFloat, TokenType::TypeInt, TokenType::TypeVector, TokenType::TypeMatrix, TokenType::TypeVoid)) {
 		Log::CompilerError(token, "Unexpecet symbol \"%s\" expected a valid type", token.string.str);
 	} else if (token.type == TokenType::TypeVoid) {
-		TypePrimitive* var = new TypePrimitive;
-		var->type = Type::Void;
-		var->typeString = "void";
-		var->componentType = Type::Void;
-		var->bits = 0;
-		var->sign = 0;
-		var->rows = 0;
-		var->columns = 0;
-		var->typeId = nullptr;
-
-		CheckTypeExist((TypeBase * *)& var);
-
 		tokens.RemoveAt(start);
 
-		if (var->typeId != nullptr) {
-			return var;
-		}
-
-		InstTypeVoid* v = new InstTypeVoid();
-		typeInstructions.Add(v);
-
-		var->typeId = v->id;
-
-		return var;
+		return CreateTypeVoid();
 	}
 
 	TypePrimitive tmpVar;
@@ -171,15 +119,9 @@ Compiler::TypePrimitive* Compiler::CreateTypePrimitive(List<Token>& tokens, uint
 	tmpVar.rows = token.rows;
 	tmpVar.columns = token.columns;
 
-	uint64 index = typeDefinitions.Find<TypePrimitive*>(&tmpVar, [](TypeBase* const& curr, TypePrimitive* const& other) -> bool {
-		return *curr == other;
-		});
-
-	TypePrimitive* var = nullptr;
+	TypePrimitive* var = (TypePrimitive*)FindType(tmpVar);
 
-	if (index != ~0) {
-		var = (TypePrimitive*)typeDefinitions[index];
-	} else {
+	if (var == nullptr) {
 		switch (tmpVar.type) {
 			case Type::Bool:
 				var = CreateTypeBool();
@@ -205,48 +147,36 @@ Compiler::TypePrimitive* Compiler::CreateTypePrimitive(List<Token>& tokens, uint
 }
 
 Compiler::TypePrimitive* Compiler::CreateTypeBool() {
-	TypePrimitive* var = new TypePrimitive;
-
-	var->type = Type::Bool;
-	var->componentType = Type::Bool;
-	var->bits = 0;
-	var->sign = 0;
-	var->rows = 0;
-	var->columns = 0;
-	var->typeId = nullptr;
+	TypePrimitive key(Type::Bool, Type::Bool, 0, 0, 0, 0);
 
-	CheckTypeExist((TypeBase**)&var);
+	TypePrimitive* var = (TypePrimitive*)FindType(key);
 
-	if (var->typeId != nullptr) {
+	if (var != nullptr) {
 		return var;
 	}
 
-	InstTypeBool* b = new InstTypeBool;
+	var = new TypePrimitive(Type::Bool, Type::Bool, 0, 0, 0, 0);
+
+	InstTypeBool* b = NewInst<InstTypeBool>();
 
 	CheckTypeExist((InstTypeBase**)&b);
 
 	var->typeId = b->id;
 	var->typeString = "bool";
 
+	AddType(var);
+
 	return var;
 }
 
 Compiler::TypePrimitive* Compiler::CreateTypePrimitiveScalar(Type type, uint8 bits, uint8 sign) {
 	THC_ASSERT(Utils::CompareEnums(type, CompareOperation::Or, Type::Int, Type::Float));
 
-	TypePrimitive* var = new TypePrimitive;
+	TypePrimitive key(type, type, bits, sign, 0, 0);
 
-	var->type = type;
-	var->componentType = type;
-	var->bits = bits;
-	var->sign = sign;
-	var->rows = 0;
-	var->columns = 0;
-	var->typeId = nullptr;
+	TypePrimitive* var = (TypePrimitive*)FindType(key);
 
-	CheckTypeExist((TypeBase**)&var);
-
-	if (var->typeId != nullptr) {
+	if (var != nullptr) {
 		return var;
 	}
 
@@ -265,7 +195,7 @@ Compiler::TypePrimitive* Compiler::CreateTypePrimitiveScalar(Type type, uint8 bi
 					if (!CompilerOptions::Int64()) Log::Error("-int64 needs to be specified to use int64");
 			}
 
-			t = new InstTypeInt(bits, 0); //Remove signedness from all integers, signedness will be handled internally
+			t = NewInst<InstTypeInt>(bits, 0); //Remove signedness from all integers, signedness will be handled internally
 			break;
 		case Type::Float:
 			switch (bits) {
@@ -277,75 +207,91 @@ Compiler::TypePrimitive* Compiler::CreateTypePrimitiveScalar(Type type, uint8 bi
 
 			}
 
-			t = new InstTypeFloat(bits);
+			t = NewInst<InstTypeFloat>(bits);
 			break;
 	}
 
 	CheckTypeExist((InstTypeBase**)&t);
 
+	var = new TypePrimitive(type, type, bits, sign, 0, 0);
 	var->typeId = t->id;
 	var->typeString = GetTypeString(var);
 
+	AddType(var);
+
+	return var;
+}
+
+Compiler::TypePrimitive* Compiler::CreateTypeVoid() {
+	TypePrimitive key(Type::Void, Type::Void, 0, 0, 0, 0);
+
+	TypePrimitive* var = (TypePrimitive*)FindType(key);
+
+	if (var != nullptr) {
+		return var;
+	}
+
+	var = new TypePrimitive(Type::Void, Type::Void, 0, 0, 0, 0);
+	var->typeString = "void";
+
+	InstTypeVoid* v = NewInst<InstTypeVoid>();
+
+	CheckTypeExist((InstTypeBase**)&v);
+
+	var->typeId = v->id;
+
+	AddType(var);
+
 	return var;
 }
 
 Compiler::TypePrimitive* Compiler::CreateTypePrimitiveVector(Type componentType, uint8 bits, uint8 sign, uint8 rows) {
 	THC_ASSERT(Utils::CompareEnums(componentType, CompareOperation::Or, Type::Int, Type::Float));
 
-	TypePrimitive* vec = new TypePrimitive;
-
-	vec->type = Type::Vector;
-	vec->componentType = componentType;
-	vec->bits = bits;
-	vec->sign = sign;
-	vec->rows = rows;
-	vec->columns = 0;
-	vec->typeId = nullptr;
+	TypePrimitive key(Type::Vector, componentType, bits, sign, rows, 0);
 
-	CheckTypeExist((TypeBase**)&vec);
+	TypePrimitive* vec = (TypePrimitive*)FindType(key);
 
-	if (vec->typeId != nullptr) {
+	if (vec != nullptr) {
 		return vec;
 	}
 	
-	InstTypeVector* t = new InstTypeVector(vec->rows, CreateTypePrimitiveScalar(componentType, bits, sign)->typeId);
+	InstTypeVector* t = NewInst<InstTypeVector>(rows, CreateTypePrimitiveScalar(componentType, bits, sign)->typeId);
 
 	CheckTypeExist((InstTypeBase**)&t);
 
+	vec = new TypePrimitive(Type::Vector, componentType, bits, sign, rows, 0);
 	vec->typeId = t->id;
 	vec->typeString = GetTypeString(vec);
 
+	AddType(vec);
+
 	return vec;
 }
 
 Compiler::TypePrimitive* Compiler::CreateTypePrimtiveMatrix(Type componentType, uint8 bits, uint8 sign, uint8 rows, uint8 columns) {
 	THC_ASSERT(Utils::CompareEnums(componentType, CompareOperation::Or, Type::Int, Type::Float));
 
-	TypePrimitive* mat = new TypePrimitive;
+	TypePrimitive key(Type::Matrix, componentType, bits, sign, rows, columns);
 
-	mat->type = Type::Matrix;
-	mat->componentType = componentType;
-	mat->bits = bits;
-	mat->sign = sign;
-	mat->rows = rows;
-	mat->columns = columns;
-	mat->typeId = nullptr;
+	TypePrimitive* mat = (TypePrimitive*)FindType(key);
 
-	CheckTypeExist((TypeBase**)&mat);
-
-	if (mat->typeId != nullptr) {
+	if (mat != nullptr) {
 		return mat;
 	}
 
 	TypeBase* vec = CreateTypePrimitiveVector(componentType, bits, sign, rows);
 
-	InstTypeMatrix* m = new InstTypeMatrix(columns, vec->typeId);
+	InstTypeMatrix* m = NewInst<InstTypeMatrix>(columns, vec->typeId);
 
 	CheckTypeExist((InstTypeBase**)&m);
 
+	mat = new TypePrimitive(Type::Matrix, componentType, bits, sign, rows, columns);
 	mat->typeId = m->id;
 	mat->typeString = GetTypeString(mat);
 
+	AddType(mat);
+
 	return mat;
 }
 
@@ -363,7 +309,7 @@ Compiler::TypePrimitive* Compiler::ModifyTypePrimitiveBitWidth(TypePrimitive* ba
 	return nullptr;
 }
 
-Compiler::TypeStruct* Compiler::CreateTypeStruct(List<Token>& tokens, uint64 start, uint64* len) {
+Compiler::TypeStruct* Compiler::CreateTypeStruct(List<Token>& tokens, uint64 start, uint64* len, bool isBlock) {
 	TypeStruct* var = new TypeStruct;
 
 	uint64 offset = 0;
@@ -384,6 +330,8 @@ Compiler::TypeStruct* Compiler::CreateTypeStruct(List<Token>& tokens, uint64 sta
 	List<ID*> ids;
 
 	while (true) {
+		bool relaxed = ParsePrecision(tokens, start + offset);
+
 		TypeBase* tmp = CreateType(tokens, start + offset, len);
 
 		const Token& tokenName = tokens[start + offset++];
@@ -414,11 +362,12 @@ Compiler::TypeStruct* Compiler::CreateTypeStruct(List<Token>& tokens, uint64 sta
 
 		m.name = tokenName.string;
 		m.type = tmp;
+		m.isRelaxed = relaxed;
+		m.index = (uint32)var->members.GetCount();
+		m.offset = 0;
 
 		var->members.Emplace(m);
 
-		ids.Add(tmp->typeId);
-
 		if (tokens[start + offset].type == TokenType::CurlyBracketClose) {
 			const Token& t = tokens[start + ++offset];
 
@@ -430,66 +379,111 @@ Compiler::TypeStruct* Compiler::CreateTypeStruct(List<Token>& tokens, uint64 sta
 		}
 	}
 
+	if (isBlock && CompilerOptions::PackUniforms()) PackStructMembers(var->members);
+
+	uint32 memberOffset = 0;
+
+	for (uint64 i = 0; i < var->members.GetCount(); i++) {
+		StructMember& m = var->members[i];
+
+		m.offset = RoundUp(memberOffset, m.type->GetAlignment());
+		memberOffset = m.offset + m.type->GetSize();
+
+		ids.Add(m.type->typeId);
+	}
+
 	var->type = Type::Struct;
 	var->typeString = name.string;
 
-	if (typeDefinitions.Find<String>(var->typeString, findStructFunc) == ~0) {
-		typeDefinitions.Add(var);
+	if (GetStruct(var->typeString) == nullptr) {
+		structDefinitions.Set(var->typeString, var);
+		AddType(var);
 	} else {
 		delete var;
 		Log::CompilerError(name, "Struct redefinition");
 	}
 
-	InstTypeStruct* st = new InstTypeStruct((uint32)ids.GetCount(), ids.GetData());
+	//Not interned, structs with the same members are still distinct types with their own names and decorations
+	InstTypeStruct* st = NewInst<InstTypeStruct>((uint32)ids.GetCount(), ids.GetData());
 
-	CheckTypeExist((InstTypeBase**)&st);
+	typeInstructions.Add(st);
 
 	tokens.Remove(start, start + offset);
 
-	debugInstructions.Add(new InstName(st->id, var->typeString.str));
-
-	uint32 memberOffset = 0;
+	debugInstructions.Add(NewInst<InstName>(st->id, var->typeString.str));
 
 	for (uint64 i = 0; i < var->members.GetCount(); i++) {
 		const StructMember& m = var->members[i];
-		debugInstructions.Add(new InstMemberName(st->id, (uint32)i, m.name.str));
-		annotationIstructions.Add(new InstMemberDecorate(st->id, (uint32)i, THC_SPIRV_DECORATION_OFFSET, &memberOffset, 1));
+		debugInstructions.Add(NewInst<InstMemberName>(st->id, (uint32)i, m.name.str));
+		annotationIstructions.Add(NewInst<InstMemberDecorate>(st->id, (uint32)i, THC_SPIRV_DECORATION_OFFSET, &m.offset, 1));
 
 		if (m.type->type == Type::Matrix) {
 			TypePrimitive* mat = (TypePrimitive*)m.type;
-			uint32 stride = mat->rows * (mat->bits / 8);
-			annotationIstructions.Add(new InstMemberDecorate(st->id, (uint32)i, THC_SPIRV_DECORATION_COL_MAJOR, nullptr, 0));
-			annotationIstructions.Add(new InstMemberDecorate(st->id, (uint32)i, THC_SPIRV_DECORATION_MATRIX_STRIDE, &stride, 1));
+			uint32 stride = mat->GetAlignment();
+			annotationIstructions.Add(NewInst<InstMemberDecorate>(st->id, (uint32)i, THC_SPIRV_DECORATION_COL_MAJOR, nullptr, 0));
+			annotationIstructions.Add(NewInst<InstMemberDecorate>(st->id, (uint32)i, THC_SPIRV_DECORATION_MATRIX_STRIDE, &stride, 1));
+		}
+
+		if (m.isRelaxed) {
+			annotationIstructions.Add(NewInst<InstMemberDecorate>(st->id, (uint32)i, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
 		}
-		
-		memberOffset += m.type->GetSize();
 	}
 
 	var->typeId = st->id;
 
-	annotationIstructions.Add(new InstDecorate(st->id, THC_SPIRV_DECORATION_BLOCK, nullptr, 0));
+	annotationIstructions.Add(NewInst<InstDecorate>(st->id, THC_SPIRV_DECORATION_BLOCK, nullptr, 0));
 
 	if (len) *len += offset;
 
 	return var;
 }
 
+void Compiler::PackStructMembers(List<StructMember>& members) {
+	List<StructMember> packed(members.GetCount());
+
+	uint32 offset = 0;
+
+	//Takes the member needing the least padding, larger alignments first so the smaller members can fill the gaps they leave
+	while (members.GetCount()) {
+		uint64 best = 0;
+		uint32 bestPadding = ~0;
+
+		for (uint64 i = 0; i < members.GetCount(); i++) {
+			const TypeBase* type = members[i].type;
+			const TypeBase* bestType = members[best].type;
+
+			uint32 padding = RoundUp(offset, type->GetAlignment()) - offset;
+
+			if (padding < bestPadding || (padding == bestPadding && (type->GetAlignment() > bestType->GetAlignment() || (type->GetAlignment() == bestType->GetAlignment() && type->GetSize() > bestType->GetSize())))) {
+				best = i;
+				bestPadding = padding;
+			}
+		}
+
+		const TypeBase* type = members[best].type;
+
+		offset = RoundUp(offset, type->GetAlignment()) + type->GetSize();
+
+		packed.Add(members.RemoveAt(best));
+	}
+
+	members = std::move(packed);
+}
+
 Compiler::TypeArray* Compiler::CreateTypeArray(List<Token>& tokens, uint64 start, uint64* len) {
-	TypeArray* var = new TypeArray;
+	TypeBase* elementType = nullptr;
 
 	uint64 offset = 0;
 
 	const Token& token = tokens[start + offset++];
 
 	if (Utils::CompareEnums(token.type, CompareOperation::Or, TokenType::TypeBool, TokenType::TypeInt, TokenType::TypeFloat, TokenType::TypeVector, TokenType::TypeMatrix)) {
-		var->elementType = CreateTypePrimitive(tokens, start, len);
+		elementType = CreateTypePrimitive(tokens, start, len);
 		offset--;
 	} else if (token.type == TokenType::Name) {
-		uint64 index = typeDefinitions.Find<String>(token.string, findStructFunc);
+		elementType = GetStruct(token.string);
 
-		if (index != ~0) {
-			var->elementType = typeDefinitions[index];
-		} else {
+		if (elementType == nullptr) {
 			Log::CompilerError(token, "Unexpected symbol \"%s\" expected valid type", token.string.str);
 		}
 
@@ -515,69 +509,67 @@ Compiler::TypeArray* Compiler::CreateTypeArray(List<Token>& tokens, uint64 start
 		Log::CompilerError(close, "Unexpected symbol \"%s\" expected \"]\"", close.string.str);
 	}
 
-	var->type = Type::Array;
-	var->typeString = GetTypeString(var->elementType) + "[" + count.string + "]";
-	var->elementCount = (uint32)count.value;
-	var->typeId = nullptr;
+	TypeArray key(elementType, (uint32)count.value);
 
-	CheckTypeExist((TypeBase**)&var);
+	TypeArray* var = (TypeArray*)FindType(key);
 
-	tokens.Remove(start, start + offset-1);
+	if (var == nullptr) {
+		var = new TypeArray(elementType, (uint32)count.value);
+		var->typeString = GetTypeString(elementType) + "[" + count.string + "]";
 
-	if (len) *len += offset;
+		InstTypeArray* array = NewInst<InstTypeArray>(CreateConstantS32(var->elementCount), elementType->typeId);
 
-	if (var->typeId != nullptr) {
-		return var;
-	}
+		CheckTypeExist((InstTypeBase**)&array);
 
-	InstTypeArray* array = new InstTypeArray(CreateConstantS32(var->elementCount), var->elementType->typeId);
+		var->typeId = array->id;
 
-	CheckTypeExist((InstTypeBase**)&array);
+		AddType(var);
+	}
+
+	tokens.Remove(start, start + offset-1);
 
-	var->typeId = array->id;
+	if (len) *len += offset;
 
 	return var;
 }
 
 Compiler::TypeImage* Compiler::CreateTypeImage(List<Token>& tokens, uint64 start, uint64* len) {
-	TypeImage* var = new TypeImage;
-	
 	Token& sampler = tokens[start];
 
 	if (!Utils::CompareEnums(sampler.type, CompareOperation::Or, TokenType::TypeImage1D, TokenType::TypeImage2D, TokenType::TypeImage3D, TokenType::TypeImageCube)) {
 		Log::CompilerError(sampler, "uniform must be sampler or buffer");
 	}
 
-	var->type = Type::SampledImage;
-	var->imageType = (ImageType)((uint8)sampler.type - (uint8)TokenType::TypeImage1D);
-	var->depth = 0;
-	var->arrayed = 0;
-	var->multiSampled = 0;
-	var->sampled = 1;
-
-	CheckTypeExist((TypeBase**)&var);
+	ImageType imageType = (ImageType)((uint8)sampler.type - (uint8)TokenType::TypeImage1D);
 
 	tokens.RemoveAt(start);
 
 	if (len) *len += 1;
 
-	if (var->typeId != nullptr) {
+	TypeImage key(imageType, 0, 0, 0, 1);
+
+	TypeImage* var = (TypeImage*)FindType(key);
+
+	if (var != nullptr) {
 		return var;
 	}
 
+	var = new TypeImage(imageType, 0, 0, 0, 1);
 	var->typeString = GetTypeString(var);
 
-	InstTypeImage* image = new InstTypeImage(CreateTypePrimitiveScalar(Type::Float, 32, 0)->typeId, (uint32)var->imageType, var->depth, var->arrayed, var->multiSampled, var->sampled, THC_SPIRV_IMAGE_FORMAT_UNKNOWN);
+	InstTypeImage* image = NewInst<InstTypeImage>(CreateTypePrimitiveScalar(Type::Float, 32, 0)->typeId, (uint32)var->imageType, var->depth, var->arrayed, var->multiSampled, var->sampled, THC_SPIRV_IMAGE_FORMAT_UNKNOWN);
 	
 	CheckTypeExist((InstTypeBase**)&image);
 
-	InstTypeSampledImage* sampledImage = new InstTypeSampledImage(image->id);
+	InstTypeSampledImage* sampledImage = NewInst<InstTypeSampledImage>(image->id);
 
 	CheckTypeExist((InstTypeBase**)&sampledImage);
 
 	var->imageId = image->id;
 	var->typeId = sampledImage->id;
 
+	AddType(var);
+
 	return var;
 }
 
@@ -595,13 +587,13 @@ Compiler::TypeBase* Compiler::CreateType(List<Token>& tokens, uint64 start, uint
 	}
 
 	if (token.type == TokenType::Name) {
-		uint64 index = typeDefinitions.Find<String>(token.string, findStructFunc);
+		TypeStruct* str = GetStruct(token.string);
 
-		if (index != ~0) {
+		if (str != nullptr) {
 			if (arr.type == TokenType::BracketOpen) {
 				return CreateTypeArray(tokens, start, len);
 			} else {
-				return typeDefinitions[index];
+				return str;
 			}
 		}
 	}
@@ -790,6 +782,9 @@ String Compiler::GetTypeString(const TypeBase* const type) const {
 				case THC_SPIRV_STORAGE_CLASS_UNIFORM:
 					name.Append("UNIFORM");
 					break;
+				case THC_SPIRV_STORAGE_CLASS_WORKGROUP:
+					name.Append("WORKGROUP");
+					break;
 				case THC_SPIRV_STORAGE_CLASS_FUNCTION:
 					name.Append("FUNCTION");
 					break;
@@ -840,6 +835,8 @@ uint32 Compiler::ScopeToStorageClass(VariableScope scope) {
 			return THC_SPIRV_STORAGE_CLASS_FUNCTION;
 		case VariableScope::UniformConstant:
 			return THC_SPIRV_STORAGE_CLASS_UNIFORM_CONSTANT;
+		case VariableScope::Workgroup:
+			return THC_SPIRV_STORAGE_CLASS_WORKGROUP;
 	}
 
 	return ~0;
@@ -849,54 +846,44 @@ Compiler::Symbol* Compiler::GetVariable(const String& name, VariableStack* local
 	Symbol* var = localVariables->GetVariable(name);
 
 	if (var == nullptr) {
-		for (uint64 i = 0; i < globalVariables.GetCount(); i++) {
-			Symbol* v = globalVariables[i];
+		Symbol* const* global = globalVariableNames.Get(name);
 
-			if (v->variable.name == name) {
-				var = v;
-				break;
-			}
-		}
+		if (global) var = *global;
 	}
+
 	return var;
 }
 
 bool Compiler::CheckGlobalName(const String& name) const {
-	uint64 index = globalVariables.Find<String>(name, [](Symbol* const& curr, const String& name) -> bool {
-		return curr->variable.name == name;
-	});
-
-	return index == ~0;
+	return globalVariableNames.Get(name) == nullptr;
 }
 
 Compiler::TypePointer* Compiler::CreateTypePointer(const TypeBase* const type, VariableScope scope) {
-	TypePointer* p = new TypePointer;
+	TypePointer key((TypeBase*)type, ScopeToStorageClass(scope));
 
-	p->type = Type::Pointer;
-	p->baseType = (TypeBase*)type;
-	p->storageClass = ScopeToStorageClass(scope);
-	p->typeId = nullptr;
+	TypePointer* p = (TypePointer*)FindType(key);
 
-	CheckTypeExist((TypeBase**)&p);
-
-	if (p->typeId != nullptr) {
+	if (p != nullptr) {
 		return p;
 	}
 
+	p = new TypePointer((TypeBase*)type, key.storageClass);
 	p->typeString = GetTypeString(p);
 
-	InstTypePointer* pointer = new InstTypePointer(p->storageClass, type->typeId);
+	InstTypePointer* pointer = NewInst<InstTypePointer>(p->storageClass, type->typeId);
 
 	CheckTypeExist((InstTypeBase**)&pointer);
 
 	p->typeId = pointer->id;
 
+	AddType(p);
+
 	return p;
 }
 
 Compiler::Symbol* Compiler::CreateGlobalVariable(const TypeBase* const type, VariableScope scope, const String& name) {
 	TypePointer* pointer = CreateTypePointer(type, scope);
-	InstVariable* opVar = new InstVariable(pointer->typeId, pointer->storageClass, 0);
+	InstVariable* opVar = NewInst<InstVariable>(pointer->typeId, pointer->storageClass, 0);
 
 	Symbol* var = new Symbol(SymbolType::Variable, const_cast<TypeBase*>(type), opVar->id);
 	var->variable.scope = scope;
@@ -904,11 +891,13 @@ Compiler::Symbol* Compiler::CreateGlobalVariable(const TypeBase* const type, Var
 	var->variable.isConst = false;
 	var->variable.loadId = nullptr;
 
-	debugInstructions.Add(new InstName(opVar->id, name.str));
+	debugInstructions.Add(NewInst<InstName>(opVar->id, name.str));
 
 	typeInstructions.Add(opVar);
 	globalVariables.Add(var);
 
+	if (CheckGlobalName(name)) globalVariableNames.Set(name, var);
+
 	return var;
 }
 
@@ -917,7 +906,7 @@ Compiler::Symbol* Compiler::CreateLocalVariable(const TypeBase* const type, cons
 	
 
 	TypePointer* pointer = CreateTypePointer(type, VariableScope::Function);
-	InstVariable* opVar = new InstVariable(pointer->typeId, pointer->storageClass, 0);
+	InstVariable* opVar = NewInst<InstVariable>(pointer->typeId, pointer->storageClass, 0);
 
 	Symbol* var = new Symbol(SymbolType::Variable, const_cast<TypeBase*>(type), opVar->id);
 	var->variable.scope = VariableScope::Function;
@@ -925,7 +914,7 @@ Compiler::Symbol* Compiler::CreateLocalVariable(const TypeBase* const type, cons
 	var->variable.isConst = false;
 	var->variable.loadId = nullptr;
 
-	debugInstructions.Add(new InstName(opVar->id, name.str));
+	debugInstructions.Add(NewInst<InstName>(opVar->id, name.str));
 	
 	localVariables->AddVariable(var, opVar);
 
@@ -951,44 +940,42 @@ Compiler::Symbol* Compiler::Cast(TypeBase* castType, TypeBase* currType, ID* ope
 	if (cType->componentType == Type::Int) {
 		if (type->componentType == Type::Int) {
 			if (cType->sign) {
-				operation = new InstSConvert(cType->typeId, operandId);
+				operation = NewInst<InstSConvert>(cType->typeId, operandId);
 			} else {
-				operation = new InstUConvert(cType->typeId, operandId);
+				operation = NewInst<InstUConvert>(cType->typeId, operandId);
 			}
 		} else if (type->componentType == Type::Float) { //Float
 			if (cType->sign) {
-				operation = new InstConvertFToS(cType->typeId, operandId);
+				operation = NewInst<InstConvertFToS>(cType->typeId, operandId);
 			} else {
-				operation = new InstConvertFToU(cType->typeId, operandId);
+				operation = NewInst<InstConvertFToU>(cType->typeId, operandId);
 			}
 		} else { // Bool
 			CAST_ERROR;
 		}
 	} else if (cType->componentType == Type::Float) { //Float
 		if (type->componentType == Type::Float) {
-			operation = new InstFConvert(cType->typeId, operandId);
+			operation = NewInst<InstFConvert>(cType->typeId, operandId);
 		} else if (type->componentType == Type::Int) { //Int
 			if (type->sign) {
-				operation = new InstConvertSToF(cType->typeId, operandId);
+				operation = NewInst<InstConvertSToF>(cType->typeId, operandId);
 			} else {
-				operation = new InstConvertUToF(cType->typeId, operandId);
+				operation = NewInst<InstConvertUToF>(cType->typeId, operandId);
 			}
 		} else { //Bool
 			CAST_ERROR;
 		}
 	} else { //Bool
 		if (type->type == Type::Int) { //Int
-			operation = new InstINotEqual(castType->typeId, operandId, CreateConstant(type, 0U));
+			operation = NewInst<InstINotEqual>(castType->typeId, operandId, CreateConstant(type, 0U));
 		} else if (type->type == Type::Float) { //Float
-			operation = new InstFOrdNotEqual(castType->typeId, operandId, CreateConstant(type, 0.0F));
+			operation = NewInst<InstFOrdNotEqual>(castType->typeId, operandId, CreateConstant(type, 0.0F));
 		} else {
 			CAST_ERROR;
 		}
 	}
 
-	instructions.Add(operation);
-
-	return new Symbol(SymbolType::Result, castType, operation->id);
+	return CreateOperationResult(castType, operation, type);
 }
 
 Compiler::Symbol* Compiler::ImplicitCast(TypeBase* castType, TypeBase* currType, ID* operandId, const Token* t) {
@@ -1040,11 +1027,11 @@ Compiler::Symbol* Compiler::Add(TypeBase* type1, ID* operand1, TypeBase* type2,
 				lType = tmpType;
 			}
 
-			instruction = new InstIAdd(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstIAdd>(lType->typeId, operand1, operand2);
 		} else if (rType->componentType == Type::Float) {
 			ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-			instruction = new InstFAdd(rType->typeId, tmp, operand2);
+			instruction = NewInst<InstFAdd>(rType->typeId, tmp, operand2);
 			lType = rType;
 		}
 	} else if (lType->componentType == Type::Float) {
@@ -1057,17 +1044,15 @@ Compiler::Symbol* Compiler::Add(TypeBase* type1, ID* operand1, TypeBase* type2,
 				lType = rType;
 			}
 
-			instruction = new InstFAdd(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstFAdd>(lType->typeId, operand1, operand2);
 		} else if (rType->componentType == Type::Int) {
 			ID* tmp = ImplicitCastId(lType, rType, operand2, t);
 
-			instruction = new InstFAdd(lType->typeId, operand1, tmp);
+			instruction = NewInst<InstFAdd>(lType->typeId, operand1, tmp);
 		}
 	}
 
-	instructions.Add(instruction);
-
-	return new Symbol(SymbolType::Result, lType, instruction->id);
+	return CreateOperationResult(lType, instruction);
 }
 
 Compiler::Symbol* Compiler::Subtract(TypeBase* type1, ID* operand1, TypeBase* type2, ID* operand2, const Token* t) {
@@ -1100,11 +1085,11 @@ Compiler::Symbol* Compiler::Subtract(TypeBase* type1, ID* operand1, TypeBase* ty
 				lType = tmpType;
 			}
 
-			instruction = new InstISub(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstISub>(lType->typeId, operand1, operand2);
 		} else if (rType->componentType == Type::Float) {
 			ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-			instruction = new InstFSub(rType->typeId, tmp, operand2); 
+			instruction = NewInst<InstFSub>(rType->typeId, tmp, operand2); 
 			lType = rType;
 		}
 	} else if (lType->componentType == Type::Float) {
@@ -1117,17 +1102,15 @@ Compiler::Symbol* Compiler::Subtract(TypeBase* type1, ID* operand1, TypeBase* ty
 				lType = rType;
 			}
 
-			instruction = new InstFSub(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstFSub>(lType->typeId, operand1, operand2);
 		} else if (rType->componentType == Type::Int) {
 			ID* tmp = ImplicitCastId(lType, rType, operand2, t);
 
-			instruction = new InstFSub(lType->typeId, operand1, tmp);
+			instruction = NewInst<InstFSub>(lType->typeId, operand1, tmp);
 		}
 	}
 
-	instructions.Add(instruction);
-
-	return new Symbol(SymbolType::Result, lType, instruction->id);
+	return CreateOperationResult(lType, instruction);
 }
 
 Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* type2, ID* operand2, const Token* t) {
@@ -1142,7 +1125,7 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 
 	if (lType->type == Type::Matrix) {
 		if (*lType == rType) {
-			instruction = new InstMatrixTimesMatrix(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstMatrixTimesMatrix>(lType->typeId, operand1, operand2);
 		} else if (rType->type == Type::Vector && lType->columns == rType->rows) {
 			if (lType->componentType != rType->componentType || lType->bits != rType->bits) {
 				TypePrimitive* tmpType = CreateTypePrimitiveVector(lType->componentType, lType->bits, lType->sign, lType->columns);
@@ -1150,7 +1133,7 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 				rType = tmpType;
 			}
 
-			instruction = new InstMatrixTimesVector((lType = rType)->typeId, operand1, operand2);
+			instruction = NewInst<InstMatrixTimesVector>((lType = rType)->typeId, operand1, operand2);
 		} else {
 			Log::CompilerError(*t, "Invalid operands %s * %s", type1->typeString.str, type2->typeString.str);
 		}
@@ -1168,11 +1151,11 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 						lType = tmpType;
 					}
 
-					instruction = new InstIMul(lType->typeId, operand1, operand2);
+					instruction = NewInst<InstIMul>(lType->typeId, operand1, operand2);
 				} else if (rType->componentType == Type::Float) {
 					ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-					instruction = new InstFMul((lType = rType)->typeId, tmp, operand2);
+					instruction = NewInst<InstFMul>((lType = rType)->typeId, tmp, operand2);
 				}
 			} else if (lType->componentType == Type::Float) {
 				if (rType->componentType == Type::Float) {
@@ -1184,11 +1167,11 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 						lType = rType;
 					}
 
-					instruction = new InstFMul(lType->typeId, operand1, operand2);
+					instruction = NewInst<InstFMul>(lType->typeId, operand1, operand2);
 				} else if (rType->componentType == Type::Int) {
 					ID* tmp = ImplicitCastId(lType, rType, operand2, t);
 
-					instruction = new InstFMul(lType->typeId, operand1, tmp);
+					instruction = NewInst<InstFMul>(lType->typeId, operand1, tmp);
 				}
 			}
 		} else if (rType->type == Type::Matrix && lType->rows == rType->columns) {
@@ -1198,7 +1181,7 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 				lType = tmpType;
 			}
 
-			instruction = new InstVectorTimesMatrix(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstVectorTimesMatrix>(lType->typeId, operand1, operand2);
 		} else if (rType->type == Type::Int) {
 			if (lType->componentType == Type::Int) {
 				if (lType->bits > rType->bits) {
@@ -1211,18 +1194,29 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 					lType = tmpType;
 				}
 
-				instruction = new InstVectorTimesScalar(lType->typeId, operand1, operand2);
+				//OpVectorTimesScalar is float only, splat the scalar and use OpIMul
+				List<ID*> ids;
+
+				for (uint8 i = 0; i < lType->rows; i++) {
+					ids.Add(operand2);
+				}
+
+				TypePrimitive* splatType = CreateTypePrimitiveVector(Type::Int, rType->bits, rType->sign, lType->rows);
+				InstBase* splat = NewInst<InstCompositeConstruct>(splatType->typeId, (uint32)ids.GetCount(), ids.GetData());
+				instructions.Add(splat);
+
+				instruction = NewInst<InstIMul>(lType->typeId, operand1, splat->id);
 			} else if (lType->componentType == Type::Float) {
 				ID* tmp = ImplicitCastId(CreateTypePrimitiveScalar(Type::Float, lType->bits, lType->sign), rType, operand2, t);
 
-				instruction = new InstVectorTimesScalar(lType->typeId, operand1, tmp);
+				instruction = NewInst<InstVectorTimesScalar>(lType->typeId, operand1, tmp);
 			}
 		} else if (rType->type == Type::Float) {
 			if (lType->componentType == Type::Int) {
 				TypePrimitive* tmpType = CreateTypePrimitiveVector(Type::Float, rType->bits, rType->sign, lType->rows);
 				ID* tmp = ImplicitCastId(tmpType, lType, operand1, t);
 
-				instruction = new InstVectorTimesScalar(tmpType->typeId, tmp, operand2);
+				instruction = NewInst<InstVectorTimesScalar>(tmpType->typeId, tmp, operand2);
 				lType = tmpType;
 			} else if (lType->componentType == Type::Float) {
 				if (lType->bits > rType->bits) {
@@ -1235,7 +1229,7 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 					lType = tmpType;
 				}
 
-				instruction = new InstVectorTimesScalar(lType->typeId, operand1, operand2);
+				instruction = NewInst<InstVectorTimesScalar>(lType->typeId, operand1, operand2);
 			}
 		}
 	} else if (lType->type == Type::Int) {
@@ -1248,11 +1242,11 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 				lType = rType;
 			}
 
-			instruction = new InstIMul(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstIMul>(lType->typeId, operand1, operand2);
 		} else if (rType->type == Type::Float) {
 			ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-			instruction = new InstFMul(rType->typeId, tmp, operand2);
+			instruction = NewInst<InstFMul>(rType->typeId, tmp, operand2);
 			lType = rType;
 		} else {
 			Log::CompilerError(*t, "Invalid operands %s * %s", type1->typeString.str, type2->typeString.str);
@@ -1267,19 +1261,17 @@ Compiler::Symbol* Compiler::Multiply(TypeBase* type1, ID* operand1, TypeBase* ty
 				lType = rType;
 			}
 
-			instruction = new InstFMul(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstFMul>(lType->typeId, operand1, operand2);
 		} else if (rType->type == Type::Int) {
 			ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-			instruction = new InstFMul((lType = rType)->typeId, tmp, operand2);
+			instruction = NewInst<InstFMul>((lType = rType)->typeId, tmp, operand2);
 		} else {
 			Log::CompilerError(*t, "Invalid operands %s * %s", type1->typeString.str, type2->typeString.str);
 		}
 	}
 
-	instructions.Add(instruction);
-
-	return new Symbol(SymbolType::Result, lType, instruction->id);
+	return CreateOperationResult(lType, instruction);
 }
 
 Compiler::Symbol* Compiler::Divide(TypeBase* type1, ID* operand1, TypeBase* type2, ID* operand2, const Token* t) {
@@ -1307,15 +1299,15 @@ Compiler::Symbol* Compiler::Divide(TypeBase* type1, ID* operand1, TypeBase* type
 					}
 
 					if (lType->sign) {
-						instruction = new InstUDiv(lType->typeId, operand1, operand2);
+						instruction = NewInst<InstSDiv>(lType->typeId, operand1, operand2);
 					} else {
-						instruction = new InstSDiv(lType->typeId, operand1, operand2);
+						instruction = NewInst<InstUDiv>(lType->typeId, operand1, operand2);
 					}
 					
 				} else if (rType->componentType == Type::Float) {
 					ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-					instruction = new InstFDiv(rType->typeId, tmp, operand2);
+					instruction = NewInst<InstFDiv>(rType->typeId, tmp, operand2);
 					lType = rType;
 				}
 			} else if (lType->componentType == Type::Float) {
@@ -1328,11 +1320,11 @@ Compiler::Symbol* Compiler::Divide(TypeBase* type1, ID* operand1, TypeBase* type
 						lType = rType;
 					}
 
-					instruction = new InstFDiv(lType->typeId, operand1, operand2);
+					instruction = NewInst<InstFDiv>(lType->typeId, operand1, operand2);
 				} else if (rType->componentType == Type::Int) {
 					ID* tmp = ImplicitCastId(lType, rType, operand2, t);
 
-					instruction = new InstFDiv(lType->typeId, operand1, tmp);
+					instruction = NewInst<InstFDiv>(lType->typeId, operand1, tmp);
 				}
 			}
 		} else {
@@ -1351,15 +1343,15 @@ Compiler::Symbol* Compiler::Divide(TypeBase* type1, ID* operand1, TypeBase* type
 			}
 
 			if (lType->sign) {
-				instruction = new InstUDiv(lType->typeId, operand1, operand2);
+				instruction = NewInst<InstSDiv>(lType->typeId, operand1, operand2);
 			} else {
-				instruction = new InstSDiv(lType->typeId, operand1, operand2);
+				instruction = NewInst<InstUDiv>(lType->typeId, operand1, operand2);
 			}
 
 		} else if (rType->type == Type::Float) {
 			ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-			instruction = new InstFDiv(rType->typeId, tmp, operand2);
+			instruction = NewInst<InstFDiv>(rType->typeId, tmp, operand2);
 			lType = rType;
 		} else {
 			Log::CompilerError(*t, "Invalid operands %s * %s", type1->typeString.str, type2->typeString.str);
@@ -1374,20 +1366,18 @@ Compiler::Symbol* Compiler::Divide(TypeBase* type1, ID* operand1, TypeBase* type
 				lType = rType;
 			}
 
-			instruction = new InstFDiv(lType->typeId, operand1, operand2);
+			instruction = NewInst<InstFDiv>(lType->typeId, operand1, operand2);
 		} else if (rType->type == Type::Int) {
 			ID* tmp = ImplicitCastId(rType, lType, operand1, t);
 
-			instruction = new InstFDiv(rType->typeId, tmp, operand2);
+			instruction = NewInst<InstFDiv>(rType->typeId, tmp, operand2);
 			lType = rType;
 		} else {
 			Log::CompilerError(*t, "Invalid operands %s / %s", type1->typeString.str, type2->typeString.str);
 		}
 	}
 
-	instructions.Add(instruction);
-
-	return new Symbol(SymbolType::Result, lType, instruction->id);
+	return CreateOperationResult(lType, instruction);
 }
 
 Compiler::FunctionDeclaration* Compiler::GetFunctionDeclaration(const String& name) {
@@ -1410,7 +1400,7 @@ void Compiler::CreateFunctionType(FunctionDeclaration* decl) {
 		ids.Add(decl->parameters[i]->type->typeId);
 	}
 
-	InstTypeFunction* f = new InstTypeFunction(decl->returnType->typeId, (uint32)ids.GetCount(), ids.GetData());
+	InstTypeFunction* f = NewInst<InstTypeFunction>(decl->returnType->typeId, (uint32)ids.GetCount(), ids.GetData());
 
 	CheckTypeExist((InstTypeBase**)&f);
 
@@ -1427,17 +1417,27 @@ bool Compiler::CheckParameterName(const List<Symbol*>& params, const String& nam
 }
 
 ID* Compiler::CreateConstantBool(bool value) {
-	InstBase* base = nullptr;
-
 	ID* type = CreateTypeBool()->typeId;
 
+	ConstantKey key = { value ? THC_SPIRV_OPCODE_OpConstantTrue : THC_SPIRV_OPCODE_OpConstantFalse, type, nullptr, 0 };
+
+	InstBase* const* existing = constants.Get(key);
+
+	if (existing) {
+		return (*existing)->id;
+	}
+
+	InstBase* base = nullptr;
+
 	if (value) {
-		base = new InstConstantTrue(type);
+		base = NewInst<InstConstantTrue>(type);
 	} else {
-		base = new InstConstantFalse(type);
+		base = NewInst<InstConstantFalse>(type);
 	}
 
-	CheckConstantExist(&base);
+	constants.Set(key, base);
+	constantDefinitions.Set(base->id->id, base);
+	typeInstructions.Add(base);
 
 	return base->id;
 }
@@ -1454,9 +1454,17 @@ ID* Compiler::CreateConstant(const TypeBase* const type, uint32 value) {
 		return nullptr;
 	}
 
-	InstConstant* constant = new InstConstant(type->typeId, value);
+	InstBase* const* existing = constants.Get({ THC_SPIRV_OPCODE_OpConstant, type->typeId, &value, sizeof(uint32) });
+
+	if (existing) {
+		return (*existing)->id;
+	}
+
+	InstConstant* constant = NewInst<InstConstant>(type->typeId, value);
 
-	CheckConstantExist(&constant);
+	constants.Set({ THC_SPIRV_OPCODE_OpConstant, type->typeId, constant->values, sizeof(uint32) }, constant);
+	constantDefinitions.Set(constant->id->id, constant);
+	typeInstructions.Add(constant);
 
 	return constant->id;
 }
@@ -1498,6 +1506,22 @@ ID* Compiler::CreateConstantComposite(const TypeBase* const type, const uint32**
 	return id;
 }
 
+ID* Compiler::CreateConstantComposite(const TypeBase* const type, const List<ID*>& constituents) {
+	InstBase* const* existing = constants.Get({ THC_SPIRV_OPCODE_OpConstantComposite, type->typeId, constituents.GetData(), constituents.GetCount() * sizeof(ID*) });
+
+	if (existing) {
+		return (*existing)->id;
+	}
+
+	InstConstantComposite* composite = NewInst<InstConstantComposite>(type->typeId, (uint32)constituents.GetCount(), constituents.GetData());
+
+	constants.Set({ THC_SPIRV_OPCODE_OpConstantComposite, type->typeId, composite->constituentId, constituents.GetCount() * sizeof(ID*) }, composite);
+	constantDefinitions.Set(composite->id->id, composite);
+	typeInstructions.Add(composite);
+
+	return composite->id;
+}
+
 ID* Compiler::CreateConstantCompositeVector(const TypeBase* const type, const uint32** values) {
 	const TypePrimitive* prim = (const TypePrimitive*)type;
 
@@ -1510,13 +1534,9 @@ ID* Compiler::CreateConstantCompositeVector(const TypeBase* const type, const ui
 		ids.Add(CreateConstant(p, (*values)[i]));
 	}
 
-	*values += prim->columns;
+	*values += prim->rows;
 
-	InstConstantComposite* composite = new InstConstantComposite(type->typeId, prim->rows, ids.GetData());
-
-	CheckConstantExist(&composite);
-
-	return composite->id;
+	return CreateConstantComposite(type, ids);
 }
 
 ID* Compiler::CreateConstantCompositeMatrix(const TypeBase* const type, const uint32** values) {
@@ -1531,11 +1551,7 @@ ID* Compiler::CreateConstantCompositeMatrix(const TypeBase* const type, const ui
 		ids.Add(CreateConstantCompositeVector(p, values));
 	}
 
-	InstConstantComposite* composite = new InstConstantComposite(type->typeId, tmp->columns, ids.GetData());
-
-	CheckConstantExist(&composite);
-
-	return composite->id;
+	return CreateConstantComposite(type, ids);
 }
 
 ID* Compiler::CreateConstantCompositeArray(const TypeBase* const type, const uint32** values) {
@@ -1543,7 +1559,7 @@ ID* Compiler::CreateConstantCompositeArray(const TypeBase* const type, const uin
 
 	List<ID*> ids;
 
-	if (IsTypeComposite(type)) {
+	if (IsTypeComposite(arr->elementType)) {
 		for (uint32 i = 0; i < arr->elementCount; i++) {
 			ids.Add(CreateConstantComposite(arr->elementType, values));
 		}
@@ -1555,11 +1571,7 @@ ID* Compiler::CreateConstantCompositeArray(const TypeBase* const type, const uin
 		*values += arr->elementCount;
 	}
 
-	InstConstantComposite* composite = new InstConstantComposite(type->typeId, arr->elementCount, ids.GetData());
-
-	CheckConstantExist(&composite);
-
-	return composite->id;
+	return CreateConstantComposite(type, ids);
 }
 
 ID* Compiler::CreateConstantCompositeStruct(const TypeBase* const type, const uint32** values) {
@@ -1578,11 +1590,7 @@ ID* Compiler::CreateConstantCompositeStruct(const TypeBase* const type, const ui
 		}
 	}
 
-	InstConstantComposite* composite = new InstConstantComposite(type->typeId, (uint32)ids.GetCount(), ids.GetData());
-
-	CheckConstantExist(&composite);
-
-	return composite->id;
+	return CreateConstantComposite(type, ids);
 }
 
 bool Compiler::IsTypeComposite(const TypeBase* const type) const {
@@ -1623,12 +1631,16 @@ void Compiler::ProcessName(Token& t) const {
 		{"return",   TokenType::ControlFlowReturn, 0, 0, 0, 0},
 
 		{"const",    TokenType::ModifierConst, 0, 0, 0, 0},
+		{"highp",    TokenType::ModifierHighp, 0, 0, 0, 0},
+		{"mediump",  TokenType::ModifierMediump, 0, 0, 0, 0},
+		{"lowp",     TokenType::ModifierLowp, 0, 0, 0, 0},
 
 		{"struct",   TokenType::DataStruct, 0, 0, 0, 0},
 		{"layout",   TokenType::DataLayout, 0, 0, 0, 0},
 		{"in",       TokenType::DataIn, 0, 0, 0, 0},
 		{"out",      TokenType::DataOut, 0, 0, 0, 0},
 		{"uniform",  TokenType::DataUniform, 0, 0, 0, 0},
+		{"shared",   TokenType::DataShared, 0, 0, 0, 0},
 
 		{"void", TokenType::TypeVoid, 0, 0, 0, 0},
 		{"bool", TokenType::TypeBool, 0, 0, 0, 0},
@@ -1665,6 +1677,9 @@ void Compiler::ProcessName(Token& t) const {
 	for (uint64 i = 0; i < sizeof(props) / sizeof(TokenProperties); i++) {
 		const TokenProperties& tmp = props[i];
 		if (t.string == tmp.name) {
+			//Workgroup memory only exists in compute shaders, the other stages can use shared as a name
+			if (tmp.type == TokenType::DataShared && !CompilerOptions::ComputeShader()) break;
+
 			t.type = tmp.type;
 			t.bits = tmp.bits;
 			t.sign = tmp.sign;
@@ -1693,6 +1708,25 @@ uint64 Compiler::FindMatchingToken(const List<Token>& tokens, uint64 start, Toke
 	return ~0;
 }
 
+bool Compiler::ParsePrecision(List<Token>& tokens, uint64 index) {
+	if (index >= tokens.GetCount()) return false;
+
+	TokenType precision = tokens[index].type;
+
+	if (!Utils::CompareEnums(precision, CompareOperation::Or, TokenType::ModifierHighp, TokenType::ModifierMediump, TokenType::ModifierLowp)) return false;
+
+	const Token& type = tokens[index + 1];
+
+	if (!Utils::CompareEnums(type.type, CompareOperation::Or, TokenType::TypeFloat, TokenType::TypeInt, TokenType::TypeVector, TokenType::TypeMatrix)) {
+		Log::CompilerError(type, "Precision qualifiers can only be used on integer or float scalars, vectors and matrices");
+	}
+
+	tokens.RemoveAt(index);
+
+	//SPIR-V only has full and relaxed precision, so lowp is the same as mediump
+	return precision != TokenType::ModifierHighp;
+}
+
 ID* Compiler::GetExpressionOperandId(const Expression* e, TypePrimitive** type, bool swizzle, ID** ogID) {
 	ID* id = nullptr;
 
@@ -1726,7 +1760,7 @@ ID* Compiler::LoadVariable(Symbol* var, bool usePreviousLoad) {
 		return var->variable.loadId;
 	}
 
-	InstLoad* load = new InstLoad(var->type->typeId, var->id, 0);
+	InstLoad* load = NewInst<InstLoad>(var->type->typeId, var->id, 0);
 	instructions.Add(load);
 
 	return var->variable.loadId = load->id;
@@ -1738,7 +1772,7 @@ void Compiler::StoreVariable(Symbol* var, ID* storeId, bool setAsLoadId) {
 	} else if (setAsLoadId) {
 		var->variable.loadId = storeId;
 	} else {
-		InstStore* store = new InstStore(var->id, storeId, 0);
+		InstStore* store = NewInst<InstStore>(var->id, storeId, 0);
 		instructions.Add(store);
 
 		var->variable.loadId = nullptr;
@@ -1808,13 +1842,13 @@ ID* Compiler::GetSwizzledVector(TypePrimitive** type, ID* load, const List<uint3
 
 	if (indices.GetCount() == 1) {
 		t = CreateTypePrimitiveScalar(t->componentType, t->bits, t->sign);
-		InstBase* inst = new InstCompositeExtract(t->typeId, load, 1, indices.GetData());
+		InstBase* inst = NewInst<InstCompositeExtract>(t->typeId, load, 1, indices.GetData());
 		instructions.Add(inst);
 		id = inst->id;
 	} else if (indices.GetCount() > 1) {
 		uint32 rows = (uint32)indices.GetCount();
 		t = CreateTypePrimitiveVector(t->componentType, t->bits, t->sign, rows);
-		InstBase* inst = new InstVectorShuffle(t->typeId, load, load, rows, indices.GetData());
+		InstBase* inst = NewInst<InstVectorShuffle>(t->typeId, load, load, rows, indices.GetData());
 		instructions.Add(inst);
 		id = inst->id;
 	}
@@ -52,6 +52,8 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 	uint32 location = ~0;
 	uint32 binding = ~0;
 	uint32 set = ~0;
+	uint32 constantId = ~0;
+	uint32 size[3] = { ~0U, ~0U, ~0U };
 
 	auto GetValue = [&tokens, &offset, start]() -> uint32 {
 		const Token& equal = tokens[start + offset++];
@@ -72,8 +74,8 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 	while (true) {
 		const Token& specifier = tokens[start + offset++];
 
-		if (specifier.type != TokenType::Name && !(specifier.string == "location" || specifier.string == "set" || specifier.string == "binding")) {
-			Log::CompilerError(specifier, "Unexpected symbol \"%s\" expected \"location, set or binding\"", specifier.string.str);
+		if (specifier.type != TokenType::Name && !(specifier.string == "location" || specifier.string == "set" || specifier.string == "binding" || specifier.string == "constant_id" || specifier.string == "local_size_x" || specifier.string == "local_size_y" || specifier.string == "local_size_z")) {
+			Log::CompilerError(specifier, "Unexpected symbol \"%s\" expected \"location, set, binding, constant_id or local_size_x/y/z\"", specifier.string.str);
 		}
 
 		if (specifier.string == "location") {
@@ -94,6 +96,24 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 			}
 
 			set = GetValue();
+		} else if (specifier.string == "constant_id") {
+			if (constantId != ~0) {
+				Log::CompilerError(specifier, "Specifier \"constant_id\" already specified once");
+			}
+
+			constantId = GetValue();
+		} else if (specifier.string == "local_size_x" || specifier.string == "local_size_y" || specifier.string == "local_size_z") {
+			uint32 axis = specifier.string[11] - 'x';
+
+			if (size[axis] != ~0) {
+				Log::CompilerError(specifier, "Specifier \"%s\" already specified once", specifier.string.str);
+			}
+
+			size[axis] = GetValue();
+
+			if (size[axis] == 0) {
+				Log::CompilerError(specifier, "Specifier \"%s\" must be greater than 0", specifier.string.str);
+			}
 		}
 
 		const Token& next = tokens[start + offset++];
@@ -111,7 +131,50 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 
 	VariableScope varScope = VariableScope::None;
 
+	bool hasSize = size[0] != ~0 || size[1] != ~0 || size[2] != ~0;
+
+	if (hasSize) {
+		//"layout (local_size_x = 8, local_size_y = 8) in;" declares no variable, it only sets the workgroup size
+		const Token& semiColon = tokens[start + offset];
+
+		if (semiColon.type == TokenType::SemiColon) offset++;
+
+		if (scope.type != TokenType::DataIn || semiColon.type != TokenType::SemiColon) {
+			Log::CompilerError(scope, "Specifier \"local_size\" can only be used as \"layout (local_size_x = x, ...) in;\"");
+		} else if (location != ~0 || binding != ~0 || set != ~0 || constantId != ~0) {
+			Log::CompilerError(scope, "Specifier \"local_size\" can't be combined with other specifiers");
+		} else if (!CompilerOptions::ComputeShader()) {
+			Log::CompilerError(scope, "Specifier \"local_size\" can only be used in a compute shader");
+		}
+
+		for (uint32 i = 0; i < 3; i++) {
+			if (size[i] != ~0) localSize[i] = size[i];
+		}
+
+		start--;
+
+		tokens.Remove(start, start + offset - 1);
+		return;
+	}
+
+	if (constantId != ~0 && scope.type != TokenType::ModifierConst) {
+		Log::CompilerError(scope, "Specifier \"constant_id\" can only be used on \"const\"");
+	}
+
 	switch (scope.type) {
+		case TokenType::ModifierConst:
+			if (constantId == ~0) {
+				Log::CompilerError(scope, "Specifier \"constant_id\" must be set");
+			} else if (location != ~0 || binding != ~0 || set != ~0) {
+				Log::CompilerError(scope, "Specifier \"constant_id\" can't be combined with other specifiers");
+			}
+
+			//Only the layout is removed, the rest is a normal global constant
+			start--;
+			tokens.Remove(start, start + offset - 1);
+
+			ParseGlobalVariable(tokens, start, constantId);
+			return;
 		case TokenType::DataIn:
 			varScope = VariableScope::In;
 
@@ -149,7 +212,7 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 
 			break;
 		default:
-			Log::CompilerError(scope, "Unexpected symbol \"%s\" expected \"in, out or uniform\"", scope.string.str);
+			Log::CompilerError(scope, "Unexpected symbol \"%s\" expected \"in, out, uniform or const\"", scope.string.str);
 	}
 
 	Symbol* var;
@@ -179,15 +242,26 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 			name = next.string;
 			varScope = VariableScope::UniformConstant;
 		} else {
-			t = CreateTypeStruct(tokens, start + offset++, nullptr);
+			t = CreateTypeStruct(tokens, start + offset++, nullptr, true);
 
 			name = t->typeString;
+
+			if (CompilerOptions::PackUniforms()) {
+				BlockLayout layout;
+
+				layout.name = name;
+				layout.binding = binding;
+				layout.set = set;
+				layout.type = (TypeStruct*)t;
+
+				blockLayouts.Add(layout);
+			}
 		}
 
 		var = CreateGlobalVariable(t, varScope, name);
 
-		annotationIstructions.Add(new InstDecorate(var->id, THC_SPIRV_DECORATION_BINDING, &binding, 1));
-		annotationIstructions.Add(new InstDecorate(var->id, THC_SPIRV_DECORATION_DESCRIPTORSET, &set, 1));
+		annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_BINDING, &binding, 1));
+		annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_DESCRIPTORSET, &set, 1));
 
 		if (locations.Find(MAKE_UNIFORM(binding, set)) != ~0) {
 			Log::CompilerWarning(tmp, "\"layout (binding = %u, set = %u) uniform\" already used", binding, set);
@@ -196,6 +270,8 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 		}
 
 	} else {
+		bool relaxed = ParsePrecision(tokens, start + offset);
+
 		TypePrimitive* type = CreateTypePrimitive(tokens, start + offset, nullptr);
 
 		const Token& name = tokens[start + offset++];
@@ -216,7 +292,12 @@ void Compiler::ParseLayout(List<Token>& tokens, uint64 start) {
 
 		var = CreateGlobalVariable(type, varScope, name.string);
 
-		annotationIstructions.Add(new InstDecorate(var->id, THC_SPIRV_DECORATION_LOCATION, &location, 1));
+		annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_LOCATION, &location, 1));
+
+		if (relaxed) {
+			var->variable.isRelaxed = true;
+			annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
+		}
 
 		if (varScope == VariableScope::In) {
 			if (locations.Find(MAKE_LOCATION(1, location)) != ~0) {
@@ -276,13 +357,65 @@ void Compiler::ParseInOut(List<Token>& tokens, uint64 start, VariableScope scope
 	tokens.Remove(start, start + offset);
 }
 
+void Compiler::ParseShared(List<Token>& tokens, uint64 start) {
+	uint64 offset = 0;
+
+	const Token shared = tokens[start];
+
+	if (!CompilerOptions::ComputeShader()) {
+		Log::CompilerError(shared, "\"shared\" can only be used in a compute shader");
+	}
+
+	bool relaxed = ParsePrecision(tokens, ++start + offset);
+
+	const Token& tmp = tokens[start + offset];
+
+	TypeBase* type = CreateType(tokens, start + offset, nullptr);
+
+	if (type == nullptr) {
+		Log::CompilerError(tmp, "Unexpected symbol \"%s\" expected a valid type", tmp.string.str);
+		tokens.RemoveAt(--start);
+		return;
+	}
+
+	const Token& name = tokens[start + offset++];
+
+	if (name.type != TokenType::Name) {
+		Log::CompilerError(name, "Unexpected symbol \"%s\" expected a valid name", name.string.str);
+	}
+
+	if (!CheckGlobalName(name.string)) {
+		Log::CompilerError(name, "Redefinition of global variable \"%s\"", name.string.str);
+	}
+
+	const Token& semi = tokens[start + offset++];
+
+	if (semi.type == TokenType::BracketOpen) {
+		Log::CompilerError(semi, "Array size goes after the type \"%s[n] %s;\"", type->typeString.str, name.string.str);
+	} else if (semi.type != TokenType::SemiColon) {
+		Log::CompilerError(semi, "Unexpected symbol \"%s\" expected \";\" workgroup variables can't be initialized", semi.string.str);
+	}
+
+	Symbol* var = CreateGlobalVariable(type, VariableScope::Workgroup, name.string);
+
+	if (relaxed) {
+		var->variable.isRelaxed = true;
+		annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_RELAXED_PRECISION, nullptr, 0));
+	}
+
+	start--;
+
+	tokens.Remove(start, start + offset);
+}
+
 void Compiler::CheckIntrin(const Token& token, const Symbol* var) {
 	THC_ASSERT(var->symbolType == SymbolType::Variable);
 
 	enum class Stage {
 		Vertex,
 		Fragment,
-		Geometry
+		Geometry,
+		Compute
 	};
 
 	struct Intrin {
@@ -293,18 +426,23 @@ void Compiler::CheckIntrin(const Token& token, const Symbol* var) {
 	};
 
 	static Intrin intrins[] = {
-	{ "THSL_Position",     VariableScope::Out, Stage::Vertex,   THC_SPIRV_BUILTIN_POSITION     },
-	{ "THSL_PointSize",    VariableScope::Out, Stage::Vertex,   THC_SPIRV_BUILTIN_POINT_SIZE   },
-	{ "THSL_VertexId",     VariableScope::In,  Stage::Vertex,   THC_SPIRV_BUILTIN_VERTEX_ID    },
-	{ "THSL_InstanceId",   VariableScope::In,  Stage::Vertex,   THC_SPIRV_BUILTIN_INSTANCE_ID  },
-	{ "THSL_FragCoord",    VariableScope::In,  Stage::Fragment, THC_SPIRV_BUILTIN_FRAG_COORD   },
-	{ "THSL_PointCoord",   VariableScope::In,  Stage::Fragment, THC_SPIRV_BUILTIN_POINT_COORD  },
-	{ "THSL_FrontFacing",  VariableScope::In,  Stage::Fragment, THC_SPIRV_BUILTIN_FRONT_FACING },
-	{ "THSL_FragDepth",    VariableScope::Out, Stage::Fragment, THC_SPIRV_BUILTIN_FRAG_DEPTH   }
+	{ "THSL_Position",             VariableScope::Out, Stage::Vertex,   THC_SPIRV_BUILTIN_POSITION               },
+	{ "THSL_PointSize",            VariableScope::Out, Stage::Vertex,   THC_SPIRV_BUILTIN_POINT_SIZE             },
+	{ "THSL_VertexId",             VariableScope::In,  Stage::Vertex,   THC_SPIRV_BUILTIN_VERTEX_ID              },
+	{ "THSL_InstanceId",           VariableScope::In,  Stage::Vertex,   THC_SPIRV_BUILTIN_INSTANCE_ID            },
+	{ "THSL_FragCoord",            VariableScope::In,  Stage::Fragment, THC_SPIRV_BUILTIN_FRAG_COORD             },
+	{ "THSL_PointCoord",           VariableScope::In,  Stage::Fragment, THC_SPIRV_BUILTIN_POINT_COORD            },
+	{ "THSL_FrontFacing",          VariableScope::In,  Stage::Fragment, THC_SPIRV_BUILTIN_FRONT_FACING           },
+	{ "THSL_FragDepth",            VariableScope::Out, Stage::Fragment, THC_SPIRV_BUILTIN_FRAG_DEPTH             },
+	{ "THSL_NumWorkGroups",        VariableScope::In,  Stage::Compute,  THC_SPIRV_BUILTIN_NUM_WORKGROUPS         },
+	{ "THSL_WorkGroupId",          VariableScope::In,  Stage::Compute,  THC_SPIRV_BUILTIN_WORKGROUP_ID           },
+	{ "THSL_LocalInvocationId",    VariableScope::In,  Stage::Compute,  THC_SPIRV_BUILTIN_LOCAL_INVOCATION_ID    },
+	{ "THSL_GlobalInvocationId",   VariableScope::In,  Stage::Compute,  THC_SPIRV_BUILTIN_GLOBAL_INVOCATION_ID   },
+	{ "THSL_LocalInvocationIndex", VariableScope::In,  Stage::Compute,  THC_SPIRV_BUILTIN_LOCAL_INVOCATION_INDEX }
 	};
 
 	uint64 len = sizeof(intrins) / sizeof(Intrin);
-	Stage stage = CompilerOptions::VertexShader() ? Stage::Vertex : Stage::Fragment;
+	Stage stage = CompilerOptions::VertexShader() ? Stage::Vertex : CompilerOptions::FragmentShader() ? Stage::Fragment : Stage::Compute;
 
 	for (uint64 i = 0; i < len; i++) {
 		Intrin& intr = intrins[i];
@@ -313,10 +451,10 @@ void Compiler::CheckIntrin(const Token& token, const Symbol* var) {
 			if (intr.scope != var->variable.scope) {
 				Log::CompilerError(token, "Builtin %s must be an %s variable", intr.name.str, intr.scope == VariableScope::Out ? "output" : "input");
 			} else if (intr.stage != stage) {
-				Log::CompilerError(token, "Builtin %s cannot be used in %s", intr.name.str, stage == Stage::Vertex ? "Vertex" : "Fragment");
+				Log::CompilerError(token, "Builtin %s cannot be used in %s", intr.name.str, stage == Stage::Vertex ? "Vertex" : stage == Stage::Fragment ? "Fragment" : "Compute");
 			}
 
-			annotationIstructions.Add(new InstDecorate(var->id, THC_SPIRV_DECORATION_BUILTIN, &intr.builtin, 1));
+			annotationIstructions.Add(NewInst<InstDecorate>(var->id, THC_SPIRV_DECORATION_BUILTIN, &intr.builtin, 1));
 			return;
 		}
 	}
@@ -42,6 +42,15 @@ bool Compiler::TypeBase::operator!=(const TypeBase* const other) const {
 	return !operator==(other);
 }
 
+uint64 Compiler::TypeBase::Hash() const {
+	return HashCombine(0, (uint64)type);
+}
+
+Compiler::TypePrimitive::TypePrimitive(Type type, Type componentType, uint8 bits, uint8 sign, uint8 rows, uint8 columns) : componentType(componentType), bits(bits), sign(sign), rows(rows), columns(columns) {
+	this->type = type;
+	this->typeId = nullptr;
+}
+
 bool Compiler::TypePrimitive::operator==(const TypeBase* const other) const {
 	if (other->type == type) {
 		const TypePrimitive* t = (const TypePrimitive*)other;
@@ -56,6 +65,14 @@ bool Compiler::TypePrimitive::operator!=(const TypeBase* const other) const {
 	return !operator==(other);
 }
 
+uint64 Compiler::TypePrimitive::Hash() const {
+	uint64 hash = HashCombine(TypeBase::Hash(), (uint64)componentType);
+
+	hash = HashCombine(HashCombine(hash, bits), sign);
+
+	return HashCombine(HashCombine(hash, rows), columns);
+}
+
 bool Compiler::StructMember::operator==(const StructMember& other) const {
 	return *type == other.type;
 }
@@ -66,13 +83,7 @@ bool Compiler::StructMember::operator!=(const StructMember& other) const {
 
 bool Compiler::TypeStruct::operator==(const TypeBase* const other) const {
 	if (other->type == type) {
-		const TypeStruct* t = (const TypeStruct*)other;
-
-		for (uint64 i = 0; i < members.GetCount(); i++) {
-			if (!(members[i] == t->members[i])) return false;
-		}
-
-		return true;
+		return typeString == other->typeString;
 	}
 
 	return false;
@@ -82,6 +93,15 @@ bool Compiler::TypeStruct::operator!=(const TypeBase* const other) const {
 	return !operator==(other);
 }
 
+uint64 Compiler::TypeStruct::Hash() const {
+	return HashBytes(typeString.str, typeString.length, TypeBase::Hash());
+}
+
+Compiler::TypeArray::TypeArray(TypeBase* elementType, uint32 elementCount) : elementCount(elementCount), elementType(elementType) {
+	this->type = Type::Array;
+	this->typeId = nullptr;
+}
+
 bool Compiler::TypeArray::operator==(const TypeBase* const other) const {
 	if (other->type == type) {
 		const TypeArray* t = (const TypeArray*)other;
@@ -96,6 +116,15 @@ bool Compiler::TypeArray::operator!=(const TypeBase* const other) const {
 	return !operator==(other);
 }
 
+uint64 Compiler::TypeArray::Hash() const {
+	return HashCombine(HashCombine(TypeBase::Hash(), elementCount), elementType->Hash());
+}
+
+Compiler::TypePointer::TypePointer(TypeBase* baseType, uint32 storageClass) : baseType(baseType), storageClass(storageClass) {
+	this->type = Type::Pointer;
+	this->typeId = nullptr;
+}
+
 bool Compiler::TypePointer::operator==(const TypeBase* const other) const {
 	if (other->type == type) {
 		const TypePointer* t = (const TypePointer*)other;
@@ -110,6 +139,15 @@ bool Compiler::TypePointer::operator!=(const TypeBase* const other) const {
 	return !operator==(other);
 }
 
+uint64 Compiler::TypePointer::Hash() const {
+	return HashCombine(HashCombine(TypeBase::Hash(), storageClass), baseType->Hash());
+}
+
+Compiler::TypeImage::TypeImage(ImageType imageType, uint8 depth, uint8 arrayed, uint8 multiSampled, uint8 sampled) : imageType(imageType), depth(depth), arrayed(arrayed), multiSampled(multiSampled), sampled(sampled), imageId(nullptr) {
+	this->type = Type::SampledImage;
+	this->typeId = nullptr;
+}
+
 bool Compiler::TypeImage::operator==(const TypeBase* const other) const {
 	if (other->type == type) {
 		const TypeImage* t = (const TypeImage*)other;
@@ -124,6 +162,12 @@ bool Compiler::TypeImage::operator!=(const TypeBase* const other) const {
 	return !operator==(other);
 }
 
+uint64 Compiler::TypeImage::Hash() const {
+	uint64 hash = HashCombine(HashCombine(TypeBase::Hash(), (uint64)imageType), depth);
+
+	return HashCombine(HashCombine(HashCombine(hash, arrayed), multiSampled), sampled);
+}
+
 /*bool Compiler::TypeFunction::operator==(const TypeBase* const other) const {
 	if (other->type == type) {
 		const TypeFunction* t = (const TypeFunction*)other;
@@ -167,19 +211,45 @@ uint32 Compiler::TypePrimitive::GetSize() const {
 		case Type::Vector:
 			return rows * (bits >> 3);
 		case Type::Matrix:
-			return rows * columns * (bits >> 3);
+			return columns * GetAlignment();
+	}
+
+	return ~0;
+}
+
+uint32 Compiler::TypePrimitive::GetAlignment() const {
+	switch (type) {
+		case Type::Int:
+		case Type::Float:
+			return bits >> 3;
+		case Type::Vector:
+			return (rows == 2 ? 2 : 4) * (bits >> 3);
+		case Type::Matrix:
+			//Columns are aligned like vectors in an array
+			return RoundUp((rows == 2 ? 2 : 4) * (bits >> 3), 16);
 	}
 
 	return ~0;
 }
 
 uint32 Compiler::TypeStruct::GetSize() const {
-	uint32 total = 0;
+	if (members.GetCount() == 0) return 0;
+
+	const StructMember& last = members[members.GetCount() - 1];
+
+	return RoundUp(last.offset + last.type->GetSize(), GetAlignment());
+}
+
+uint32 Compiler::TypeStruct::GetAlignment() const {
+	uint32 alignment = 16;
+
 	for (uint64 i = 0; i < members.GetCount(); i++) {
-		total += members[i].type->GetSize();
+		uint32 member = members[i].type->GetAlignment();
+
+		if (member > alignment) alignment = member;
 	}
 
-	return total;
+	return alignment;
 }
 
 uint32 Compiler::TypeStruct::GetMemberIndex(const String& name) {
@@ -191,7 +261,11 @@ uint32 Compiler::TypeStruct::GetMemberIndex(const String& name) {
 }
 
 uint32 Compiler::TypeArray::GetSize() const {
-	return elementCount * elementType->GetSize();
+	return elementCount * RoundUp(elementType->GetSize(), GetAlignment());
+}
+
+uint32 Compiler::TypeArray::GetAlignment() const {
+	return RoundUp(elementType->GetAlignment(), 16);
 }
 
 }
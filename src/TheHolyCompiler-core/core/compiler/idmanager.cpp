@@ -30,29 +30,24 @@ namespace compiler {
 
 using namespace utils;
 
-List<ID*> IDManager::free;
-List<ID*> IDManager::ids;
+#define THC_ID_CHUNK_SIZE 256
 
-ID* IDManager::GetNewId() {
-	ID* newId = nullptr;
-
-	if (free.GetCount() != 0) {
-		newId = free.RemoveAt(0);
-	} else {
-		newId = new ID(GetCount()+1);
-		ids.Add(newId);
+IDAllocator::~IDAllocator() {
+	for (uint64 i = 0; i < chunks.GetCount(); i++) {
+		delete[] chunks[i];
 	}
-
-	return newId;
 }
 
-void IDManager::RemoveId(ID* id) {
-	free.Add(id);
-	ids.Remove(id);
-}
+ID* IDAllocator::Allocate() {
+	uint32 index = count % THC_ID_CHUNK_SIZE;
+
+	if (index == 0) chunks.Add(new ID[THC_ID_CHUNK_SIZE]);
+
+	ID* id = chunks[chunks.GetCount() - 1] + index;
+
+	id->id = ++count;
 
-uint32 IDManager::GetCount() {
-	return (uint32)ids.GetCount();
+	return id;
 }
 
 }
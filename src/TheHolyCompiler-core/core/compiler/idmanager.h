@@ -34,18 +34,24 @@ class ID {
 public:
 	uint32 id;
 
+	ID() : id(0) { }
 	ID(uint32 id) : id(id) { }
 };
 
-class IDManager {
+//Hands out the ids of one module, every compiler owns one. Ids are dense and stored in chunks so their addresses never change
+class IDAllocator {
 private:
-	static utils::List<ID*> free;
-	static utils::List<ID*> ids;
+	utils::List<ID*> chunks;
+	uint32 count;
 
 public:
-	static ID* GetNewId();
-	static void RemoveId(ID* id);
-	static uint32 GetCount();
+	IDAllocator() : chunks(16), count(0) {}
+	IDAllocator(const IDAllocator& other) = delete;
+	~IDAllocator();
+
+	ID* Allocate();
+
+	inline uint32 GetCount() const { return count; }
 };
 
 }
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "compiler.h"
 #include <util/log.h>
+#include <stdlib.h>
 
 namespace thc {
 namespace core {
@@ -45,11 +46,20 @@ bool CompilerOptions::int64 = false;
 bool CompilerOptions::implicitConversions = true;
 bool CompilerOptions::vertexShader = false;
 bool CompilerOptions::fragmentShader = false;
+bool CompilerOptions::computeShader = false;
+bool CompilerOptions::optimize = false;
+uint32 CompilerOptions::inlineThreshold = 32;
+bool CompilerOptions::fastMath = false;
+bool CompilerOptions::link = false;
+bool CompilerOptions::packVaryings = false;
+bool CompilerOptions::packUniforms = false;
 
 List<String> CompilerOptions::includeDirectories;
 List<String> CompilerOptions::defines;
 String CompilerOptions::inputFile;
 String CompilerOptions::outputFile;
+String CompilerOptions::recompileFile;
+String CompilerOptions::linkFile;
 
 bool CompilerOptions::ParseOptions(uint32 argc, char** argv) {
 	List<String> args;
@@ -79,12 +89,29 @@ bool CompilerOptions::ParseOptions(const List<String>& args) {
 		else if (arg == "-moIMP") implicitConversions = false;
 		else if (arg == "-vertex") vertexShader = true;
 		else if (arg == "-fragment") fragmentShader = true;
+		else if (arg == "-compute") computeShader = true;
+		else if (arg == "-O") optimize = true;
+		else if (arg == "-fastmath") fastMath = true;
+		else if (arg == "-link") link = true;
+		else if (arg == "-packvaryings") packVaryings = true;
+		else if (arg == "-packuniforms") packUniforms = true;
 		else if (arg.StartsWith("-D=")) {
 			arg.Remove(0, 2);
 			defines.Add(arg.Split(","));
 		} else if (arg.StartsWith("-I=")) {
 			arg.Remove(0, 2);
 			includeDirectories.Add(arg.Split(","));
+		} else if (arg.StartsWith("-inline=")) {
+			arg.Remove(0, 7);
+
+			char* end = nullptr;
+
+			inlineThreshold = (uint32)strtoul(arg.str, &end, 10);
+
+			if (arg.length == 0 || *end != 0) {
+				Log::Error("Invalid inline threshold \"%s\"", arg.str);
+				return false;
+			}
 		} else if (arg.StartsWith("-out=")) {
 			arg.Remove(0, 4);
 			
@@ -94,18 +121,49 @@ bool CompilerOptions::ParseOptions(const List<String>& args) {
 			}
 
 			outputFile = arg;
+		} else if (arg.StartsWith("-recompile=")) {
+			arg.Remove(0, 10);
+
+			recompileFile = arg;
+		} else if (inputFile.length == 0) {
+			inputFile = arg;
 		} else {
-			if (inputFile.length != 0) {
+			if (linkFile.length != 0) {
 				Log::Error("Input file already specified");
 				return false;
 			}
 
-			inputFile = arg;
+			//Only valid with -link, checked when all options are known
+			linkFile = arg;
+		}
+	}
+
+	if (packVaryings && !link) {
+		Log::Error("-packvaryings changes both stages and can only be used with -link");
+		return false;
+	}
+
+	if (link) {
+		if (vertexShader || fragmentShader || computeShader) {
+			Log::Error("-link compiles a vertex and a fragment stage, -vertex, -fragment and -compute can't be used with it");
+			return false;
+		}
+
+		if (linkFile.length == 0) {
+			Log::Error("-link needs a vertex and a fragment input file");
+			return false;
 		}
+
+		return true;
+	}
+
+	if (linkFile.length != 0) {
+		Log::Error("Input file already specified");
+		return false;
 	}
 
-	if (vertexShader == fragmentShader) {
-		Log::Error("Only one of -fragment or -vertex must be specified");
+	if (vertexShader + fragmentShader + computeShader != 1) {
+		Log::Error("Only one of -fragment, -vertex or -compute must be specified");
 		return false;
 	}
 
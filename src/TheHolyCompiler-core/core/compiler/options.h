@@ -31,6 +31,9 @@ namespace compiler {
 
 class CompilerOptions {
 private:
+	friend class Compiler;
+
+
 	static bool warningsMessages;
 	static bool debugMessages;
 	static bool debugInformation;
@@ -45,11 +48,20 @@ private:
 	static bool implicitConversions;
 	static bool vertexShader;
 	static bool fragmentShader;
+	static bool computeShader;
+	static bool optimize;
+	static uint32 inlineThreshold;
+	static bool fastMath;
+	static bool link;
+	static bool packVaryings;
+	static bool packUniforms;
 
 	static utils::List<utils::String> includeDirectories;
 	static utils::List<utils::String> defines;
 	static utils::String inputFile;
 	static utils::String outputFile;
+	static utils::String recompileFile;
+	static utils::String linkFile;
 
 public:
 	static bool ParseOptions(uint32 argc, char** argv);
@@ -70,11 +82,20 @@ public:
 	inline static bool ImplicitConversions() { return implicitConversions; }
 	inline static bool VertexShader() { return vertexShader; }
 	inline static bool FragmentShader() { return fragmentShader; }
+	inline static bool ComputeShader() { return computeShader; }
+	inline static bool Optimize() { return optimize; }
+	inline static uint32 InlineThreshold() { return inlineThreshold; }
+	inline static bool FastMath() { return fastMath; }
+	inline static bool Link() { return link; }
+	inline static bool PackVaryings() { return packVaryings; }
+	inline static bool PackUniforms() { return packUniforms; }
 
 	inline static const utils::List<utils::String>& IncludeDirectories() { return includeDirectories; }
 	inline static const utils::List<utils::String>& PredefinedDefines() { return defines; }
 	inline static const utils::String& InputFile() { return inputFile; }
 	inline static const utils::String& OutputFile() { return outputFile; }
+	inline static const utils::String& RecompileFile() { return recompileFile; }
+	inline static const utils::String& LinkFile() { return linkFile; }
 };
 
 }
@@ -44,7 +44,7 @@ public:
 	compiler::ID* operand2;
 
 
-	InstExt(uint32 wordCount, const char* const literalName, compiler::ID* resultTypeId, compiler::ID* setId, uint32 opCode, compiler::ID* operand0, compiler::ID* operand1 = 0, compiler::ID* operand2 = 0);
+	InstExt(uint32 wordCount, compiler::ID* resultTypeId, compiler::ID* setId, uint32 opCode, compiler::ID* operand0, compiler::ID* operand1 = 0, compiler::ID* operand2 = 0);
 
 	virtual void GetInstWords(uint32* words) const override;
 };
@@ -29,10 +29,25 @@ namespace thc {
 namespace core {
 namespace instruction {
 
+using namespace utils;
+
 void InstBase::GetInstWords(uint32* words) const {
 	words[0] = opCode | (wordCount << 16);
 }
 
+void InstBase::Encode(List<uint32>& code) const {
+	uint64 offset = code.GetCount();
+
+	code.Resize(offset + wordCount);
+
+	uint32* words = code.GetData() + offset;
+
+	//String literals don't fill their last word
+	memset(words, 0, wordCount << 2);
+
+	GetInstWords(words);
+}
+
 void InstUndef::GetInstWords(uint32* words) const {
 	InstBase::GetInstWords(words);
 
@@ -50,7 +65,6 @@ void InstSizeOf::GetInstWords(uint32* words) const {
 
 void InstSourceContinued::GetInstWords(uint32* words) const {
 	uint64 len = strlen(source)+1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 
 	InstBase::GetInstWords(words);
 	memcpy(words+1, source, len);
@@ -58,7 +72,6 @@ void InstSourceContinued::GetInstWords(uint32* words) const {
 
 void InstSource::GetInstWords(uint32* words) const {
 	uint64 len = strlen(source)+1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 
 	InstBase::GetInstWords(words);
 	
@@ -70,7 +83,6 @@ void InstSource::GetInstWords(uint32* words) const {
 
 void InstSourceExtension::GetInstWords(uint32* words) const {
 	uint64 len = strlen(extension)+1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 
 	InstBase::GetInstWords(words);
 	memcpy(words+1, extension, len);
@@ -78,7 +90,6 @@ void InstSourceExtension::GetInstWords(uint32* words) const {
 
 void InstName::GetInstWords(uint32* words) const {
 	uint64 len = strlen(name)+1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 
 	words[1] = targetId->id;
 
@@ -88,7 +99,6 @@ void InstName::GetInstWords(uint32* words) const {
 
 void InstMemberName::GetInstWords(uint32* words) const {
 	uint64 len = strlen(name)+1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 
 	words[1] = typeId->id;
 	words[2] = member;
@@ -99,7 +109,6 @@ void InstMemberName::GetInstWords(uint32* words) const {
 
 void InstString::GetInstWords(uint32* words) const {
 	uint64 len = strlen(string)+1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 
 	words[1] = id->id;
 
@@ -116,7 +125,6 @@ void InstLine::GetInstWords(uint32* words) const {
 }
 
 void InstDecorate::GetInstWords(uint32* words) const {
-	wordCount += numDecorationLiterals;
 	InstBase::GetInstWords(words);
 
 	words[1] = targetId->id;
@@ -125,7 +133,6 @@ void InstDecorate::GetInstWords(uint32* words) const {
 }
 
 void InstMemberDecorate::GetInstWords(uint32* words) const {
-	wordCount += numDecorationLiterals;
 	InstBase::GetInstWords(words);
 
 	words[1] = structId->id;
@@ -141,7 +148,6 @@ void InstDecorationGroup::GetInstWords(uint32* words) const {
 }
 
 void InstGroupDecorate::GetInstWords(uint32* words) const {
-	wordCount += numTargets;
 	InstBase::GetInstWords(words);
 
 	words[1] = groupId->id;
@@ -153,7 +159,6 @@ void InstGroupDecorate::GetInstWords(uint32* words) const {
 
 void InstExtension::GetInstWords(uint32* words) const {
 	uint64 len = strlen(extension) + 1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 	InstBase::GetInstWords(words);
 
 	memcpy(words+1, extension, len);
@@ -161,7 +166,6 @@ void InstExtension::GetInstWords(uint32* words) const {
 
 void InstExtInstImport::GetInstWords(uint32* words) const {
 	uint64 len = strlen(extensionSet) + 1;
-	wordCount += (uint32)((len >> 2) + (len % 4 ? 1 : 0));
 	InstBase::GetInstWords(words);
 
 	words[1] = id->id;
@@ -192,7 +196,6 @@ void InstMemoryModel::GetInstWords(uint32* words) const {
 void InstEntryPoint::GetInstWords(uint32* words) const {
 	uint64 len = strlen(entryPointName) + 1;
 	uint32 len2 = (uint32)((len >> 2) + (len % 4 ? 1 : 0));
-	wordCount += len2 + inoutVariableCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = executionModel;
@@ -209,7 +212,6 @@ void InstEntryPoint::GetInstWords(uint32* words) const {
 }
 
 void InstExecutionMode::GetInstWords(uint32* words) const {
-	wordCount += extraOperandCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = entryPointId->id;
@@ -239,7 +241,6 @@ void InstConstantFalse::GetInstWords(uint32* words) const {
 }
 
 void InstConstant::GetInstWords(uint32* words) const {
-	wordCount += valueCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -249,7 +250,6 @@ void InstConstant::GetInstWords(uint32* words) const {
 }
 
 void InstConstantComposite::GetInstWords(uint32* words) const {
-	wordCount += constituentCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -260,8 +260,54 @@ void InstConstantComposite::GetInstWords(uint32* words) const {
 	}
 }
 
+void InstSpecConstantTrue::GetInstWords(uint32* words) const {
+	InstBase::GetInstWords(words);
+
+	words[1] = resultTypeId->id;
+	words[2] = id->id;
+}
+
+void InstSpecConstantFalse::GetInstWords(uint32* words) const {
+	InstBase::GetInstWords(words);
+
+	words[1] = resultTypeId->id;
+	words[2] = id->id;
+}
+
+void InstSpecConstant::GetInstWords(uint32* words) const {
+	InstBase::GetInstWords(words);
+
+	words[1] = resultTypeId->id;
+	words[2] = id->id;
+
+	memcpy(words+3, values, valueCount << 2);
+}
+
+void InstSpecConstantComposite::GetInstWords(uint32* words) const {
+	InstBase::GetInstWords(words);
+
+	words[1] = resultTypeId->id;
+	words[2] = id->id;
+
+	for (uint32 i = 0; i < constituentCount; i++) {
+		words[i + 3] = constituentId[i]->id;
+	}
+}
+
+void InstSpecConstantOp::GetInstWords(uint32* words) const {
+	//The operation is encoded one word in and then its opcode is moved behind the result id
+	operation->GetInstWords(words + 1);
+
+	uint32 opCode = words[1] & 0xFFFF;
+
+	InstBase::GetInstWords(words);
+
+	words[1] = words[2];
+	words[2] = words[3];
+	words[3] = opCode;
+}
+
 void InstVariable::GetInstWords(uint32* words) const {
-	wordCount += initializer ? 1 : 0;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -271,7 +317,6 @@ void InstVariable::GetInstWords(uint32* words) const {
 }
 
 void InstLoad::GetInstWords(uint32* words) const {
-	wordCount += memoryAccess ? 1 : 0;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -281,7 +326,6 @@ void InstLoad::GetInstWords(uint32* words) const {
 }
 
 void InstStore::GetInstWords(uint32* words) const {
-	wordCount += memoryAccess ? 1 : 0;
 	InstBase::GetInstWords(words);
 
 	words[1] = pointerId->id;
@@ -290,7 +334,6 @@ void InstStore::GetInstWords(uint32* words) const {
 }
 
 void InstCopyMemory::GetInstWords(uint32* words) const {
-	wordCount += memoryAccess ? 1 : 0;
 	InstBase::GetInstWords(words);
 
 	words[1] = targetId->id;
@@ -299,7 +342,6 @@ void InstCopyMemory::GetInstWords(uint32* words) const {
 }
 
 void InstCopyMemorySized::GetInstWords(uint32* words) const {
-	wordCount += memoryAccess ? 1 : 0;
 	InstBase::GetInstWords(words);
 
 	words[1] = targetId->id;
@@ -309,7 +351,6 @@ void InstCopyMemorySized::GetInstWords(uint32* words) const {
 }
 
 void InstAccessChain::GetInstWords(uint32* words) const {
-	wordCount += indexCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -322,7 +363,6 @@ void InstAccessChain::GetInstWords(uint32* words) const {
 }
 
 void InstInBoundsAccessChain::GetInstWords(uint32* words) const {
-	wordCount += indexCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -351,7 +391,6 @@ void InstFunctionParameter::GetInstWords(uint32* words) const {
 }
 
 void InstFunctionCall::GetInstWords(uint32* words) const {
-	wordCount += argumentCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -469,7 +508,6 @@ void InstVectorInsertDynamic::GetInstWords(uint32* words) const {
 }
 
 void InstVectorShuffle::GetInstWords(uint32* words) const {
-	wordCount += componentCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -481,7 +519,6 @@ void InstVectorShuffle::GetInstWords(uint32* words) const {
 }
 
 void InstCompositeConstruct::GetInstWords(uint32* words) const {
-	wordCount += constituentCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -493,7 +530,6 @@ void InstCompositeConstruct::GetInstWords(uint32* words) const {
 }
 
 void InstCompositeExtract::GetInstWords(uint32* words) const {
-	wordCount += indexCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -504,7 +540,6 @@ void InstCompositeExtract::GetInstWords(uint32* words) const {
 }
 
 void InstCompositeInsert::GetInstWords(uint32* words) const {
-	wordCount += indexCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -1129,7 +1164,6 @@ void InstFUnordGreaterThanEqual::GetInstWords(uint32* words) const {
 }
 
 void InstPhi::GetInstWords(uint32* words) const {
-	wordCount += pairCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = resultTypeId->id;
@@ -1176,7 +1210,6 @@ void InstBranchConditional::GetInstWords(uint32* words) const {
 }
 
 void InstSwitch::GetInstWords(uint32* words) const {
-	wordCount += pairCount * 2;
 	InstBase::GetInstWords(words);
 
 	words[1] = selectorId->id;
@@ -1194,6 +1227,21 @@ void InstReturnValue::GetInstWords(uint32* words) const {
 	words[1] = valueId->id;
 }
 
+void InstControlBarrier::GetInstWords(uint32* words) const {
+	InstBase::GetInstWords(words);
+
+	words[1] = executionScopeId->id;
+	words[2] = memoryScopeId->id;
+	words[3] = semanticsId->id;
+}
+
+void InstMemoryBarrier::GetInstWords(uint32* words) const {
+	InstBase::GetInstWords(words);
+
+	words[1] = memoryScopeId->id;
+	words[2] = semanticsId->id;
+}
+
 
 }
 }
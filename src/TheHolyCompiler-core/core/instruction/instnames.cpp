@@ -0,0 +1,410 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "instructions.h"
+
+namespace thc {
+namespace core {
+namespace instruction {
+
+//Indexed by opcode, nullptr for opcodes that aren't defined
+static const char* const opCodeNames[] = {
+	"OpNop",
+	"OpUndef",
+	"OpSourceContinued",
+	"OpSource",
+	"OpSourceExtension",
+	"OpName",
+	"OpMemberName",
+	"OpString",
+	"OpLine",
+	nullptr,
+	"OpExtension",
+	"OpExtInstImport",
+	"OpExtInst",
+	nullptr,
+	"OpMemoryModel",
+	"OpEntryPoint",
+	"OpExecutionMode",
+	"OpCapability",
+	nullptr,
+	"OpTypeVoid",
+	"OpTypeBool",
+	"OpTypeInt",
+	"OpTypeFloat",
+	"OpTypeVector",
+	"OpTypeMatrix",
+	"OpTypeImage",
+	"OpTypeSampler",
+	"OpTypeSampledImage",
+	"OpTypeArray",
+	"OpTypeRuntimeArray",
+	"OpTypeStruct",
+	"OpTypeOpaque",
+	"OpTypePointer",
+	"OpTypeFunction",
+	"OpTypeEvent",
+	"OpTypeDeviceEvent",
+	"OpTypeReserveId",
+	"OpTypeQueue",
+	"OpTypePipe",
+	"OpTypeForwardPointer",
+	nullptr,
+	"OpConstantTrue",
+	"OpConstantFalse",
+	"OpConstant",
+	"OpConstantComposite",
+	"OpConstantSampler",
+	"OpConstantNull",
+	nullptr,
+	"OpSpecConstantTrue",
+	"OpSpecConstantFalse",
+	"OpSpecConstant",
+	"OpSpecConstantComposite",
+	"OpSpecConstantOp",
+	nullptr,
+	"OpFunction",
+	"OpFunctionParameter",
+	"OpFunctionEnd",
+	"OpFunctionCall",
+	nullptr,
+	"OpVariable",
+	"OpImageTexelPointer",
+	"OpLoad",
+	"OpStore",
+	"OpCopyMemory",
+	"OpCopyMemorySized",
+	"OpAccessChain",
+	"OpInBoundsAccessChain",
+	"OpPtrAccessChain",
+	"OpArrayLength",
+	"OpGenericPtrMemSemantics",
+	"OpInBoundsPtrAccessChain",
+	"OpDecorate",
+	"OpMemberDecorate",
+	"OpDecorateGroup",
+	"OpGroupDecorate",
+	"OpGroupMemberDecorate",
+	nullptr,
+	"OpVectorExtractDynamic",
+	"OpVectorInsertDynamic",
+	"OpVectorShuffle",
+	"OpCompositeConstruct",
+	"OpCompositeExtract",
+	"OpCompositeInsert",
+	"OpCopyObject",
+	"OpTranspose",
+	nullptr,
+	"OpSampledImage",
+	"OpImageSampleImplicitLod",
+	"OpImageSampleExplicitLod",
+	"OpImageSampleDrefImplicitLod",
+	"OpImageSampleDrefExplicitLod",
+	"OpImageSampleProjImplicitLod",
+	"OpImageSampleProjExplicitLod",
+	"OpImageSampleProjDrefImplicitLod",
+	"OpImageSampleProjDrefExplicitLod",
+	"OpImageFetch",
+	"OpImageGather",
+	"OpImageDrefGather",
+	"OpImageRead",
+	"OpImageWrite",
+	"OpImage",
+	"OpImageQueryFormat",
+	"OpImageQueryOrder",
+	"OpImageQuerySizeLod",
+	"OpImageQuerySize",
+	"OpImageQueryLod",
+	"OpImageQueryLevels",
+	"OpImageQuerySamples",
+	nullptr,
+	"OpConvertFToU",
+	"OpConvertFToS",
+	"OpConvertSToF",
+	"OpConvertUToF",
+	"OpUConvert",
+	"OpSConvert",
+	"OpFConvert",
+	"OpQuantizeToF16",
+	"OpConvertPtrToU",
+	"OpSatConvertSToU",
+	"OpSatConvertUToS",
+	"OpConvertUToPtr",
+	"OpPtrCastToGeneric",
+	"OpGenericCastToPtr",
+	"OpGenericCastToPtrExplicit",
+	"OpBitcast",
+	nullptr,
+	"OpSNegate",
+	"OpFNegate",
+	"OpIAdd",
+	"OpFAdd",
+	"OpISub",
+	"OpFSub",
+	"OpIMul",
+	"OpFMul",
+	"OpUDiv",
+	"OpSDiv",
+	"OpFDiv",
+	"OpUMod",
+	"OpSRem",
+	"OpSMod",
+	"OpFRem",
+	"OpFMod",
+	"OpVectorTimesScalar",
+	"OpMatrixTimesScalar",
+	"OpVectorTimesMatrix",
+	"OpMatrixTimesVector",
+	"OpMatrixTimesMatrix",
+	"OpBitwiseOr",
+	"OpDot",
+	"OpIAddCarry",
+	"OpISubBorrow",
+	"OpUMulExtended",
+	"OpSMulExtended",
+	nullptr,
+	"OpAny",
+	"OpAll",
+	"OpIsNan",
+	"OpIsInf",
+	"OpIsFinite",
+	"OpIsNormal",
+	"OpSignBitSet",
+	"OpLessOrGreater",
+	"OpOrdered",
+	"OpUnordered",
+	"OpLogicalEqual",
+	"OpLogicalNotEqual",
+	"OpLogicalOr",
+	"OpLogicalAnd",
+	"OpLogicalNot",
+	"OpSelect",
+	"OpIEqual",
+	"OpINotEqual",
+	"OpUGreaterThan",
+	"OpSGreaterThan",
+	"OpUGreaterThanEqual",
+	"OpSGreaterThanEqual",
+	"OpULessThan",
+	"OpSLessThan",
+	"OpULessThanEqual",
+	"OpSLessThanEqual",
+	"OpFOrdEqual",
+	"OpFUnordEqual",
+	"OpFOrdNotEqual",
+	"OpFUnordNotEqual",
+	"OpFOrdLessThan",
+	"OpFUnordLessThan",
+	"OpFOrdGreaterThan",
+	"OpFUnordGreaterThan",
+	"OpFOrdLessThanEqual",
+	"OpFUnordLessThanEqual",
+	"OpFOrdGreaterThanEqual",
+	"OpFUnordGreaterThanEqual",
+	nullptr,
+	nullptr,
+	"OpShiftRightLogical",
+	"OpShiftRightArithmetic",
+	"OpShiftLeftLogical",
+	nullptr,
+	"OpBitwiseXor",
+	"OpBitwiseAnd",
+	"OpNot",
+	"OpBitFieldInsert",
+	"OpBitFieldSExtract",
+	"OpBitFieldUExtract",
+	"OpBitReverse",
+	"OpBitCount",
+	nullptr,
+	"OpDPdx",
+	"OpDPdy",
+	"OpFwidth",
+	"OpDPdxFine",
+	"OpDPdyFine",
+	"OpFwidthFine",
+	"OpDPdxCoarse",
+	"OpDPdyCoarse",
+	"OpFwidthCoarse",
+	nullptr,
+	nullptr,
+	"OpEmitVertex",
+	"OpEndPrimitive",
+	"OpEmitStreamVertex",
+	"OpEndStreamPrimitive",
+	nullptr,
+	nullptr,
+	"OpControlBarrier",
+	"OpMemoryBarrier",
+	nullptr,
+	"OpAtomicLoad",
+	"OpAtomicStore",
+	"OpAtomicExchange",
+	"OpAtomicCompareExchange",
+	"OpAtomicCompareExchangeWeak",
+	"OpAtomicIIncrement",
+	"OpAtomicIDecrement",
+	"OpAtomicIAdd",
+	"OpAtomicISub",
+	"OpAtomicSMin",
+	"OpAtomicUMin",
+	"OpAtomicSMax",
+	"OpAtomicUMax",
+	"OpAtomicAnd",
+	"OpAtomicOr",
+	"OpAtomicXor",
+	nullptr,
+	nullptr,
+	"OpPhi",
+	"OpLoopMerge",
+	"OpSelectionMerge",
+	"OpLabel",
+	"OpBranch",
+	"OpBranchConditional",
+	"OpSwitch",
+	"OpKill",
+	"OpReturn",
+	"OpReturnValue",
+	"OpUnreachable",
+	"OpLifetimeStart",
+	"OpLifetimeStop",
+	nullptr,
+	"OpGroupAsyncCopy",
+	"OpGroupWaitEvents",
+	"OpGroupAll",
+	"OpGroupAny",
+	"OpGroupBroadcast",
+	"OpGroupIAdd",
+	"OpGroupFAdd",
+	"OpGroupFMin",
+	"OpGroupUMin",
+	"OpGroupSMin",
+	"OpGroupFMax",
+	"OpGroupUMax",
+	"OpGroupSMax",
+	nullptr,
+	nullptr,
+	"OpReadPipe",
+	"OpWritePipe",
+	"OpReservedReadPipe",
+	"OpReservedWritePipe",
+	"OpReserveReadPipePackets",
+	"OpReserveWritePipePackets",
+	"OpCommitReadPipe",
+	"OpCommitWritePipe",
+	"OpIsValidReserveId",
+	"OpGetNumPipePackets",
+	"OpGetMaxPipePackets",
+	"OpGroupReserveReadPipePackets",
+	"OpGroupReserveWritePipePackets",
+	"OpGroupCommitReadPipe",
+	"OpGroupCommitWritePipe",
+	nullptr,
+	nullptr,
+	"OpEnqueueMarker",
+	"OpEnqueueKernel",
+	"OpGetKernelNDrangeSubGroupCount",
+	nullptr,
+	"OpGetKernelNDrangeMaxSubGroupSize",
+	"OpGetKernelPreferredWorkGroupSizeMultiple",
+	"OpRetainEvent",
+	"OpReleaseEvent",
+	"OpCreateUserEvent",
+	"OpIsValidEvent",
+	"OpSetUserEventStatus",
+	"OpCaptureEventProfilingInfo",
+	"OpGetDefaultQueue",
+	"OpBuildNDRange",
+	"OpImageSparseSampleImplicitLod",
+	"OpImageSparseSampleExplicitLod",
+	"OpImageSparseSampleDrefImplicitLod",
+	"OpImageSparseSampleDrefExplicitLod",
+	"OpImageSparseSampleProjImplicitLod",
+	"OpImageSparseSampleProjExplicitLod",
+	"OpImageSparseSampleProjDrefImplicitLod",
+	"OpImageSparseSampleProjDrefExplicitLod",
+	"OpImageSparseFetch",
+	"OpImageSparseGather",
+	"OpImageSparseDrefGather",
+	"OpImageSparseTexelsResident",
+	"OpNoLine",
+	"OpAtomicFlagTestAndSet",
+	"OpAtomicFlagClear",
+	"OpImageSparseRead",
+	"OpSizeOf",
+	"OpTypePipeStorage",
+	"OpConstantPipeStorage",
+	"OpCreatePipeFromPipeStorage",
+	"OpGetKernelLocalSizeForSubgroupCount",
+	"OpGetKernelMaxNumSubgroups",
+	"OpTypeNamedBarrier",
+	"OpNamedBarrierInitialize",
+	"OpMemoryNamedBarrier",
+	nullptr,
+	"OpExecutionModeId",
+	"OpDecorateId",
+	"OpGroupNonUniformElect",
+	"OpGroupNonUniformAll",
+	"OpGroupNonUniformAny",
+	"OpGroupNonUniformAllEqual",
+	"OpGroupNonUniformBroadcast",
+	"OpGroupNonUniformBroadcastFirst",
+	"OpGroupNonUniformBallot",
+	"OpGroupNonUniformInverseBallot",
+	"OpGroupNonUniformBallotBitExtract",
+	"OpGroupNonUniformBallotBitCount",
+	"OpGroupNonUniformBallotFindLSB",
+	"OpGroupNonUniformBallotFindMSB",
+	"OpGroupNonUniformShuffle",
+	"OpGroupNonUniformShuffleXor",
+	"OpGroupNonUniformShuffleUp",
+	"OpGroupNonUniformShuffleDown",
+	"OpGroupNonUniformIAdd",
+	"OpGroupNonUniformFAdd",
+	"OpGroupNonUniformIMul",
+	"OpGroupNonUniformFMul",
+	"OpGroupNonUniformSMin",
+	"OpGroupNonUniformUMin",
+	"OpGroupNonUniformFMin",
+	"OpGroupNonUniformSMax",
+	"OpGroupNonUniformUMax",
+	"OpGroupNonUniformFMax",
+	"OpGroupNonUniformBitwiseAnd",
+	"OpGroupNonUniformBitwiseOr",
+	"OpGroupNonUniformBitwiseXor",
+	"OpGroupNonUniformLogicalAnd",
+	"OpGroupNonUniformLogicalOr",
+	"OpGroupNonUniformQuadBroadcast",
+	nullptr,
+	"OpGroupNonUniformQuadSwap"
+};
+
+const char* GetOpCodeName(uint32 opCode) {
+	if (opCode >= sizeof(opCodeNames) / sizeof(const char*) || opCodeNames[opCode] == nullptr) return "OpUnknown";
+
+	return opCodeNames[opCode];
+}
+
+}
+}
+}
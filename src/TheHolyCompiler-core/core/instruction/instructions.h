@@ -42,20 +42,32 @@ enum class InstType {
 	Type
 };
 
+const char* GetOpCodeName(uint32 opCode);
+
 class InstBase {
 public:
 	InstType type;
+	bool hasResultId; //id is set by the compiler that creates the instruction
 	compiler::ID* id;
 	uint32 opCode;
-	mutable uint32 wordCount;
-	char* literalName;
+	uint32 wordCount; //Total word count including the variable part, set by the constructor
 
-	InstBase(uint32 opCode, uint32 wordCount, const char* const literalName, bool resultId = false, InstType type = InstType::Instruction);
+	InstBase(uint32 opCode, uint32 wordCount, bool resultId = false, InstType type = InstType::Instruction);
 	virtual ~InstBase();
 
+	//words must have room for wordCount words
 	virtual void GetInstWords(uint32* words) const;
 
+	//Appends the encoded instruction to code
+	void Encode(utils::List<uint32>& code) const;
+
+	inline const char* GetName() const { return GetOpCodeName(opCode); }
+
 	virtual bool operator==(const InstBase* const inst) const { return false; }
+
+protected:
+	//Words used by a null terminated string literal
+	static inline uint32 StringWordCount(const char* const string) { return (uint32)(strlen(string) >> 2) + 1; }
 };
 
 #pragma region misc
@@ -357,14 +369,64 @@ public:
 	uint32 constituentCount;
 	compiler::ID* constituentId[THC_LIMIT_OPTYPESTRUCT_MEMBERS];
 
-	InstConstantComposite(compiler::ID* resultTypeId, uint32 constituentCount, compiler::ID** constituentIds);
+	InstConstantComposite(compiler::ID* resultTypeId, uint32 constituentCount, compiler::ID* const* constituentIds);
 
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstBase* const inst) const override;
 };
 
-//TOOD: OpConstantNull, OpSpec*
+class InstSpecConstantTrue : public InstBase {
+public:
+	compiler::ID* resultTypeId;
+
+	InstSpecConstantTrue(compiler::ID* resultTypeId);
+
+	void GetInstWords(uint32* words) const override;
+};
+
+class InstSpecConstantFalse : public InstBase {
+public:
+	compiler::ID* resultTypeId;
+
+	InstSpecConstantFalse(compiler::ID* resultTypeId);
+
+	void GetInstWords(uint32* words) const override;
+};
+
+class InstSpecConstant : public InstBase {
+public:
+	compiler::ID* resultTypeId;
+	uint32 valueCount;
+	uint32* values;
+
+	InstSpecConstant(compiler::ID* resultTypeId, uint32 valueCount, const void* values);
+
+	void GetInstWords(uint32* words) const override;
+};
+
+class InstSpecConstantComposite : public InstBase {
+public:
+	compiler::ID* resultTypeId;
+	uint32 constituentCount;
+	compiler::ID* constituentId[THC_LIMIT_OPTYPESTRUCT_MEMBERS];
+
+	InstSpecConstantComposite(compiler::ID* resultTypeId, uint32 constituentCount, compiler::ID** constituentIds);
+
+	void GetInstWords(uint32* words) const override;
+};
+
+//Encodes operation as the operation of an OpSpecConstantOp, it keeps the result id of operation
+class InstSpecConstantOp : public InstBase {
+public:
+	InstBase* operation; //Must have a result type followed by the result id
+
+	InstSpecConstantOp(InstBase* operation);
+
+	void GetInstWords(uint32* words) const override;
+};
+
+//TODO: OpConstantNull
 
 #pragma endregion
 
@@ -1570,6 +1632,12 @@ public:
 	void GetInstWords(uint32* words) const override;
 };
 
+class InstUnreachable : public InstBase {
+public:
+
+	InstUnreachable();
+};
+
 //TODO: OpLifetimeStart, OpLifetimeStop
 
 #pragma endregion
@@ -1589,7 +1657,26 @@ public:
 
 #pragma region barrier instructions
 
-//TODO:
+class InstControlBarrier : public InstBase {
+public:
+	compiler::ID* executionScopeId;
+	compiler::ID* memoryScopeId;
+	compiler::ID* semanticsId;
+
+	InstControlBarrier(compiler::ID* executionScopeId, compiler::ID* memoryScopeId, compiler::ID* semanticsId);
+
+	void GetInstWords(uint32* words) const override;
+};
+
+class InstMemoryBarrier : public InstBase {
+public:
+	compiler::ID* memoryScopeId;
+	compiler::ID* semanticsId;
+
+	InstMemoryBarrier(compiler::ID* memoryScopeId, compiler::ID* semanticsId);
+
+	void GetInstWords(uint32* words) const override;
+};
 
 #pragma endregion
 
@@ -0,0 +1,849 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "ir.h"
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+uint32 Instruction::GetWordCount() const {
+	const OpCodeInfo* info = GetInfo();
+
+	return 1 + (info->hasResultType ? 1 : 0) + (info->hasResult ? 1 : 0) + operandCount;
+}
+
+void InstructionList::Add(Instruction* inst) {
+	inst->prev = last;
+	inst->next = nullptr;
+	inst->list = this;
+
+	if (last) {
+		last->next = inst;
+	} else {
+		first = inst;
+	}
+
+	last = inst;
+}
+
+void InstructionList::InsertBefore(Instruction* position, Instruction* inst) {
+	inst->prev = position->prev;
+	inst->next = position;
+	inst->list = this;
+
+	if (position->prev) {
+		position->prev->next = inst;
+	} else {
+		first = inst;
+	}
+
+	position->prev = inst;
+}
+
+void InstructionList::InsertAfter(Instruction* position, Instruction* inst) {
+	inst->prev = position;
+	inst->next = position->next;
+	inst->list = this;
+
+	if (position->next) {
+		position->next->prev = inst;
+	} else {
+		last = inst;
+	}
+
+	position->next = inst;
+}
+
+void InstructionList::Remove(Instruction* inst) {
+	if (inst->prev) {
+		inst->prev->next = inst->next;
+	} else {
+		first = inst->next;
+	}
+
+	if (inst->next) {
+		inst->next->prev = inst->prev;
+	} else {
+		last = inst->prev;
+	}
+
+	inst->prev = nullptr;
+	inst->next = nullptr;
+	inst->list = nullptr;
+}
+
+Instruction* BasicBlock::GetMerge() const {
+	Instruction* terminator = GetTerminator();
+
+	if (!terminator || !terminator->prev) return nullptr;
+
+	uint32 opCode = terminator->prev->opCode;
+
+	if (opCode == THC_SPIRV_OPCODE_OpSelectionMerge || opCode == THC_SPIRV_OPCODE_OpLoopMerge) return terminator->prev;
+
+	return nullptr;
+}
+
+bool BasicBlock::Dominates(const BasicBlock* other) const {
+	if (!IsReachable() || !other->IsReachable()) return false;
+
+	while (other->order > order) {
+		other = other->idom;
+	}
+
+	return other == this;
+}
+
+Arena::~Arena() {
+	for (uint64 i = 0; i < chunks.GetCount(); i++) {
+		delete[] chunks[i];
+	}
+}
+
+void* Arena::Allocate(uint64 size) {
+	size = (size + 7) & ~7;
+
+	if (size > THC_IR_ARENA_CHUNK_SIZE) {
+		uint8* chunk = new uint8[size];
+
+		chunks.Insert(chunks.GetCount() > 0 ? chunks.GetCount() - 1 : 0, chunk);
+
+		return chunk;
+	}
+
+	if (used + size > THC_IR_ARENA_CHUNK_SIZE) {
+		chunks.Add(new uint8[THC_IR_ARENA_CHUNK_SIZE]);
+		used = 0;
+	}
+
+	void* memory = chunks[chunks.GetCount() - 1] + used;
+
+	used += size;
+
+	return memory;
+}
+
+template<typename T>
+static void Grow(List<T*>& list, uint64 count) {
+	if (count <= list.GetCount()) return;
+
+	list.Reserve(count + (count >> 1));
+
+	while (list.GetCount() < count) list.Add(nullptr);
+}
+
+Module::Module() : defUseBuilt(false), blocks(64), version(0), generator(0), bound(1), schema(0), functions(16) {}
+
+Module::~Module() {
+	for (uint64 i = 0; i < functions.GetCount(); i++) {
+		delete functions[i];
+	}
+
+	for (uint64 i = 0; i < blocks.GetCount(); i++) {
+		delete blocks[i];
+	}
+}
+
+InstructionList& Module::GetSection(uint32 opCode) {
+	switch (opCode) {
+		case THC_SPIRV_OPCODE_OpCapability:
+		case THC_SPIRV_OPCODE_OpExtension:
+		case THC_SPIRV_OPCODE_OpExtInstImport:
+		case THC_SPIRV_OPCODE_OpMemoryModel:
+		case THC_SPIRV_OPCODE_OpEntryPoint:
+		case THC_SPIRV_OPCODE_OpExecutionMode:
+			return header;
+		case THC_SPIRV_OPCODE_OpSource:
+		case THC_SPIRV_OPCODE_OpSourceExtension:
+		case THC_SPIRV_OPCODE_OpSourceContinued:
+		case THC_SPIRV_OPCODE_OpName:
+		case THC_SPIRV_OPCODE_OpMemberName:
+		case THC_SPIRV_OPCODE_OpString:
+		case THC_SPIRV_OPCODE_OpLine:
+		case THC_SPIRV_OPCODE_OpNoLine:
+			return debug;
+		case THC_SPIRV_OPCODE_OpDecorate:
+		case THC_SPIRV_OPCODE_OpMemberDecorate:
+		case THC_SPIRV_OPCODE_OpDecorateGroup:
+		case THC_SPIRV_OPCODE_OpGroupDecorate:
+		case THC_SPIRV_OPCODE_OpGroupMemberDecorate:
+			return annotations;
+	}
+
+	return globals;
+}
+
+bool Module::Load(const uint32* words, uint64 count) {
+	if (count < 5 || words[0] != THC_SPIRV_MAGIC_NUMBER) return false;
+
+	version = words[1];
+	generator = words[2];
+	bound = words[3];
+	schema = words[4];
+
+	Function* function = nullptr;
+	BasicBlock* block = nullptr;
+
+	for (uint64 offset = 5; offset < count;) {
+		uint32 opCode = words[offset] & 0xFFFF;
+		uint32 wordCount = words[offset] >> 16;
+
+		const OpCodeInfo* info = GetOpCodeInfo(opCode);
+
+		if (!info || wordCount == 0 || offset + wordCount > count) return false;
+
+		const uint32* word = words + offset + 1;
+		uint32 operandCount = wordCount - 1;
+
+		uint32 resultType = 0;
+		uint32 result = 0;
+
+		if (info->hasResultType) {
+			if (operandCount == 0) return false;
+
+			resultType = *word++;
+			operandCount--;
+		}
+
+		if (info->hasResult) {
+			if (operandCount == 0) return false;
+
+			result = *word++;
+			operandCount--;
+		}
+
+		if (result >= bound) return false;
+
+		Instruction* inst = CreateInstruction(opCode, resultType, result, operandCount, word);
+
+		switch (opCode) {
+			case THC_SPIRV_OPCODE_OpFunction:
+				if (function) return false;
+
+				function = new Function(inst);
+				functions.Add(function);
+				break;
+			case THC_SPIRV_OPCODE_OpFunctionParameter:
+				if (!function || block) return false;
+
+				function->parameters.Add(inst);
+				break;
+			case THC_SPIRV_OPCODE_OpLabel:
+				if (!function) return false;
+
+				block = new BasicBlock(function, inst);
+				inst->block = block;
+
+				blocks.Add(block);
+				function->blocks.Add(block);
+				break;
+			case THC_SPIRV_OPCODE_OpFunctionEnd:
+				if (!function) return false;
+
+				function->end = inst;
+				function = nullptr;
+				block = nullptr;
+				break;
+			default:
+				if (block) {
+					inst->block = block;
+					block->instructions.Add(inst);
+				} else if (function) {
+					return false;
+				} else {
+					GetSection(opCode).Add(inst);
+				}
+		}
+
+		offset += wordCount;
+	}
+
+	return function == nullptr;
+}
+
+static uint32* WriteInstruction(const Instruction* inst, uint32* word) {
+	const OpCodeInfo* info = inst->GetInfo();
+
+	*word++ = (inst->GetWordCount() << 16) | inst->opCode;
+
+	if (info->hasResultType) *word++ = inst->resultType;
+	if (info->hasResult) *word++ = inst->result;
+
+	memcpy(word, inst->operands, inst->operandCount * sizeof(uint32));
+
+	return word + inst->operandCount;
+}
+
+void Module::Write(List<uint32>& words) const {
+	const InstructionList* sections[] = { &header, &debug, &annotations, &globals };
+
+	uint64 size = 5;
+
+	auto count = [&size](const Instruction* inst) {
+		size += inst->GetWordCount();
+	};
+
+	for (const InstructionList* section : sections) {
+		for (const Instruction* inst = section->first; inst; inst = inst->next) count(inst);
+	}
+
+	for (uint64 i = 0; i < functions.GetCount(); i++) {
+		const Function* function = functions[i];
+
+		count(function->definition);
+
+		for (uint64 j = 0; j < function->parameters.GetCount(); j++) count(function->parameters[j]);
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			const BasicBlock* block = function->blocks[j];
+
+			count(block->label);
+
+			for (const Instruction* inst = block->instructions.first; inst; inst = inst->next) count(inst);
+		}
+
+		count(function->end);
+	}
+
+	uint64 offset = words.GetCount();
+
+	words.Resize(offset + size);
+
+	uint32* word = words.GetData() + offset;
+
+	*word++ = THC_SPIRV_MAGIC_NUMBER;
+	*word++ = version;
+	*word++ = generator;
+	*word++ = bound;
+	*word++ = schema;
+
+	for (const InstructionList* section : sections) {
+		for (const Instruction* inst = section->first; inst; inst = inst->next) word = WriteInstruction(inst, word);
+	}
+
+	for (uint64 i = 0; i < functions.GetCount(); i++) {
+		const Function* function = functions[i];
+
+		word = WriteInstruction(function->definition, word);
+
+		for (uint64 j = 0; j < function->parameters.GetCount(); j++) word = WriteInstruction(function->parameters[j], word);
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			const BasicBlock* block = function->blocks[j];
+
+			word = WriteInstruction(block->label, word);
+
+			for (const Instruction* inst = block->instructions.first; inst; inst = inst->next) word = WriteInstruction(inst, word);
+		}
+
+		word = WriteInstruction(function->end, word);
+	}
+}
+
+uint32 Module::NewId() {
+	uint32 id = bound++;
+
+	if (defUseBuilt) {
+		Grow(defs, bound);
+		Grow(uses, bound);
+	}
+
+	return id;
+}
+
+uint32 Module::GetUndef(uint32 typeId) {
+	uint32* existing = undefs.Get(typeId);
+
+	if (existing) return *existing;
+
+	Instruction* undef = CreateInstruction(THC_SPIRV_OPCODE_OpUndef, typeId, NewId(), 0);
+
+	Add(globals, undef);
+	undefs.Set(typeId, undef->result);
+
+	return undef->result;
+}
+
+uint32 Module::GetType(uint32 opCode, uint32 operandCount, const uint32* operands) {
+	for (Instruction* inst = globals.first; inst; inst = inst->next) {
+		if (inst->opCode != opCode || inst->operandCount != operandCount) continue;
+
+		if (memcmp(inst->operands, operands, operandCount * sizeof(uint32)) == 0) return inst->result;
+	}
+
+	Instruction* type = CreateInstruction(opCode, 0, NewId(), operandCount, operands);
+
+	Add(globals, type);
+
+	return type->result;
+}
+
+uint32 Module::GetConstant(uint32 opCode, uint32 typeId, uint32 operandCount, const uint32* operands) {
+	for (Instruction* inst = globals.first; inst; inst = inst->next) {
+		if (inst->opCode != opCode || inst->resultType != typeId || inst->operandCount != operandCount) continue;
+
+		if (memcmp(inst->operands, operands, operandCount * sizeof(uint32)) == 0) return inst->result;
+	}
+
+	Instruction* constant = CreateInstruction(opCode, typeId, NewId(), operandCount, operands);
+
+	Add(globals, constant);
+
+	return constant->result;
+}
+
+Instruction* Module::CreateInstruction(uint32 opCode, uint32 resultType, uint32 result, uint32 operandCount, const uint32* operands) {
+	Instruction* inst = (Instruction*)arena.Allocate(sizeof(Instruction));
+
+	inst->opCode = opCode;
+	inst->resultType = resultType;
+	inst->result = result;
+	inst->operandCount = operandCount;
+	inst->operands = (uint32*)arena.Allocate(operandCount * sizeof(uint32));
+	inst->prev = nullptr;
+	inst->next = nullptr;
+	inst->list = nullptr;
+	inst->block = nullptr;
+	inst->removed = false;
+
+	if (operands) {
+		memcpy(inst->operands, operands, operandCount * sizeof(uint32));
+	} else {
+		memset(inst->operands, 0, operandCount * sizeof(uint32));
+	}
+
+	return inst;
+}
+
+void Module::AddDef(Instruction* inst) {
+	if (inst->result == 0) return;
+
+	Grow(defs, inst->result + 1);
+
+	defs[inst->result] = inst;
+}
+
+void Module::AddUse(Instruction* inst, uint32* operand) {
+	uint32 id = *operand;
+
+	if (id == 0) return;
+
+	Grow(uses, id + 1);
+
+	Use* use = (Use*)arena.Allocate(sizeof(Use));
+
+	use->user = inst;
+	use->operand = operand;
+	use->next = uses[id];
+
+	uses[id] = use;
+}
+
+void Module::AddUses(Instruction* inst) {
+	if (inst->GetInfo()->hasResultType) AddUse(inst, &inst->resultType);
+
+	inst->ForEachId([this, inst](uint32& id) {
+		AddUse(inst, &id);
+	});
+}
+
+void Module::Add(InstructionList& list, Instruction* inst) {
+	bool moved = inst->list != nullptr;
+
+	if (moved) inst->list->Remove(inst);
+
+	list.Add(inst);
+
+	if (defUseBuilt && !moved) {
+		AddDef(inst);
+		AddUses(inst);
+	}
+}
+
+void Module::Add(BasicBlock* block, Instruction* inst) {
+	inst->block = block;
+
+	Add(block->instructions, inst);
+}
+
+void Module::InsertBefore(Instruction* position, Instruction* inst) {
+	bool moved = inst->list != nullptr;
+
+	if (moved) inst->list->Remove(inst);
+
+	position->list->InsertBefore(position, inst);
+	inst->block = position->block;
+
+	if (defUseBuilt && !moved) {
+		AddDef(inst);
+		AddUses(inst);
+	}
+}
+
+void Module::InsertAfter(Instruction* position, Instruction* inst) {
+	bool moved = inst->list != nullptr;
+
+	if (moved) inst->list->Remove(inst);
+
+	position->list->InsertAfter(position, inst);
+	inst->block = position->block;
+
+	if (defUseBuilt && !moved) {
+		AddDef(inst);
+		AddUses(inst);
+	}
+}
+
+void Module::Remove(Instruction* inst) {
+	if (inst->list) inst->list->Remove(inst);
+
+	inst->removed = true;
+
+	if (inst->opCode == THC_SPIRV_OPCODE_OpUndef) {
+		uint32* undef = undefs.Get(inst->resultType);
+
+		if (undef && *undef == inst->result) undefs.Remove(inst->resultType);
+	}
+}
+
+void Module::SetOperand(Instruction* inst, uint32 index, uint32 id) {
+	uint32* operand = inst->operands + index;
+
+	if (*operand == id) return;
+
+	*operand = id;
+
+	if (!defUseBuilt || id == 0) return;
+
+	//The operand may have had this id before, the old use is live again in that case
+	for (Use* use = GetUses(id); use; use = use->next) {
+		if (use->operand == operand) return;
+	}
+
+	AddUse(inst, operand);
+}
+
+void Module::SetOperands(Instruction* inst, uint32 operandCount, const uint32* operands) {
+	//A new array invalidates all the old uses
+	inst->operands = (uint32*)arena.Allocate(operandCount * sizeof(uint32));
+	inst->operandCount = operandCount;
+
+	memcpy(inst->operands, operands, operandCount * sizeof(uint32));
+
+	if (defUseBuilt) {
+		inst->ForEachId([this, inst](uint32& id) {
+			AddUse(inst, &id);
+		});
+	}
+}
+
+BasicBlock* Module::CreateBlock(Function* function, uint64 index) {
+	Instruction* label = CreateInstruction(THC_SPIRV_OPCODE_OpLabel, 0, NewId(), 0);
+
+	BasicBlock* block = new BasicBlock(function, label);
+
+	label->block = block;
+
+	blocks.Add(block);
+
+	if (index < function->blocks.GetCount()) {
+		function->blocks.Insert(index, block);
+	} else {
+		function->blocks.Add(block);
+	}
+
+	if (defUseBuilt) AddDef(label);
+
+	return block;
+}
+
+void Module::RemoveBlock(BasicBlock* block) {
+	while (block->instructions.first) {
+		Remove(block->instructions.first);
+	}
+
+	block->label->removed = true;
+	block->function->blocks.Remove(block);
+}
+
+void Module::RemoveFunction(Function* function) {
+	while (function->blocks.GetCount()) {
+		RemoveBlock(function->blocks[0]);
+	}
+
+	function->definition->removed = true;
+	function->end->removed = true;
+
+	for (uint64 i = 0; i < function->parameters.GetCount(); i++) {
+		function->parameters[i]->removed = true;
+	}
+
+	functions.Remove(function);
+
+	delete function;
+}
+
+void Module::BuildDefUse() {
+	defs.Clear();
+	uses.Clear();
+	undefs.Clear();
+
+	Grow(defs, bound);
+	Grow(uses, bound);
+
+	defUseBuilt = true;
+
+	ForEachInstruction([this](Instruction* inst) {
+		AddDef(inst);
+		AddUses(inst);
+
+		if (inst->opCode == THC_SPIRV_OPCODE_OpUndef && inst->block == nullptr) undefs.Set(inst->resultType, inst->result);
+	});
+}
+
+Instruction* Module::GetDef(uint32 id) const {
+	if (id >= defs.GetCount()) return nullptr;
+
+	Instruction* inst = defs[id];
+
+	return inst && !inst->removed ? inst : nullptr;
+}
+
+bool Module::IsLive(const Use* use, uint32 id) {
+	const Instruction* user = use->user;
+
+	if (user->removed || *use->operand != id) return false;
+
+	return use->operand == &user->resultType || (use->operand >= user->operands && use->operand < user->operands + user->operandCount);
+}
+
+uint32 Module::GetUseCount(uint32 id) const {
+	uint32 count = 0;
+
+	for (Use* use = GetUses(id); use; use = use->next) {
+		if (IsLive(use, id)) count++;
+	}
+
+	return count;
+}
+
+void Module::ReplaceAllUses(uint32 id, uint32 replacement) {
+	if (id == replacement) return;
+
+	Grow(uses, replacement + 1);
+
+	Use* use = uses[id];
+
+	uses[id] = nullptr;
+
+	while (use) {
+		Use* next = use->next;
+
+		if (IsLive(use, id) && use->user->opCode == THC_SPIRV_OPCODE_OpDecorate && use->user->operands[1] == THC_SPIRV_DECORATION_RELAXED_PRECISION) {
+			//The replacement may be used where full precision is needed, the decoration stays with the old result
+			use->next = uses[id];
+			uses[id] = use;
+		} else if (IsLive(use, id)) {
+			*use->operand = replacement;
+
+			use->next = uses[replacement];
+			uses[replacement] = use;
+		}
+
+		use = next;
+	}
+}
+
+bool Module::IsRemovable(const Instruction* inst) const {
+	if (inst->HasFlag(THC_IR_FLAG_REMOVABLE)) return true;
+	if (inst->opCode != THC_SPIRV_OPCODE_OpExtInst) return false;
+
+	//Extended instructions can only have side effects through pointer operands, like modf and frexp
+	for (uint32 i = 2; i < inst->operandCount; i++) {
+		Instruction* def = GetDef(inst->operands[i]);
+
+		if (!def || def->resultType == 0) return false;
+
+		Instruction* type = GetDef(def->resultType);
+
+		if (!type || type->opCode == THC_SPIRV_OPCODE_OpTypePointer) return false;
+	}
+
+	return true;
+}
+
+BasicBlock* Module::GetBlock(uint32 labelId) const {
+	Instruction* label = GetDef(labelId);
+
+	return label && label->opCode == THC_SPIRV_OPCODE_OpLabel ? label->block : nullptr;
+}
+
+void Module::BuildCFG(Function* function) {
+	for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+		BasicBlock* block = function->blocks[i];
+
+		block->predecessors.Clear();
+		block->successors.Clear();
+	}
+
+	for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+		BasicBlock* block = function->blocks[i];
+		Instruction* terminator = block->GetTerminator();
+
+		if (!terminator) continue;
+
+		auto link = [this, block](uint32 labelId) {
+			BasicBlock* target = GetBlock(labelId);
+
+			if (!target || block->successors.Find(target) != ~0) return;
+
+			block->successors.Add(target);
+			target->predecessors.Add(block);
+		};
+
+		switch (terminator->opCode) {
+			case THC_SPIRV_OPCODE_OpBranch:
+				link(terminator->operands[0]);
+				break;
+			case THC_SPIRV_OPCODE_OpBranchConditional:
+				link(terminator->operands[1]);
+				link(terminator->operands[2]);
+				break;
+			case THC_SPIRV_OPCODE_OpSwitch:
+				link(terminator->operands[1]);
+
+				for (uint32 j = 3; j < terminator->operandCount; j += 2) {
+					link(terminator->operands[j]);
+				}
+
+				break;
+		}
+	}
+}
+
+void Module::BuildDominators(Function* function) {
+	List<BasicBlock*>& order = function->order;
+
+	order.Clear();
+
+	for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+		BasicBlock* block = function->blocks[i];
+
+		block->idom = nullptr;
+		block->children.Clear();
+		block->order = ~0;
+	}
+
+	if (function->blocks.GetCount() == 0) return;
+
+	//Post order with an explicit stack, order is used as the visited flag
+	struct Visit {
+		BasicBlock* block;
+		uint64 next;
+	};
+
+	List<Visit> stack(function->blocks.GetCount());
+	BasicBlock* entry = function->blocks[0];
+
+	entry->order = 0;
+	stack.Add({ entry, 0 });
+
+	while (stack.GetCount() > 0) {
+		Visit& visit = stack[stack.GetCount() - 1];
+
+		if (visit.next < visit.block->successors.GetCount()) {
+			BasicBlock* successor = visit.block->successors[visit.next++];
+
+			if (successor->order == ~0) {
+				successor->order = 0;
+				stack.Add({ successor, 0 });
+			}
+		} else {
+			order.Add(visit.block);
+			stack.RemoveAt(stack.GetCount() - 1);
+		}
+	}
+
+	uint64 count = order.GetCount();
+
+	for (uint64 i = 0; i < count / 2; i++) {
+		BasicBlock* tmp = order[i];
+		order[i] = order[count - i - 1];
+		order[count - i - 1] = tmp;
+	}
+
+	for (uint64 i = 0; i < count; i++) {
+		order[i]->order = (uint32)i;
+	}
+
+	//Cooper, Harvey and Kennedy. A Simple, Fast Dominance Algorithm
+	auto intersect = [](BasicBlock* a, BasicBlock* b) -> BasicBlock* {
+		while (a != b) {
+			while (a->order > b->order) a = a->idom;
+			while (b->order > a->order) b = b->idom;
+		}
+
+		return a;
+	};
+
+	entry->idom = entry;
+
+	bool changed = true;
+
+	while (changed) {
+		changed = false;
+
+		for (uint64 i = 1; i < count; i++) {
+			BasicBlock* block = order[i];
+			BasicBlock* idom = nullptr;
+
+			for (uint64 j = 0; j < block->predecessors.GetCount(); j++) {
+				BasicBlock* pred = block->predecessors[j];
+
+				if (pred->idom == nullptr) continue;
+
+				idom = idom ? intersect(pred, idom) : pred;
+			}
+
+			if (idom != block->idom) {
+				block->idom = idom;
+				changed = true;
+			}
+		}
+	}
+
+	entry->idom = nullptr;
+
+	for (uint64 i = 1; i < count; i++) {
+		order[i]->idom->children.Add(order[i]);
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,325 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <memory>
+#include <core/thctypes.h>
+#include <core/spirvdefines.h>
+#include <util/list.h>
+#include <util/map.h>
+
+#define THC_IR_ARENA_CHUNK_SIZE 0x10000
+
+#define THC_IR_FLAG_PURE 0x01 //The result only depends on the operands, identical instructions can be merged
+#define THC_IR_FLAG_REMOVABLE 0x02 //No side effects, can be removed when the result isn't used
+#define THC_IR_FLAG_TERMINATOR 0x04 //Ends a basic block
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+/*operands describes the words following the result type and result.
+i = id, l = literal word, s = null terminated string
+The kinds inside [] repeat until the end of the instruction, missing trailing operands are optional*/
+struct OpCodeInfo {
+	bool hasResultType;
+	bool hasResult;
+	uint8 flags;
+	const char* operands;
+};
+
+//Returns nullptr if the opcode isn't known by the optimizer
+const OpCodeInfo* GetOpCodeInfo(uint32 opCode);
+
+class BasicBlock;
+class Function;
+class InstructionList;
+
+class Instruction {
+public:
+	uint32 opCode;
+	uint32 resultType; //0 if the instruction doesn't have one
+	uint32 result; //0 if the instruction doesn't have one
+
+	uint32 operandCount;
+	uint32* operands;
+
+	Instruction* prev;
+	Instruction* next;
+
+	InstructionList* list;
+	BasicBlock* block; //nullptr for instructions outside of functions
+
+	bool removed;
+
+	inline const OpCodeInfo* GetInfo() const { return GetOpCodeInfo(opCode); }
+	inline bool HasFlag(uint8 flag) const { return (GetInfo()->flags & flag) != 0; }
+
+	uint32 GetWordCount() const;
+
+	//Calls func(uint32& id) for every operand that is an id, the result type isn't included
+	template<typename F>
+	void ForEachId(F func);
+};
+
+//Intrusive doubly linked list, an instruction can only be in one list at a time
+class InstructionList {
+public:
+	Instruction* first;
+	Instruction* last;
+
+	InstructionList() : first(nullptr), last(nullptr) {}
+
+	void Add(Instruction* inst);
+	void InsertBefore(Instruction* position, Instruction* inst);
+	void InsertAfter(Instruction* position, Instruction* inst);
+	void Remove(Instruction* inst);
+
+	inline bool IsEmpty() const { return first == nullptr; }
+};
+
+class BasicBlock {
+public:
+	Function* function;
+	Instruction* label;
+
+	InstructionList instructions; //Everything after OpLabel including the merge instruction and terminator
+
+	utils::List<BasicBlock*> predecessors;
+	utils::List<BasicBlock*> successors;
+
+	//Set by BuildDominators, unreachable blocks have no immediate dominator
+	BasicBlock* idom;
+	utils::List<BasicBlock*> children; //Blocks immediately dominated by this one
+	uint32 order; //Index in Function::order
+
+	BasicBlock(Function* function, Instruction* label) : function(function), label(label), predecessors(4), successors(4), idom(nullptr), children(4), order(~0) {}
+
+	inline bool IsReachable() const { return order != ~0; }
+	bool Dominates(const BasicBlock* other) const;
+
+	inline uint32 GetId() const { return label->result; }
+	inline Instruction* GetTerminator() const { return instructions.last; }
+
+	//Returns the OpSelectionMerge or OpLoopMerge before the terminator or nullptr
+	Instruction* GetMerge() const;
+};
+
+class Function {
+public:
+	Instruction* definition; //OpFunction
+	Instruction* end; //OpFunctionEnd
+
+	utils::List<Instruction*> parameters;
+	utils::List<BasicBlock*> blocks; //The first block is the entry block
+	utils::List<BasicBlock*> order; //Reachable blocks in reverse post order, set by BuildDominators
+
+	Function(Instruction* definition) : definition(definition), end(nullptr), parameters(8), blocks(16), order(16) {}
+
+	inline uint32 GetId() const { return definition->result; }
+};
+
+struct Use {
+	Instruction* user;
+	uint32* operand; //Points to the result type or one of the operands of user
+
+	Use* next;
+};
+
+//Bump allocator, everything is freed at once when the module is destroyed
+class Arena {
+private:
+	utils::List<uint8*> chunks;
+	uint64 used;
+
+public:
+	Arena() : chunks(16), used(THC_IR_ARENA_CHUNK_SIZE) {}
+	Arena(const Arena& other) = delete;
+	~Arena();
+
+	void* Allocate(uint64 size);
+};
+
+class Module {
+private:
+	Arena arena;
+
+	bool defUseBuilt;
+
+	utils::List<Instruction*> defs;
+	utils::List<Use*> uses;
+
+	utils::List<BasicBlock*> blocks; //Owns every block created, including removed ones
+
+	utils::Map<uint32, uint32> undefs; //OpUndef by type
+
+	void AddDef(Instruction* inst);
+	void AddUse(Instruction* inst, uint32* operand);
+	void AddUses(Instruction* inst);
+
+	InstructionList& GetSection(uint32 opCode);
+
+public:
+	uint32 version;
+	uint32 generator;
+	uint32 bound;
+	uint32 schema;
+
+	InstructionList header; //Capabilities, extensions, imports, memory model, entry points and execution modes
+	InstructionList debug;
+	InstructionList annotations;
+	InstructionList globals; //Types, constants and global variables
+
+	utils::List<Function*> functions;
+
+	Module();
+	Module(const Module& other) = delete;
+	~Module();
+
+	//Returns false if the module is malformed or uses an opcode that isn't known
+	bool Load(const uint32* words, uint64 count);
+	//Appends the module to words
+	void Write(utils::List<uint32>& words) const;
+
+	uint32 NewId();
+	//Returns an OpUndef of the type, it's created in the globals section if it doesn't exist
+	uint32 GetUndef(uint32 typeId);
+	//Returns the id of the type, it's created in the globals section if it doesn't exist
+	uint32 GetType(uint32 opCode, uint32 operandCount, const uint32* operands);
+	//Same as GetType but for constants of the type
+	uint32 GetConstant(uint32 opCode, uint32 typeId, uint32 operandCount, const uint32* operands);
+
+	//The instruction isn't in a list, operands are zero initialized if nullptr
+	Instruction* CreateInstruction(uint32 opCode, uint32 resultType, uint32 result, uint32 operandCount, const uint32* operands = nullptr);
+
+	//These keep the def-use chains up to date if they are built
+	void Add(InstructionList& list, Instruction* inst);
+	void Add(BasicBlock* block, Instruction* inst);
+	void InsertBefore(Instruction* position, Instruction* inst);
+	void InsertAfter(Instruction* position, Instruction* inst);
+	void Remove(Instruction* inst);
+
+	void SetOperand(Instruction* inst, uint32 index, uint32 id);
+	void SetOperands(Instruction* inst, uint32 operandCount, const uint32* operands);
+
+	BasicBlock* CreateBlock(Function* function, uint64 index);
+	void RemoveBlock(BasicBlock* block);
+	void RemoveFunction(Function* function);
+
+	//Def-use chains, all ids in the module are tracked
+	void BuildDefUse();
+	inline bool IsDefUseBuilt() const { return defUseBuilt; }
+
+	//Returns nullptr if the id isn't defined or the definition has been removed
+	Instruction* GetDef(uint32 id) const;
+	//The list may contain uses that have been replaced or removed, use IsLive
+	inline Use* GetUses(uint32 id) const { return id < uses.GetCount() ? uses[id] : nullptr; }
+	static bool IsLive(const Use* use, uint32 id);
+
+	uint32 GetUseCount(uint32 id) const;
+	inline bool HasUses(uint32 id) const { return GetUseCount(id) != 0; }
+
+	void ReplaceAllUses(uint32 id, uint32 replacement);
+
+	//Returns true if the instruction can be removed when its result isn't used, requires the def-use chains
+	bool IsRemovable(const Instruction* inst) const;
+
+	//Requires the def-use chains
+	void BuildCFG(Function* function);
+	//Requires the CFG
+	void BuildDominators(Function* function);
+	BasicBlock* GetBlock(uint32 labelId) const;
+
+	//Calls func(Instruction*) for every instruction in the module
+	template<typename F>
+	void ForEachInstruction(F func);
+};
+
+template<typename F>
+void Instruction::ForEachId(F func) {
+	const char* kind = GetInfo()->operands;
+	const char* group = nullptr;
+
+	for (uint32 i = 0; i < operandCount;) {
+		if (*kind == '[') group = ++kind;
+		if (*kind == ']') kind = group;
+		if (*kind == 0) break;
+
+		switch (*kind++) {
+			case 'i':
+				func(operands[i++]);
+				break;
+			case 'l':
+				i++;
+				break;
+			case 's':
+				//The string ends in the first word that contains a null byte
+				while (i < operandCount) {
+					uint32 w = operands[i++];
+
+					if (!(w & 0xFF) || !(w & 0xFF00) || !(w & 0xFF0000) || !(w & 0xFF000000)) break;
+				}
+
+				break;
+		}
+	}
+}
+
+template<typename F>
+void Module::ForEachInstruction(F func) {
+	InstructionList* sections[] = { &header, &debug, &annotations, &globals };
+
+	for (InstructionList* section : sections) {
+		for (Instruction* inst = section->first; inst; inst = inst->next) {
+			func(inst);
+		}
+	}
+
+	for (uint64 i = 0; i < functions.GetCount(); i++) {
+		Function* function = functions[i];
+
+		func(function->definition);
+
+		for (uint64 j = 0; j < function->parameters.GetCount(); j++) {
+			func(function->parameters[j]);
+		}
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			BasicBlock* block = function->blocks[j];
+
+			func(block->label);
+
+			for (Instruction* inst = block->instructions.first; inst; inst = inst->next) {
+				func(inst);
+			}
+		}
+
+		func(function->end);
+	}
+}
+
+}
+}
+}
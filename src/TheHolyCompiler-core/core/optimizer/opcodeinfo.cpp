@@ -0,0 +1,305 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "ir.h"
+
+#define P THC_IR_FLAG_PURE | THC_IR_FLAG_REMOVABLE
+#define R THC_IR_FLAG_REMOVABLE
+#define T THC_IR_FLAG_TERMINATOR
+
+#define INST(op, flags, operands) { op, { false, false, flags, operands } }
+#define INST_RESULT(op, flags, operands) { op, { false, true, flags, operands } }
+#define INST_TYPED(op, flags, operands) { op, { true, true, flags, operands } }
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+struct OpCodeEntry {
+	uint32 opCode;
+	OpCodeInfo info;
+};
+
+static const OpCodeEntry opCodeEntries[] = {
+	INST(0, 0, ""), //OpNop
+	INST_TYPED(1, R, ""), //OpUndef
+	INST(2, 0, "s"), //OpSourceContinued
+	INST(3, 0, "llis"), //OpSource
+	INST(4, 0, "s"), //OpSourceExtension
+	INST(5, 0, "is"), //OpName
+	INST(6, 0, "ils"), //OpMemberName
+	INST_RESULT(7, 0, "s"), //OpString
+	INST(8, 0, "ill"), //OpLine
+	INST(10, 0, "s"), //OpExtension
+	INST_RESULT(11, 0, "s"), //OpExtInstImport
+	INST_TYPED(12, 0, "il[i]"), //OpExtInst, some extended instructions write through pointers
+	INST(14, 0, "ll"), //OpMemoryModel
+	INST(15, 0, "lis[i]"), //OpEntryPoint
+	INST(16, 0, "il[l]"), //OpExecutionMode
+	INST(17, 0, "l"), //OpCapability
+
+	INST_RESULT(19, R, ""), //OpTypeVoid
+	INST_RESULT(20, R, ""), //OpTypeBool
+	INST_RESULT(21, R, "ll"), //OpTypeInt
+	INST_RESULT(22, R, "l"), //OpTypeFloat
+	INST_RESULT(23, R, "il"), //OpTypeVector
+	INST_RESULT(24, R, "il"), //OpTypeMatrix
+	INST_RESULT(25, R, "illllll[l]"), //OpTypeImage
+	INST_RESULT(26, R, ""), //OpTypeSampler
+	INST_RESULT(27, R, "i"), //OpTypeSampledImage
+	INST_RESULT(28, R, "ii"), //OpTypeArray
+	INST_RESULT(29, R, "i"), //OpTypeRuntimeArray
+	INST_RESULT(30, R, "[i]"), //OpTypeStruct
+	INST_RESULT(32, R, "li"), //OpTypePointer
+	INST_RESULT(33, R, "[i]"), //OpTypeFunction
+
+	INST_TYPED(41, P, ""), //OpConstantTrue
+	INST_TYPED(42, P, ""), //OpConstantFalse
+	INST_TYPED(43, P, "[l]"), //OpConstant
+	INST_TYPED(44, P, "[i]"), //OpConstantComposite
+	INST_TYPED(45, P, "lll"), //OpConstantSampler
+	INST_TYPED(46, P, ""), //OpConstantNull
+	INST_TYPED(48, R, ""), //OpSpecConstantTrue
+	INST_TYPED(49, R, ""), //OpSpecConstantFalse
+	INST_TYPED(50, R, "[l]"), //OpSpecConstant
+	INST_TYPED(51, R, "[i]"), //OpSpecConstantComposite
+	INST_TYPED(52, R, "l[i]"), //OpSpecConstantOp
+
+	INST_TYPED(54, 0, "li"), //OpFunction
+	INST_TYPED(55, 0, ""), //OpFunctionParameter
+	INST(56, 0, ""), //OpFunctionEnd
+	INST_TYPED(57, 0, "[i]"), //OpFunctionCall
+
+	INST_TYPED(59, R, "l[i]"), //OpVariable
+	INST_TYPED(60, P, "iii"), //OpImageTexelPointer
+	INST_TYPED(61, R, "i[l]"), //OpLoad
+	INST(62, 0, "ii[l]"), //OpStore
+	INST(63, 0, "ii[l]"), //OpCopyMemory
+	INST(64, 0, "iii[l]"), //OpCopyMemorySized
+	INST_TYPED(65, P, "[i]"), //OpAccessChain
+	INST_TYPED(66, P, "[i]"), //OpInBoundsAccessChain
+	INST_TYPED(67, P, "[i]"), //OpPtrAccessChain
+	INST_TYPED(68, P, "il"), //OpArrayLength
+	INST_TYPED(70, P, "[i]"), //OpInBoundsPtrAccessChain
+
+	INST(71, 0, "il[l]"), //OpDecorate
+	INST(72, 0, "ill[l]"), //OpMemberDecorate
+	INST_RESULT(73, 0, ""), //OpDecorationGroup
+	INST(74, 0, "[i]"), //OpGroupDecorate
+	INST(75, 0, "[il]"), //OpGroupMemberDecorate
+
+	INST_TYPED(77, P, "ii"), //OpVectorExtractDynamic
+	INST_TYPED(78, P, "iii"), //OpVectorInsertDynamic
+	INST_TYPED(79, P, "ii[l]"), //OpVectorShuffle
+	INST_TYPED(80, P, "[i]"), //OpCompositeConstruct
+	INST_TYPED(81, P, "i[l]"), //OpCompositeExtract
+	INST_TYPED(82, P, "ii[l]"), //OpCompositeInsert
+	INST_TYPED(83, P, "i"), //OpCopyObject
+	INST_TYPED(84, P, "i"), //OpTranspose
+
+	INST_TYPED(86, P, "ii"), //OpSampledImage
+	INST_TYPED(87, R, "iil[i]"), //OpImageSampleImplicitLod, implicit lod depends on the neighbouring invocations
+	INST_TYPED(88, P, "iil[i]"), //OpImageSampleExplicitLod
+	INST_TYPED(89, R, "iiil[i]"), //OpImageSampleDrefImplicitLod
+	INST_TYPED(90, P, "iiil[i]"), //OpImageSampleDrefExplicitLod
+	INST_TYPED(91, R, "iil[i]"), //OpImageSampleProjImplicitLod
+	INST_TYPED(92, P, "iil[i]"), //OpImageSampleProjExplicitLod
+	INST_TYPED(93, R, "iiil[i]"), //OpImageSampleProjDrefImplicitLod
+	INST_TYPED(94, P, "iiil[i]"), //OpImageSampleProjDrefExplicitLod
+	INST_TYPED(95, P, "iil[i]"), //OpImageFetch
+	INST_TYPED(96, P, "iiil[i]"), //OpImageGather
+	INST_TYPED(97, P, "iiil[i]"), //OpImageDrefGather
+	INST_TYPED(98, R, "iil[i]"), //OpImageRead
+	INST(99, 0, "iiil[i]"), //OpImageWrite
+	INST_TYPED(100, P, "i"), //OpImage
+	INST_TYPED(101, P, "i"), //OpImageQueryFormat
+	INST_TYPED(102, P, "i"), //OpImageQueryOrder
+	INST_TYPED(103, P, "ii"), //OpImageQuerySizeLod
+	INST_TYPED(104, P, "i"), //OpImageQuerySize
+	INST_TYPED(105, R, "ii"), //OpImageQueryLod
+	INST_TYPED(106, P, "i"), //OpImageQueryLevels
+	INST_TYPED(107, P, "i"), //OpImageQuerySamples
+
+	INST_TYPED(109, P, "i"), //OpConvertFToU
+	INST_TYPED(110, P, "i"), //OpConvertFToS
+	INST_TYPED(111, P, "i"), //OpConvertSToF
+	INST_TYPED(112, P, "i"), //OpConvertUToF
+	INST_TYPED(113, P, "i"), //OpUConvert
+	INST_TYPED(114, P, "i"), //OpSConvert
+	INST_TYPED(115, P, "i"), //OpFConvert
+	INST_TYPED(116, P, "i"), //OpQuantizeToF16
+	INST_TYPED(124, P, "i"), //OpBitcast
+
+	INST_TYPED(126, P, "i"), //OpSNegate
+	INST_TYPED(127, P, "i"), //OpFNegate
+	INST_TYPED(128, P, "ii"), //OpIAdd
+	INST_TYPED(129, P, "ii"), //OpFAdd
+	INST_TYPED(130, P, "ii"), //OpISub
+	INST_TYPED(131, P, "ii"), //OpFSub
+	INST_TYPED(132, P, "ii"), //OpIMul
+	INST_TYPED(133, P, "ii"), //OpFMul
+	INST_TYPED(134, P, "ii"), //OpUDiv
+	INST_TYPED(135, P, "ii"), //OpSDiv
+	INST_TYPED(136, P, "ii"), //OpFDiv
+	INST_TYPED(137, P, "ii"), //OpUMod
+	INST_TYPED(138, P, "ii"), //OpSRem
+	INST_TYPED(139, P, "ii"), //OpSMod
+	INST_TYPED(140, P, "ii"), //OpFRem
+	INST_TYPED(141, P, "ii"), //OpFMod
+	INST_TYPED(142, P, "ii"), //OpVectorTimesScalar
+	INST_TYPED(143, P, "ii"), //OpMatrixTimesScalar
+	INST_TYPED(144, P, "ii"), //OpVectorTimesMatrix
+	INST_TYPED(145, P, "ii"), //OpMatrixTimesVector
+	INST_TYPED(146, P, "ii"), //OpMatrixTimesMatrix
+	INST_TYPED(147, P, "ii"), //OpOuterProduct
+	INST_TYPED(148, P, "ii"), //OpDot
+	INST_TYPED(149, P, "ii"), //OpIAddCarry
+	INST_TYPED(150, P, "ii"), //OpISubBorrow
+	INST_TYPED(151, P, "ii"), //OpUMulExtended
+	INST_TYPED(152, P, "ii"), //OpSMulExtended
+
+	INST_TYPED(154, P, "i"), //OpAny
+	INST_TYPED(155, P, "i"), //OpAll
+	INST_TYPED(156, P, "i"), //OpIsNan
+	INST_TYPED(157, P, "i"), //OpIsInf
+	INST_TYPED(158, P, "i"), //OpIsFinite
+	INST_TYPED(159, P, "i"), //OpIsNormal
+	INST_TYPED(160, P, "i"), //OpSignBitSet
+	INST_TYPED(161, P, "ii"), //OpLessOrGreater
+	INST_TYPED(162, P, "ii"), //OpOrdered
+	INST_TYPED(163, P, "ii"), //OpUnordered
+	INST_TYPED(164, P, "ii"), //OpLogicalEqual
+	INST_TYPED(165, P, "ii"), //OpLogicalNotEqual
+	INST_TYPED(166, P, "ii"), //OpLogicalOr
+	INST_TYPED(167, P, "ii"), //OpLogicalAnd
+	INST_TYPED(168, P, "i"), //OpLogicalNot
+	INST_TYPED(169, P, "iii"), //OpSelect
+	INST_TYPED(170, P, "ii"), //OpIEqual
+	INST_TYPED(171, P, "ii"), //OpINotEqual
+	INST_TYPED(172, P, "ii"), //OpUGreaterThan
+	INST_TYPED(173, P, "ii"), //OpSGreaterThan
+	INST_TYPED(174, P, "ii"), //OpUGreaterThanEqual
+	INST_TYPED(175, P, "ii"), //OpSGreaterThanEqual
+	INST_TYPED(176, P, "ii"), //OpULessThan
+	INST_TYPED(177, P, "ii"), //OpSLessThan
+	INST_TYPED(178, P, "ii"), //OpULessThanEqual
+	INST_TYPED(179, P, "ii"), //OpSLessThanEqual
+	INST_TYPED(180, P, "ii"), //OpFOrdEqual
+	INST_TYPED(181, P, "ii"), //OpFUnordEqual
+	INST_TYPED(182, P, "ii"), //OpFOrdNotEqual
+	INST_TYPED(183, P, "ii"), //OpFUnordNotEqual
+	INST_TYPED(184, P, "ii"), //OpFOrdLessThan
+	INST_TYPED(185, P, "ii"), //OpFUnordLessThan
+	INST_TYPED(186, P, "ii"), //OpFOrdGreaterThan
+	INST_TYPED(187, P, "ii"), //OpFUnordGreaterThan
+	INST_TYPED(188, P, "ii"), //OpFOrdLessThanEqual
+	INST_TYPED(189, P, "ii"), //OpFUnordLessThanEqual
+	INST_TYPED(190, P, "ii"), //OpFOrdGreaterThanEqual
+	INST_TYPED(191, P, "ii"), //OpFUnordGreaterThanEqual
+
+	INST_TYPED(194, P, "ii"), //OpShiftRightLogical
+	INST_TYPED(195, P, "ii"), //OpShiftRightArithmetic
+	INST_TYPED(196, P, "ii"), //OpShiftLeftLogical
+	INST_TYPED(197, P, "ii"), //OpBitwiseOr
+	INST_TYPED(198, P, "ii"), //OpBitwiseXor
+	INST_TYPED(199, P, "ii"), //OpBitwiseAnd
+	INST_TYPED(200, P, "i"), //OpNot
+	INST_TYPED(201, P, "iiii"), //OpBitFieldInsert
+	INST_TYPED(202, P, "iii"), //OpBitFieldSExtract
+	INST_TYPED(203, P, "iii"), //OpBitFieldUExtract
+	INST_TYPED(204, P, "i"), //OpBitReverse
+	INST_TYPED(205, P, "i"), //OpBitCount
+
+	//Derivatives depend on the neighbouring invocations
+	INST_TYPED(207, R, "i"), //OpDPdx
+	INST_TYPED(208, R, "i"), //OpDPdy
+	INST_TYPED(209, R, "i"), //OpFwidth
+	INST_TYPED(210, R, "i"), //OpDPdxFine
+	INST_TYPED(211, R, "i"), //OpDPdyFine
+	INST_TYPED(212, R, "i"), //OpFwidthFine
+	INST_TYPED(213, R, "i"), //OpDPdxCoarse
+	INST_TYPED(214, R, "i"), //OpDPdyCoarse
+	INST_TYPED(215, R, "i"), //OpFwidthCoarse
+
+	INST(224, 0, "iii"), //OpControlBarrier
+	INST(225, 0, "ii"), //OpMemoryBarrier
+
+	INST_TYPED(227, 0, "iii"), //OpAtomicLoad
+	INST(228, 0, "iiii"), //OpAtomicStore
+	INST_TYPED(229, 0, "iiii"), //OpAtomicExchange
+	INST_TYPED(230, 0, "iiiiii"), //OpAtomicCompareExchange
+	INST_TYPED(231, 0, "iiiiii"), //OpAtomicCompareExchangeWeak
+	INST_TYPED(232, 0, "iii"), //OpAtomicIIncrement
+	INST_TYPED(233, 0, "iii"), //OpAtomicIDecrement
+	INST_TYPED(234, 0, "iiii"), //OpAtomicIAdd
+	INST_TYPED(235, 0, "iiii"), //OpAtomicISub
+	INST_TYPED(236, 0, "iiii"), //OpAtomicSMin
+	INST_TYPED(237, 0, "iiii"), //OpAtomicUMin
+	INST_TYPED(238, 0, "iiii"), //OpAtomicSMax
+	INST_TYPED(239, 0, "iiii"), //OpAtomicUMax
+	INST_TYPED(240, 0, "iiii"), //OpAtomicAnd
+	INST_TYPED(241, 0, "iiii"), //OpAtomicOr
+	INST_TYPED(242, 0, "iiii"), //OpAtomicXor
+
+	INST_TYPED(245, R, "[i]"), //OpPhi
+	INST(246, 0, "iil[l]"), //OpLoopMerge
+	INST(247, 0, "il"), //OpSelectionMerge
+	INST_RESULT(248, 0, ""), //OpLabel
+	INST(249, T, "i"), //OpBranch
+	INST(250, T, "iii[l]"), //OpBranchConditional
+	INST(251, T, "ii[li]"), //OpSwitch, only 32 bit selectors
+	INST(252, T, ""), //OpKill
+	INST(253, T, ""), //OpReturn
+	INST(254, T, "i"), //OpReturnValue
+	INST(255, T, ""), //OpUnreachable
+
+	INST(317, 0, ""), //OpNoLine
+	INST(331, 0, "il[i]"), //OpExecutionModeId
+	INST(332, 0, "il[i]"), //OpDecorateId
+};
+
+#define THC_IR_OPCODE_TABLE_SIZE 333
+
+const OpCodeInfo* GetOpCodeInfo(uint32 opCode) {
+	struct Table {
+		const OpCodeInfo* infos[THC_IR_OPCODE_TABLE_SIZE];
+
+		Table() {
+			memset(infos, 0, sizeof(infos));
+
+			for (const OpCodeEntry& entry : opCodeEntries) {
+				infos[entry.opCode] = &entry.info;
+			}
+		}
+	};
+
+	static const Table table;
+
+	return opCode < THC_IR_OPCODE_TABLE_SIZE ? table.infos[opCode] : nullptr;
+}
+
+}
+}
+}
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+#include <core/compiler/options.h>
+#include <util/log.h>
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+using namespace compiler;
+
+void Optimizer::Run(Module& module) {
+	module.BuildDefUse();
+
+	InlineFunctions(module);
+	PropagatePrecision(module);
+	PromoteVariables(module);
+	//Loads are replaced by the stored values, phis joining relaxed values are new
+	PropagatePrecision(module);
+	CoalesceShuffles(module);
+	SimplifyArithmetic(module);
+	SimplifyControlFlow(module);
+	ReassociateMatrices(module);
+	if (CompilerOptions::Float16()) DemotePrecision(module);
+	NumberValues(module);
+	EliminateDeadCode(module);
+
+	Renumber(module);
+}
+
+bool Optimizer::Run(List<uint32>& code, uint64 offset) {
+	Module module;
+
+	if (!module.Load(code.GetData() + offset, code.GetCount() - offset)) {
+		Log::Warning("Optimizer can't load the module, skipping optimizations");
+		return false;
+	}
+
+	Run(module);
+
+	code.Resize(offset);
+	module.Write(code);
+
+	return true;
+}
+
+}
+}
+}
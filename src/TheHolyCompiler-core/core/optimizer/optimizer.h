@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "ir.h"
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+class Optimizer {
+private:
+	//Renumbers all ids densely in the order they first appear so the bound is as small as possible
+	static void Renumber(Module& module);
+
+	//Inlines calls to functions that are called once or are smaller than the inline threshold
+	static void InlineFunctions(Module& module);
+
+	//Replaces function variables that are only loaded and stored with SSA values
+	static void PromoteVariables(Module& module);
+
+	//Decorates loads of relaxed memory and results computed only from relaxed values and constants with RelaxedPrecision
+	static void PropagatePrecision(Module& module);
+
+	//Fuses chains of shuffles, forwards extracts to the component they read and removes identity shuffles
+	static void CoalesceShuffles(Module& module);
+
+	//Removes arithmetic identities, turns multiplications and divisions by powers of two into shifts and cancels repeated negations and conversions
+	static void SimplifyArithmetic(Module& module);
+
+	//Folds constant branches, merges straight chains of blocks, skips empty blocks and turns small if statements into selects
+	static void SimplifyControlFlow(Module& module);
+
+	//Rewrites matrix products so they take the fewest multiplications, products ending in a vector become matrix vector products
+	static void ReassociateMatrices(Module& module);
+
+	//Computes chains of relaxed float arithmetic with 16 bit floats, values entering or leaving a chain are converted
+	static void DemotePrecision(Module& module);
+
+	//Merges identical pure instructions and loads of unchanged memory, walking the dominator tree of each function
+	static void NumberValues(Module& module);
+
+	//Removes functions, globals, types and constants nothing live refers to, along with their names and decorations
+	static void EliminateDeadCode(Module& module);
+
+	//Removes types, constants and extended instruction set imports nothing refers to, along with their names and decorations. Spec constants and variables are kept
+	static void RemoveUnusedTypes(Module& module);
+
+	//Moves small varyings of the same component type and interpolation into shared locations, the inputs of the fragment stage are moved with them, then closes up the locations left unused
+	static void PackVaryings(Module& vertex, Module& fragment);
+
+	//Removes fragment inputs that are never read, then the vertex outputs nothing reads and the code computing them
+	static void LinkStages(Module& vertex, Module& fragment);
+
+public:
+	//Runs all passes on the module
+	static void Run(Module& module);
+
+	//Loads the module encoded at offset, optimizes it and writes it back. Returns false and leaves code untouched if the module can't be loaded
+	static bool Run(utils::List<uint32>& code, uint64 offset = 0);
+
+	//Same as Run but only removes unused types and constants and renumbers the ids
+	static bool Compact(utils::List<uint32>& code, uint64 offset = 0);
+
+	//Loads both stages, links them and writes them back. Returns false and leaves the code untouched if either can't be loaded
+	static bool Link(utils::List<uint32>& vertex, utils::List<uint32>& fragment);
+};
+
+}
+}
+}
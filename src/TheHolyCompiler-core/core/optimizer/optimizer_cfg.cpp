@@ -0,0 +1,545 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "optimizer.h"
+
+#define THC_SELECT_MAX_INSTRUCTIONS 8
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+//Merge blocks and continue targets must keep their label, the merge instruction refers to it
+static bool IsMergeTarget(const Module& module, const BasicBlock* block) {
+	uint32 id = block->GetId();
+
+	for (Use* use = module.GetUses(id); use; use = use->next) {
+		if (!Module::IsLive(use, id)) continue;
+
+		uint32 opCode = use->user->opCode;
+
+		if (opCode == THC_SPIRV_OPCODE_OpSelectionMerge || opCode == THC_SPIRV_OPCODE_OpLoopMerge) return true;
+	}
+
+	return false;
+}
+
+//Returns the loop header if the block is the continue target of a loop
+static BasicBlock* GetContinuedLoop(const Module& module, const BasicBlock* block) {
+	uint32 id = block->GetId();
+
+	for (Use* use = module.GetUses(id); use; use = use->next) {
+		if (Module::IsLive(use, id) && use->user->opCode == THC_SPIRV_OPCODE_OpLoopMerge && use->operand == use->user->operands + 1) return use->user->block;
+	}
+
+	return nullptr;
+}
+
+static void RemovePhiEntries(Module& module, BasicBlock* block, uint32 predecessorId) {
+	for (Instruction* phi = block->instructions.first; phi && phi->opCode == THC_SPIRV_OPCODE_OpPhi; phi = phi->next) {
+		List<uint32> operands(phi->operandCount);
+
+		for (uint32 i = 0; i < phi->operandCount; i += 2) {
+			if (phi->operands[i + 1] == predecessorId) continue;
+
+			operands.Add(phi->operands[i]);
+			operands.Add(phi->operands[i + 1]);
+		}
+
+		if (operands.GetCount() != phi->operandCount) module.SetOperands(phi, (uint32)operands.GetCount(), operands.GetData());
+	}
+}
+
+static void ClearBlock(Module& module, BasicBlock* block) {
+	for (uint64 i = 0; i < block->successors.GetCount(); i++) {
+		RemovePhiEntries(module, block->successors[i], block->GetId());
+	}
+
+	while (block->instructions.first) {
+		module.Remove(block->instructions.first);
+	}
+}
+
+//Unreachable merge blocks and continue targets are kept but emptied, so nothing in them refers to the removed blocks
+static bool RemoveUnreachableBlocks(Module& module, Function* function) {
+	bool changed = false;
+
+	for (uint64 i = 1; i < function->blocks.GetCount(); i++) {
+		BasicBlock* block = function->blocks[i];
+
+		if (block->IsReachable()) continue;
+
+		if (!IsMergeTarget(module, block)) {
+			ClearBlock(module, block);
+			module.RemoveBlock(block);
+
+			i--;
+			changed = true;
+			continue;
+		}
+
+		BasicBlock* header = GetContinuedLoop(module, block);
+		Instruction* first = block->instructions.first;
+
+		if (header) {
+			uint32 headerId = header->GetId();
+
+			if (first && first == block->instructions.last && first->opCode == THC_SPIRV_OPCODE_OpBranch && first->operands[0] == headerId) continue;
+
+			ClearBlock(module, block);
+			module.Add(block, module.CreateInstruction(THC_SPIRV_OPCODE_OpBranch, 0, 0, 1, &headerId));
+
+			//The back edge still exists, the values along it are gone
+			for (Instruction* phi = header->instructions.first; phi && phi->opCode == THC_SPIRV_OPCODE_OpPhi; phi = phi->next) {
+				List<uint32> merged(phi->operandCount + 2);
+
+				for (uint32 j = 0; j < phi->operandCount; j++) {
+					merged.Add(phi->operands[j]);
+				}
+
+				merged.Add(module.GetUndef(phi->resultType));
+				merged.Add(block->GetId());
+
+				module.SetOperands(phi, (uint32)merged.GetCount(), merged.GetData());
+			}
+		} else {
+			if (first && first == block->instructions.last && first->opCode == THC_SPIRV_OPCODE_OpUnreachable) continue;
+
+			ClearBlock(module, block);
+			module.Add(block, module.CreateInstruction(THC_SPIRV_OPCODE_OpUnreachable, 0, 0, 0));
+		}
+
+		changed = true;
+	}
+
+	return changed;
+}
+
+//Only 32 bit scalars are handled
+static bool GetScalarConstant(const Module& module, uint32 id, uint32& value) {
+	Instruction* def = module.GetDef(id);
+
+	if (!def) return false;
+
+	if (def->opCode == THC_SPIRV_OPCODE_OpConstantNull) {
+		value = 0;
+		return true;
+	}
+
+	if (def->opCode != THC_SPIRV_OPCODE_OpConstant || def->operandCount != 1) return false;
+
+	value = def->operands[0];
+
+	return true;
+}
+
+//The front end doesn't fold comparisons, so a condition on constants is evaluated here. Returns false if it isn't constant
+static bool EvaluateCondition(const Module& module, uint32 id, bool& result) {
+	Instruction* def = module.GetDef(id);
+
+	if (!def) return false;
+
+	switch (def->opCode) {
+		case THC_SPIRV_OPCODE_OpConstantTrue:
+			result = true;
+			return true;
+		case THC_SPIRV_OPCODE_OpConstantFalse:
+		case THC_SPIRV_OPCODE_OpConstantNull:
+			result = false;
+			return true;
+		case THC_SPIRV_OPCODE_OpLogicalNot:
+			if (!EvaluateCondition(module, def->operands[0], result)) return false;
+
+			result = !result;
+			return true;
+		case THC_SPIRV_OPCODE_OpLogicalAnd:
+		case THC_SPIRV_OPCODE_OpLogicalOr:
+		case THC_SPIRV_OPCODE_OpLogicalEqual:
+		case THC_SPIRV_OPCODE_OpLogicalNotEqual:
+		{
+			bool a;
+			bool b;
+
+			if (!EvaluateCondition(module, def->operands[0], a) || !EvaluateCondition(module, def->operands[1], b)) return false;
+
+			switch (def->opCode) {
+				case THC_SPIRV_OPCODE_OpLogicalAnd: result = a && b; break;
+				case THC_SPIRV_OPCODE_OpLogicalOr: result = a || b; break;
+				case THC_SPIRV_OPCODE_OpLogicalEqual: result = a == b; break;
+				case THC_SPIRV_OPCODE_OpLogicalNotEqual: result = a != b; break;
+			}
+
+			return true;
+		}
+	}
+
+	if (def->operandCount != 2) return false;
+
+	uint32 a;
+	uint32 b;
+
+	if (!GetScalarConstant(module, def->operands[0], a) || !GetScalarConstant(module, def->operands[1], b)) return false;
+
+	int32 sa = *(int32*)&a;
+	int32 sb = *(int32*)&b;
+	float32 fa = *(float32*)&a;
+	float32 fb = *(float32*)&b;
+
+	//Comparisons with NaN are already false in C++ except for !=, which has to be ordered explicitly
+	switch (def->opCode) {
+		case THC_SPIRV_OPCODE_OpIEqual: result = a == b; break;
+		case THC_SPIRV_OPCODE_OpINotEqual: result = a != b; break;
+		case THC_SPIRV_OPCODE_OpUGreaterThan: result = a > b; break;
+		case THC_SPIRV_OPCODE_OpUGreaterThanEqual: result = a >= b; break;
+		case THC_SPIRV_OPCODE_OpULessThan: result = a < b; break;
+		case THC_SPIRV_OPCODE_OpULessThanEqual: result = a <= b; break;
+		case THC_SPIRV_OPCODE_OpSGreaterThan: result = sa > sb; break;
+		case THC_SPIRV_OPCODE_OpSGreaterThanEqual: result = sa >= sb; break;
+		case THC_SPIRV_OPCODE_OpSLessThan: result = sa < sb; break;
+		case THC_SPIRV_OPCODE_OpSLessThanEqual: result = sa <= sb; break;
+		case THC_SPIRV_OPCODE_OpFOrdEqual: result = fa == fb; break;
+		case THC_SPIRV_OPCODE_OpFOrdNotEqual: result = fa == fa && fb == fb && fa != fb; break;
+		case THC_SPIRV_OPCODE_OpFOrdLessThan: result = fa < fb; break;
+		case THC_SPIRV_OPCODE_OpFOrdLessThanEqual: result = fa <= fb; break;
+		case THC_SPIRV_OPCODE_OpFOrdGreaterThan: result = fa > fb; break;
+		case THC_SPIRV_OPCODE_OpFOrdGreaterThanEqual: result = fa >= fb; break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+//Branches on constant conditions become unconditional, so do branches where both targets are the same
+static bool FoldBranch(Module& module, BasicBlock* block) {
+	Instruction* terminator = block->GetTerminator();
+
+	if (!terminator || terminator->opCode != THC_SPIRV_OPCODE_OpBranchConditional) return false;
+
+	uint32 target = 0;
+	bool condition;
+
+	if (terminator->operands[1] == terminator->operands[2]) {
+		target = terminator->operands[1];
+	} else if (EvaluateCondition(module, terminator->operands[0], condition)) {
+		target = terminator->operands[condition ? 1 : 2];
+	}
+
+	if (target == 0) {
+		//Equal weights carry no information
+		if (terminator->operandCount != 5 || terminator->operands[3] != terminator->operands[4]) return false;
+
+		module.SetOperands(terminator, 3, terminator->operands);
+
+		return true;
+	}
+
+	uint32 skipped = terminator->operands[1] == target ? terminator->operands[2] : terminator->operands[1];
+
+	if (skipped != target) RemovePhiEntries(module, module.GetBlock(skipped), block->GetId());
+
+	terminator->opCode = THC_SPIRV_OPCODE_OpBranch;
+	module.SetOperands(terminator, 1, &target);
+
+	//A loop header keeps its merge, the loop is still there even if it's never entered again
+	Instruction* merge = block->GetMerge();
+
+	if (merge && merge->opCode == THC_SPIRV_OPCODE_OpSelectionMerge) module.Remove(merge);
+
+	return true;
+}
+
+//Removes phis where every incoming value is the same
+static bool SimplifyPhis(Module& module, BasicBlock* block) {
+	bool changed = false;
+
+	for (Instruction* phi = block->instructions.first; phi && phi->opCode == THC_SPIRV_OPCODE_OpPhi;) {
+		Instruction* next = phi->next;
+		uint32 value = 0;
+		bool unique = true;
+
+		for (uint32 i = 0; i < phi->operandCount; i += 2) {
+			uint32 incoming = phi->operands[i];
+
+			if (incoming == phi->result || incoming == value) continue;
+
+			if (value) unique = false;
+
+			value = incoming;
+		}
+
+		if (unique && value) {
+			module.ReplaceAllUses(phi->result, value);
+			module.Remove(phi);
+
+			changed = true;
+		}
+
+		phi = next;
+	}
+
+	return changed;
+}
+
+//Executing the instruction when the branch it's in isn't taken must not be observable
+static bool IsSpeculatable(const Instruction* inst) {
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpUDiv:
+		case THC_SPIRV_OPCODE_OpSDiv:
+		case THC_SPIRV_OPCODE_OpUMod:
+		case THC_SPIRV_OPCODE_OpSRem:
+		case THC_SPIRV_OPCODE_OpSMod:
+			return false;
+	}
+
+	return inst->result && inst->HasFlag(THC_IR_FLAG_PURE);
+}
+
+//A side of an if is either the merge block itself or a single block that only computes values and branches to the merge
+static bool IsSelectableSide(const BasicBlock* side, const BasicBlock* header, const BasicBlock* merge, uint32& count) {
+	if (side == merge) return true;
+
+	if (side->predecessors.GetCount() != 1 || side->predecessors[0] != header) return false;
+
+	Instruction* terminator = side->GetTerminator();
+
+	if (terminator->opCode != THC_SPIRV_OPCODE_OpBranch || terminator->operands[0] != merge->GetId()) return false;
+
+	for (Instruction* inst = side->instructions.first; inst != terminator; inst = inst->next) {
+		if (!IsSpeculatable(inst)) return false;
+
+		count++;
+	}
+
+	return true;
+}
+
+//OpSelect only works on scalars and vectors
+static bool IsSelectable(const Module& module, uint32 typeId) {
+	Instruction* type = module.GetDef(typeId);
+
+	switch (type->opCode) {
+		case THC_SPIRV_OPCODE_OpTypeBool:
+		case THC_SPIRV_OPCODE_OpTypeInt:
+		case THC_SPIRV_OPCODE_OpTypeFloat:
+		case THC_SPIRV_OPCODE_OpTypeVector:
+			return true;
+	}
+
+	return false;
+}
+
+//Turns an if where both sides only compute values into selects in the header, no divergent branch is left
+static bool ConvertToSelect(Module& module, BasicBlock* header) {
+	Instruction* merge = header->GetMerge();
+	Instruction* terminator = header->GetTerminator();
+
+	if (!merge || merge->opCode != THC_SPIRV_OPCODE_OpSelectionMerge || terminator->opCode != THC_SPIRV_OPCODE_OpBranchConditional) return false;
+
+	BasicBlock* mergeBlock = module.GetBlock(merge->operands[0]);
+	BasicBlock* trueBlock = module.GetBlock(terminator->operands[1]);
+	BasicBlock* falseBlock = module.GetBlock(terminator->operands[2]);
+
+	if (trueBlock == falseBlock || mergeBlock->predecessors.GetCount() != 2) return false;
+
+	uint32 count = 0;
+
+	if (!IsSelectableSide(trueBlock, header, mergeBlock, count) || !IsSelectableSide(falseBlock, header, mergeBlock, count)) return false;
+	if (count > THC_SELECT_MAX_INSTRUCTIONS) return false;
+
+	for (Instruction* phi = mergeBlock->instructions.first; phi && phi->opCode == THC_SPIRV_OPCODE_OpPhi; phi = phi->next) {
+		if (!IsSelectable(module, phi->resultType)) return false;
+	}
+
+	BasicBlock* sides[] = { trueBlock, falseBlock };
+
+	for (BasicBlock* side : sides) {
+		if (side == mergeBlock) continue;
+
+		while (side->instructions.first != side->GetTerminator()) {
+			module.InsertBefore(merge, side->instructions.first);
+		}
+	}
+
+	uint32 condition = terminator->operands[0];
+	uint32 trueId = trueBlock == mergeBlock ? header->GetId() : trueBlock->GetId();
+	uint32 boolType = module.GetDef(condition)->resultType;
+
+	//Before SPIR-V 1.4 the condition must have as many components as the result
+	uint32 conditions[5] = { 0, condition, 0, 0, 0 };
+
+	while (mergeBlock->instructions.first->opCode == THC_SPIRV_OPCODE_OpPhi) {
+		Instruction* phi = mergeBlock->instructions.first;
+		Instruction* type = module.GetDef(phi->resultType);
+
+		uint32 components = type->opCode == THC_SPIRV_OPCODE_OpTypeVector ? type->operands[1] : 1;
+
+		if (conditions[components] == 0) {
+			uint32 vectorOperands[] = { boolType, components };
+			uint32 splat[] = { condition, condition, condition, condition };
+
+			Instruction* construct = module.CreateInstruction(THC_SPIRV_OPCODE_OpCompositeConstruct, module.GetType(THC_SPIRV_OPCODE_OpTypeVector, 2, vectorOperands), module.NewId(), components, splat);
+
+			module.InsertBefore(merge, construct);
+
+			conditions[components] = construct->result;
+		}
+
+		uint32 operands[] = { conditions[components], 0, 0 };
+
+		for (uint32 i = 0; i < phi->operandCount; i += 2) {
+			operands[phi->operands[i + 1] == trueId ? 1 : 2] = phi->operands[i];
+		}
+
+		Instruction* select = module.CreateInstruction(THC_SPIRV_OPCODE_OpSelect, phi->resultType, module.NewId(), 3, operands);
+
+		module.InsertBefore(merge, select);
+		module.ReplaceAllUses(phi->result, select->result);
+		module.Remove(phi);
+	}
+
+	uint32 mergeId = mergeBlock->GetId();
+
+	terminator->opCode = THC_SPIRV_OPCODE_OpBranch;
+	module.SetOperands(terminator, 1, &mergeId);
+	module.Remove(merge);
+
+	for (BasicBlock* side : sides) {
+		if (side != mergeBlock) module.RemoveBlock(side);
+	}
+
+	return true;
+}
+
+//Appends the only successor to the block if the block is its only predecessor
+static bool MergeBlock(Module& module, Function* function, BasicBlock* block) {
+	Instruction* terminator = block->GetTerminator();
+
+	if (!terminator || terminator->opCode != THC_SPIRV_OPCODE_OpBranch || block->GetMerge()) return false;
+
+	BasicBlock* next = module.GetBlock(terminator->operands[0]);
+
+	if (next == block || next->predecessors.GetCount() != 1 || IsMergeTarget(module, next)) return false;
+
+	//Blocks must come after their dominator, the merged block takes the place of the first one
+	if (function->blocks.Find(next) < function->blocks.Find(block)) return false;
+
+	//The block would become a header, keep continue targets simple
+	if (next->GetMerge() && GetContinuedLoop(module, block)) return false;
+
+	while (next->instructions.first && next->instructions.first->opCode == THC_SPIRV_OPCODE_OpPhi) {
+		Instruction* phi = next->instructions.first;
+
+		module.ReplaceAllUses(phi->result, phi->operands[0]);
+		module.Remove(phi);
+	}
+
+	module.Remove(terminator);
+
+	while (next->instructions.first) {
+		module.Add(block, next->instructions.first);
+	}
+
+	//Phis in the successors now come from this block
+	module.ReplaceAllUses(next->GetId(), block->GetId());
+	module.RemoveBlock(next);
+
+	return true;
+}
+
+//Sends the predecessors of a block that only branches straight to the target
+static bool SkipEmptyBlock(Module& module, Function* function, BasicBlock* block) {
+	Instruction* terminator = block->GetTerminator();
+
+	if (block == function->blocks[0] || !terminator || terminator != block->instructions.first || terminator->opCode != THC_SPIRV_OPCODE_OpBranch) return false;
+
+	BasicBlock* target = module.GetBlock(terminator->operands[0]);
+
+	if (target == block || IsMergeTarget(module, block)) return false;
+
+	bool phis = target->instructions.first->opCode == THC_SPIRV_OPCODE_OpPhi;
+
+	//The incoming values of the phis can only be moved to a single new predecessor
+	if (phis && (block->predecessors.GetCount() != 1 || target->predecessors.Find(block->predecessors[0]) != ~0)) return false;
+
+	uint32 id = block->GetId();
+	uint32 targetId = target->GetId();
+
+	//A header may only branch past the block straight to its own merge block
+	for (uint64 i = 0; i < block->predecessors.GetCount(); i++) {
+		Instruction* merge = block->predecessors[i]->GetMerge();
+
+		if (merge && merge->operands[0] != targetId) return false;
+	}
+
+	for (uint64 i = 0; i < block->predecessors.GetCount(); i++) {
+		Instruction* branch = block->predecessors[i]->GetTerminator();
+
+		branch->ForEachId([&](uint32& operand) {
+			if (operand == id) module.SetOperand(branch, (uint32)(&operand - branch->operands), targetId);
+		});
+	}
+
+	if (phis) {
+		uint32 predecessorId = block->predecessors[0]->GetId();
+
+		for (Instruction* phi = target->instructions.first; phi->opCode == THC_SPIRV_OPCODE_OpPhi; phi = phi->next) {
+			for (uint32 i = 1; i < phi->operandCount; i += 2) {
+				if (phi->operands[i] == id) module.SetOperand(phi, i, predecessorId);
+			}
+		}
+	}
+
+	module.RemoveBlock(block);
+
+	return true;
+}
+
+void Optimizer::SimplifyControlFlow(Module& module) {
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		bool changed = true;
+
+		//Every change invalidates the CFG, it's rebuilt before the next one
+		while (changed) {
+			module.BuildCFG(function);
+			module.BuildDominators(function);
+
+			changed = RemoveUnreachableBlocks(module, function);
+
+			for (uint64 j = 0; !changed && j < function->blocks.GetCount(); j++) {
+				BasicBlock* block = function->blocks[j];
+
+				changed = FoldBranch(module, block) || SimplifyPhis(module, block) || ConvertToSelect(module, block) || MergeBlock(module, function, block) || SkipEmptyBlock(module, function, block);
+			}
+		}
+	}
+}
+
+}
+}
+}
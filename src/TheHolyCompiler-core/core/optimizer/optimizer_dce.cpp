@@ -0,0 +1,220 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+void Optimizer::EliminateDeadCode(Module& module) {
+	List<uint8> live(module.bound);
+
+	for (uint32 i = 0; i < module.bound; i++) {
+		live.Add(0);
+	}
+
+	Map<uint32, Function*> functions(module.functions.GetCount() * 2);
+
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		functions.Set(function->GetId(), function);
+	}
+
+	List<Instruction*> worklist(256);
+
+	auto markId = [&](uint32& id) {
+		if (live[id]) return;
+
+		live[id] = 1;
+
+		Instruction* def = module.GetDef(id);
+
+		if (def) worklist.Add(def);
+	};
+
+	//Everything in the header is needed, the entry points and execution modes mark the functions and interface variables
+	for (Instruction* inst = module.header.first; inst; inst = inst->next) {
+		worklist.Add(inst);
+	}
+
+	//Only names and decorations are kept alive by their target, other debug and annotation instructions are roots
+	for (Instruction* inst = module.debug.first; inst; inst = inst->next) {
+		if (inst->opCode != THC_SPIRV_OPCODE_OpName && inst->opCode != THC_SPIRV_OPCODE_OpMemberName) worklist.Add(inst);
+	}
+
+	for (Instruction* inst = module.annotations.first; inst; inst = inst->next) {
+		if (inst->opCode != THC_SPIRV_OPCODE_OpDecorate && inst->opCode != THC_SPIRV_OPCODE_OpMemberDecorate) worklist.Add(inst);
+	}
+
+	while (worklist.GetCount()) {
+		Instruction* inst = worklist[worklist.GetCount() - 1];
+
+		worklist.RemoveAt(worklist.GetCount() - 1);
+
+		if (inst->result) live[inst->result] = 1;
+		if (inst->GetInfo()->hasResultType) markId(inst->resultType);
+
+		inst->ForEachId(markId);
+
+		if (inst->opCode != THC_SPIRV_OPCODE_OpFunction) continue;
+
+		//A live function keeps everything with side effects, the rest is only kept if a live instruction uses it
+		Function* function = *functions.Get(inst->result);
+
+		for (uint64 i = 0; i < function->parameters.GetCount(); i++) {
+			worklist.Add(function->parameters[i]);
+		}
+
+		for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+			BasicBlock* block = function->blocks[i];
+
+			live[block->GetId()] = 1;
+
+			for (Instruction* blockInst = block->instructions.first; blockInst; blockInst = blockInst->next) {
+				if (!module.IsRemovable(blockInst)) worklist.Add(blockInst);
+			}
+		}
+	}
+
+	for (uint64 i = 0; i < module.functions.GetCount();) {
+		Function* function = module.functions[i];
+
+		if (!live[function->GetId()]) {
+			module.RemoveFunction(function);
+			continue;
+		}
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			for (Instruction* inst = function->blocks[j]->instructions.first; inst;) {
+				Instruction* next = inst->next;
+
+				if (inst->result && !live[inst->result] && module.IsRemovable(inst)) module.Remove(inst);
+
+				inst = next;
+			}
+		}
+
+		i++;
+	}
+
+	for (Instruction* inst = module.globals.first; inst;) {
+		Instruction* next = inst->next;
+
+		if (inst->result && !live[inst->result]) module.Remove(inst);
+
+		inst = next;
+	}
+
+	InstructionList* targeted[] = { &module.debug, &module.annotations };
+
+	for (InstructionList* section : targeted) {
+		for (Instruction* inst = section->first; inst;) {
+			Instruction* next = inst->next;
+
+			switch (inst->opCode) {
+				case THC_SPIRV_OPCODE_OpName:
+				case THC_SPIRV_OPCODE_OpMemberName:
+				case THC_SPIRV_OPCODE_OpDecorate:
+				case THC_SPIRV_OPCODE_OpMemberDecorate:
+					if (!live[inst->operands[0]]) module.Remove(inst);
+					break;
+			}
+
+			inst = next;
+		}
+	}
+}
+
+
+void Optimizer::RemoveUnusedTypes(Module& module) {
+	List<uint32> uses(module.bound);
+	List<uint8> removed(module.bound);
+
+	for (uint32 i = 0; i < module.bound; i++) {
+		uses.Add(0);
+		removed.Add(0);
+	}
+
+	auto isTargeted = [](const Instruction* inst) -> bool {
+		return inst->opCode == THC_SPIRV_OPCODE_OpName || inst->opCode == THC_SPIRV_OPCODE_OpMemberName || inst->opCode == THC_SPIRV_OPCODE_OpDecorate || inst->opCode == THC_SPIRV_OPCODE_OpMemberDecorate;
+	};
+
+	auto isRemovable = [](const Instruction* inst) -> bool {
+		uint32 op = inst->opCode;
+
+		return (op >= THC_SPIRV_OPCODE_OpTypeVoid && op <= THC_SPIRV_OPCODE_OpTypeForwardPointer) || (op >= THC_SPIRV_OPCODE_OpConstantTrue && op <= THC_SPIRV_OPCODE_OpConstantNull) || op == THC_SPIRV_OPCODE_OpExtInstImport;
+	};
+
+	auto addUse = [&uses](uint32& id) { uses[id]++; };
+	auto removeUse = [&uses](uint32& id) { uses[id]--; };
+
+	//Names and decorations don't keep their target alive
+	module.ForEachInstruction([&](Instruction* inst) {
+		if (isTargeted(inst)) return;
+		if (inst->GetInfo()->hasResultType) addUse(inst->resultType);
+
+		inst->ForEachId(addUse);
+	});
+
+	InstructionList* sections[] = { &module.globals, &module.header };
+
+	//Operands are defined before their users, so walking backwards frees everything a removed instruction was the last user of
+	for (InstructionList* section : sections) {
+		for (Instruction* inst = section->last; inst;) {
+			Instruction* prev = inst->prev;
+
+			if (isRemovable(inst) && inst->result && uses[inst->result] == 0) {
+				if (inst->GetInfo()->hasResultType) removeUse(inst->resultType);
+
+				inst->ForEachId(removeUse);
+
+				removed[inst->result] = 1;
+				module.Remove(inst);
+			}
+
+			inst = prev;
+		}
+	}
+
+	InstructionList* targeted[] = { &module.debug, &module.annotations };
+
+	for (InstructionList* section : targeted) {
+		for (Instruction* inst = section->first; inst;) {
+			Instruction* next = inst->next;
+
+			if (isTargeted(inst) && removed[inst->operands[0]]) module.Remove(inst);
+
+			inst = next;
+		}
+	}
+}
+
+}
+}
+}
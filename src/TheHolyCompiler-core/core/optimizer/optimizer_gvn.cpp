@@ -0,0 +1,293 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+
+#define THC_GVN_DECORATED 1
+#define THC_GVN_RELAXED 2 //Only decorated with RelaxedPrecision, can be merged with other relaxed results
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+static bool IsCommutative(uint32 opCode) {
+	switch (opCode) {
+		case THC_SPIRV_OPCODE_OpIAdd:
+		case THC_SPIRV_OPCODE_OpFAdd:
+		case THC_SPIRV_OPCODE_OpIMul:
+		case THC_SPIRV_OPCODE_OpFMul:
+		case THC_SPIRV_OPCODE_OpDot:
+		case THC_SPIRV_OPCODE_OpBitwiseOr:
+		case THC_SPIRV_OPCODE_OpBitwiseXor:
+		case THC_SPIRV_OPCODE_OpBitwiseAnd:
+		case THC_SPIRV_OPCODE_OpLogicalEqual:
+		case THC_SPIRV_OPCODE_OpLogicalNotEqual:
+		case THC_SPIRV_OPCODE_OpLogicalOr:
+		case THC_SPIRV_OPCODE_OpLogicalAnd:
+		case THC_SPIRV_OPCODE_OpIEqual:
+		case THC_SPIRV_OPCODE_OpINotEqual:
+		case THC_SPIRV_OPCODE_OpFOrdEqual:
+		case THC_SPIRV_OPCODE_OpFUnordEqual:
+		case THC_SPIRV_OPCODE_OpFOrdNotEqual:
+		case THC_SPIRV_OPCODE_OpFUnordNotEqual:
+			return true;
+	}
+
+	return false;
+}
+
+static bool IsAccessChain(uint32 opCode) {
+	return opCode == THC_SPIRV_OPCODE_OpAccessChain || opCode == THC_SPIRV_OPCODE_OpInBoundsAccessChain || opCode == THC_SPIRV_OPCODE_OpPtrAccessChain;
+}
+
+//Two instructions have the same value if the keys are equal. version separates loads from different memory states
+struct ValueKey {
+	const Instruction* inst;
+	uint32 version;
+	bool relaxed;
+
+	ValueKey() : inst(nullptr), version(0), relaxed(false) {}
+	ValueKey(const Instruction* inst, uint32 version, bool relaxed = false) : inst(inst), version(version), relaxed(relaxed) {}
+
+	uint64 Hash() const {
+		uint64 hash = HashCombine(HashCombine(HashCombine(inst->opCode, inst->resultType), version), relaxed);
+
+		if (inst->operandCount == 2 && IsCommutative(inst->opCode)) {
+			uint32 a = inst->operands[0];
+			uint32 b = inst->operands[1];
+
+			return HashCombine(HashCombine(hash, a < b ? a : b), a < b ? b : a);
+		}
+
+		for (uint32 i = 0; i < inst->operandCount; i++) {
+			hash = HashCombine(hash, inst->operands[i]);
+		}
+
+		return hash;
+	}
+
+	bool operator==(const ValueKey& other) const {
+		const Instruction* o = other.inst;
+
+		if (inst->opCode != o->opCode || inst->resultType != o->resultType || version != other.version || relaxed != other.relaxed || inst->operandCount != o->operandCount) return false;
+
+		if (memcmp(inst->operands, o->operands, inst->operandCount * sizeof(uint32)) == 0) return true;
+
+		return inst->operandCount == 2 && IsCommutative(inst->opCode) && inst->operands[0] == o->operands[1] && inst->operands[1] == o->operands[0];
+	}
+};
+
+struct NumberingContext {
+	Module* module;
+
+	Map<ValueKey, uint32> values;
+
+	List<uint8> decorated; //Decorations belong to a single result, those are never merged except RelaxedPrecision
+	List<uint8> written; //Variables that are stored to or passed somewhere they could be written
+
+	uint32 versions;
+};
+
+static uint32 GetRootVariable(const Module& module, uint32 pointer) {
+	Instruction* def = module.GetDef(pointer);
+
+	while (def && (IsAccessChain(def->opCode) || def->opCode == THC_SPIRV_OPCODE_OpCopyObject)) {
+		pointer = def->operands[0];
+		def = module.GetDef(pointer);
+	}
+
+	return pointer;
+}
+
+static bool IsPointer(const Module& module, uint32 id) {
+	Instruction* def = module.GetDef(id);
+
+	if (!def || def->resultType == 0) return false;
+
+	Instruction* type = module.GetDef(def->resultType);
+
+	return type && type->opCode == THC_SPIRV_OPCODE_OpTypePointer;
+}
+
+//Returns true if memory may be different after the instruction
+static bool MayWrite(const Module& module, const Instruction* inst) {
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpSelectionMerge:
+		case THC_SPIRV_OPCODE_OpLoopMerge:
+		case THC_SPIRV_OPCODE_OpLine:
+		case THC_SPIRV_OPCODE_OpNoLine:
+			return false;
+	}
+
+	return !module.IsRemovable(inst) && !inst->HasFlag(THC_IR_FLAG_TERMINATOR);
+}
+
+static bool GetValueKey(NumberingContext& context, const Instruction* inst, uint32 version, ValueKey& key) {
+	Module& module = *context.module;
+
+	if (inst->result == 0 || context.decorated[inst->result] == THC_GVN_DECORATED) return false;
+
+	bool relaxed = context.decorated[inst->result] == THC_GVN_RELAXED;
+
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpLoad: {
+			Instruction* root = module.GetDef(GetRootVariable(module, inst->operands[0]));
+
+			//Nothing writes the variable, every load gives the same value
+			if (root && root->opCode == THC_SPIRV_OPCODE_OpVariable && !context.written[root->result]) version = 0;
+
+			key = ValueKey(inst, version, relaxed);
+			return true;
+		}
+		case THC_SPIRV_OPCODE_OpSampledImage:
+			//The result must be used in the block it's created in
+			key = ValueKey(inst, inst->block->GetId(), relaxed);
+			return true;
+		case THC_SPIRV_OPCODE_OpExtInst:
+			if (!module.IsRemovable(inst)) return false;
+
+			key = ValueKey(inst, 0, relaxed);
+			return true;
+	}
+
+	if (!inst->HasFlag(THC_IR_FLAG_PURE)) return false;
+
+	key = ValueKey(inst, 0, relaxed);
+
+	return true;
+}
+
+static void NumberBlock(NumberingContext& context, BasicBlock* block, uint32 version) {
+	Module& module = *context.module;
+
+	//Memory is only known to be unchanged when the block can only be entered from its dominator
+	if (block->predecessors.GetCount() != 1 || block->predecessors[0] != block->idom) version = ++context.versions;
+
+	List<ValueKey> added(32);
+
+	for (Instruction* inst = block->instructions.first; inst;) {
+		Instruction* next = inst->next;
+
+		ValueKey key;
+
+		if (GetValueKey(context, inst, version, key)) {
+			uint32* existing = context.values.Get(key);
+
+			if (existing) {
+				module.ReplaceAllUses(inst->result, *existing);
+				module.Remove(inst);
+			} else {
+				context.values.Set(key, inst->result);
+				added.Add(key);
+			}
+		} else if (MayWrite(module, inst)) {
+			version = ++context.versions;
+		}
+
+		inst = next;
+	}
+
+	for (uint64 i = 0; i < block->children.GetCount(); i++) {
+		NumberBlock(context, block->children[i], version);
+	}
+
+	for (uint64 i = 0; i < added.GetCount(); i++) {
+		context.values.Remove(added[i]);
+	}
+}
+
+void Optimizer::NumberValues(Module& module) {
+	NumberingContext context;
+
+	context.module = &module;
+	context.versions = 0;
+
+	context.decorated.Reserve(module.bound);
+	context.written.Reserve(module.bound);
+
+	for (uint32 i = 0; i < module.bound; i++) {
+		context.decorated.Add(0);
+		context.written.Add(0);
+	}
+
+	for (Instruction* inst = module.annotations.first; inst; inst = inst->next) {
+		if (inst->opCode == THC_SPIRV_OPCODE_OpDecorate && inst->operands[1] == THC_SPIRV_DECORATION_RELAXED_PRECISION) {
+			if (!context.decorated[inst->operands[0]]) context.decorated[inst->operands[0]] = THC_GVN_RELAXED;
+		} else if (inst->opCode == THC_SPIRV_OPCODE_OpDecorate || inst->opCode == THC_SPIRV_OPCODE_OpMemberDecorate) {
+			context.decorated[inst->operands[0]] = THC_GVN_DECORATED;
+		}
+	}
+
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			for (Instruction* inst = function->blocks[j]->instructions.first; inst; inst = inst->next) {
+				if (inst->opCode == THC_SPIRV_OPCODE_OpLoad || IsAccessChain(inst->opCode) || inst->opCode == THC_SPIRV_OPCODE_OpCopyObject) continue;
+
+				inst->ForEachId([&module, &context](uint32& id) {
+					if (IsPointer(module, id)) context.written[GetRootVariable(module, id)] = 1;
+				});
+			}
+		}
+	}
+
+	//Duplicate constants are merged first, they are visible to every function
+	for (Instruction* inst = module.globals.first; inst;) {
+		Instruction* next = inst->next;
+
+		if (inst->HasFlag(THC_IR_FLAG_PURE) && inst->result && !context.decorated[inst->result]) {
+			ValueKey key(inst, 0);
+
+			uint32* existing = context.values.Get(key);
+
+			if (existing) {
+				module.ReplaceAllUses(inst->result, *existing);
+				module.Remove(inst);
+			} else {
+				context.values.Set(key, inst->result);
+			}
+		}
+
+		inst = next;
+	}
+
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		if (function->blocks.GetCount() == 0) continue;
+
+		module.BuildCFG(function);
+		module.BuildDominators(function);
+
+		NumberBlock(context, function->blocks[0], 0);
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,234 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+#include <core/compiler/options.h>
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+using namespace compiler;
+
+//Callees are visited first so their own calls are inlined before their size is measured
+static void OrderFunctions(Module& module, Function* function, List<Function*>& visited, List<Function*>& order) {
+	if (visited.Find(function) != ~0) return;
+
+	visited.Add(function);
+
+	for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+		for (Instruction* inst = function->blocks[i]->instructions.first; inst; inst = inst->next) {
+			if (inst->opCode != THC_SPIRV_OPCODE_OpFunctionCall) continue;
+
+			for (uint64 j = 0; j < module.functions.GetCount(); j++) {
+				if (module.functions[j]->GetId() == inst->operands[0]) OrderFunctions(module, module.functions[j], visited, order);
+			}
+		}
+	}
+
+	order.Add(function);
+}
+
+static uint32 GetCallCount(const Module& module, uint32 functionId) {
+	uint32 count = 0;
+
+	for (Use* use = module.GetUses(functionId); use; use = use->next) {
+		if (Module::IsLive(use, functionId) && use->user->opCode == THC_SPIRV_OPCODE_OpFunctionCall) count++;
+	}
+
+	return count;
+}
+
+//Returns ~0 if the function can't be inlined. Only a single return in the last block is supported, an early return would have to leave the enclosing constructs
+static uint32 GetInlineCost(Function* function) {
+	if (function->blocks.GetCount() == 0) return ~0;
+
+	uint32 last = function->blocks[function->blocks.GetCount() - 1]->GetTerminator()->opCode;
+
+	if (last != THC_SPIRV_OPCODE_OpReturn && last != THC_SPIRV_OPCODE_OpReturnValue) return ~0;
+
+	uint32 cost = 0;
+	uint32 returns = 0;
+
+	for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+		for (Instruction* inst = function->blocks[i]->instructions.first; inst; inst = inst->next) {
+			if (inst->opCode == THC_SPIRV_OPCODE_OpReturn || inst->opCode == THC_SPIRV_OPCODE_OpReturnValue) returns++;
+
+			cost++;
+		}
+	}
+
+	return returns == 1 ? cost : ~0;
+}
+
+static void InlineCall(Module& module, Function* caller, Instruction* call, Function* callee) {
+	BasicBlock* block = call->block;
+	uint64 index = caller->blocks.Find(block);
+
+	//Everything after the call continues in a new block
+	BasicBlock* after = module.CreateBlock(caller, index + 1);
+
+	while (call->next) {
+		module.Add(after, call->next);
+	}
+
+	uint32 blockId = block->GetId();
+	uint32 afterId = after->GetId();
+
+	for (uint64 i = 0; i < caller->blocks.GetCount(); i++) {
+		for (Instruction* inst = caller->blocks[i]->instructions.first; inst && inst->opCode == THC_SPIRV_OPCODE_OpPhi; inst = inst->next) {
+			for (uint32 j = 1; j < inst->operandCount; j += 2) {
+				if (inst->operands[j] == blockId) module.SetOperand(inst, j, afterId);
+			}
+		}
+	}
+
+	//Parameters become the arguments, every other result gets a new id
+	Map<uint32, uint32> ids(64);
+
+	for (uint64 i = 0; i < callee->parameters.GetCount(); i++) {
+		ids.Set(callee->parameters[i]->result, call->operands[i + 1]);
+	}
+
+	List<BasicBlock*> clones(callee->blocks.GetCount());
+
+	for (uint64 i = 0; i < callee->blocks.GetCount(); i++) {
+		BasicBlock* source = callee->blocks[i];
+		BasicBlock* clone = module.CreateBlock(caller, index + 1 + i);
+
+		ids.Set(source->GetId(), clone->GetId());
+		clones.Add(clone);
+
+		for (Instruction* inst = source->instructions.first; inst; inst = inst->next) {
+			if (inst->result) ids.Set(inst->result, module.NewId());
+		}
+	}
+
+	auto remap = [&ids](uint32& id) {
+		uint32* mapped = ids.Get(id);
+
+		if (mapped) id = *mapped;
+	};
+
+	BasicBlock* entry = caller->blocks[0];
+	uint32 returnValue = 0;
+
+	for (uint64 i = 0; i < callee->blocks.GetCount(); i++) {
+		BasicBlock* clone = clones[i];
+
+		for (Instruction* inst = callee->blocks[i]->instructions.first; inst; inst = inst->next) {
+			if (inst->opCode == THC_SPIRV_OPCODE_OpReturn || inst->opCode == THC_SPIRV_OPCODE_OpReturnValue) {
+				if (inst->opCode == THC_SPIRV_OPCODE_OpReturnValue) {
+					returnValue = inst->operands[0];
+					remap(returnValue);
+				}
+
+				module.Add(clone, module.CreateInstruction(THC_SPIRV_OPCODE_OpBranch, 0, 0, 1, &afterId));
+				continue;
+			}
+
+			Instruction* copy = module.CreateInstruction(inst->opCode, inst->resultType, inst->result, inst->operandCount, inst->operands);
+
+			remap(copy->result);
+			copy->ForEachId(remap);
+
+			if (copy->opCode != THC_SPIRV_OPCODE_OpVariable) {
+				module.Add(clone, copy);
+				continue;
+			}
+
+			//Variables must be at the start of the entry block, the initializer has to run every time the body does
+			uint32 initializer = copy->operandCount > 1 ? copy->operands[1] : 0;
+
+			copy->operandCount = 1;
+
+			module.InsertBefore(entry->instructions.first, copy);
+
+			if (initializer) {
+				uint32 operands[] = { copy->result, initializer };
+
+				module.Add(clone, module.CreateInstruction(THC_SPIRV_OPCODE_OpStore, 0, 0, 2, operands));
+			}
+		}
+	}
+
+	module.Add(block, module.CreateInstruction(THC_SPIRV_OPCODE_OpBranch, 0, 0, 1, &clones[0]->label->result));
+
+	if (returnValue) module.ReplaceAllUses(call->result, returnValue);
+
+	module.Remove(call);
+}
+
+void Optimizer::InlineFunctions(Module& module) {
+	List<Function*> visited(module.functions.GetCount());
+	List<Function*> order(module.functions.GetCount());
+
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		OrderFunctions(module, module.functions[i], visited, order);
+	}
+
+	uint32 threshold = CompilerOptions::InlineThreshold();
+
+	for (uint64 i = 0; i < order.GetCount(); i++) {
+		Function* caller = order[i];
+
+		List<Instruction*> calls(16);
+
+		for (uint64 j = 0; j < caller->blocks.GetCount(); j++) {
+			BasicBlock* block = caller->blocks[j];
+			Instruction* merge = block->GetMerge();
+
+			//Splitting a loop header would move the loop merge away from the back edge target
+			if (merge && merge->opCode == THC_SPIRV_OPCODE_OpLoopMerge) continue;
+
+			for (Instruction* inst = block->instructions.first; inst; inst = inst->next) {
+				if (inst->opCode == THC_SPIRV_OPCODE_OpFunctionCall) calls.Add(inst);
+			}
+		}
+
+		for (uint64 j = 0; j < calls.GetCount(); j++) {
+			Instruction* call = calls[j];
+			Function* callee = nullptr;
+
+			for (uint64 k = 0; k < module.functions.GetCount(); k++) {
+				if (module.functions[k]->GetId() == call->operands[0]) callee = module.functions[k];
+			}
+
+			if (!callee || callee == caller) continue;
+
+			uint32 cost = GetInlineCost(callee);
+
+			if (cost == ~0) continue;
+			if (cost > threshold && GetCallCount(module, callee->GetId()) > 1) continue;
+
+			InlineCall(module, caller, call, callee);
+		}
+	}
+}
+
+}
+}
+}
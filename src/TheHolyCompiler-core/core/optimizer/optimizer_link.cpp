@@ -0,0 +1,447 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "optimizer.h"
+#include <core/compiler/options.h>
+#include <util/log.h>
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+using namespace compiler;
+
+//A Location decorated interface variable, builtins aren't varyings
+struct Varying {
+	Instruction* variable;
+	uint32 location;
+	uint32 component;
+
+	inline uint32 GetKey() const { return (location << 2) | component; }
+};
+
+static Instruction* GetEntryPoint(const Module& module) {
+	for (Instruction* inst = module.header.first; inst; inst = inst->next) {
+		if (inst->opCode == THC_SPIRV_OPCODE_OpEntryPoint) return inst;
+	}
+
+	return nullptr;
+}
+
+//Index of the first interface id, they follow the null terminated name
+static uint32 GetInterfaceStart(const Instruction* entry) {
+	uint32 i = 2;
+
+	while (i < entry->operandCount) {
+		uint32 w = entry->operands[i++];
+
+		if (!(w & 0xFF) || !(w & 0xFF00) || !(w & 0xFF0000) || !(w & 0xFF000000)) break;
+	}
+
+	return i;
+}
+
+static void RemoveInterface(Module& module, Instruction* entry, uint32 id) {
+	List<uint32> operands(entry->operandCount);
+
+	uint32 start = GetInterfaceStart(entry);
+
+	for (uint32 i = 0; i < entry->operandCount; i++) {
+		if (i < start || entry->operands[i] != id) operands.Add(entry->operands[i]);
+	}
+
+	module.SetOperands(entry, (uint32)operands.GetCount(), operands.GetData());
+}
+
+//Returns ~0 if the id doesn't have the decoration
+static uint32 GetDecoration(const Module& module, uint32 id, uint32 decoration) {
+	for (Instruction* inst = module.annotations.first; inst; inst = inst->next) {
+		if (inst->opCode != THC_SPIRV_OPCODE_OpDecorate || inst->operands[0] != id || inst->operands[1] != decoration) continue;
+
+		return inst->operandCount > 2 ? inst->operands[2] : 0;
+	}
+
+	return ~0;
+}
+
+static List<Varying> GetVaryings(const Module& module, const Instruction* entry, uint32 storageClass) {
+	List<Varying> varyings(16);
+
+	for (uint32 i = GetInterfaceStart(entry); i < entry->operandCount; i++) {
+		Instruction* variable = module.GetDef(entry->operands[i]);
+
+		if (!variable || variable->operands[0] != storageClass) continue;
+
+		Varying varying;
+
+		varying.variable = variable;
+		varying.location = GetDecoration(module, variable->result, THC_SPIRV_DECORATION_LOCATION);
+		varying.component = GetDecoration(module, variable->result, THC_SPIRV_DECORATION_COMPONENT);
+
+		if (varying.location == ~0) continue;
+		if (varying.component == ~0) varying.component = 0;
+
+		varyings.Add(varying);
+	}
+
+	return varyings;
+}
+
+//Only uses inside functions count, the entry point and decorations refer to every variable
+static bool IsRead(const Module& module, uint32 id) {
+	for (Use* use = module.GetUses(id); use; use = use->next) {
+		if (Module::IsLive(use, id) && use->user->block) return true;
+	}
+
+	return false;
+}
+
+//Collects the stores writing the pointer or anything derived from it. Returns false if it's used any other way
+static bool GetStores(const Module& module, uint32 pointer, List<Instruction*>& stores) {
+	for (Use* use = module.GetUses(pointer); use; use = use->next) {
+		if (!Module::IsLive(use, pointer) || !use->user->block) continue;
+
+		Instruction* user = use->user;
+
+		switch (user->opCode) {
+			case THC_SPIRV_OPCODE_OpStore:
+				if (use->operand != &user->operands[0]) return false;
+
+				stores.Add(user);
+				break;
+			case THC_SPIRV_OPCODE_OpAccessChain:
+			case THC_SPIRV_OPCODE_OpInBoundsAccessChain:
+				if (use->operand != &user->operands[0] || !GetStores(module, user->result, stores)) return false;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+//Locations taken by a variable of the type, 64 bit vectors with more than two components take two
+static uint32 GetLocationCount(const Module& module, uint32 typeId) {
+	Instruction* type = module.GetDef(typeId);
+
+	switch (type->opCode) {
+		case THC_SPIRV_OPCODE_OpTypeVector:
+			return module.GetDef(type->operands[0])->operands[0] == 64 && type->operands[1] > 2 ? 2 : 1;
+		case THC_SPIRV_OPCODE_OpTypeMatrix:
+			return type->operands[1] * GetLocationCount(module, type->operands[0]);
+		case THC_SPIRV_OPCODE_OpTypeArray:
+			return module.GetDef(type->operands[1])->operands[0] * GetLocationCount(module, type->operands[0]);
+		case THC_SPIRV_OPCODE_OpTypeStruct: {
+			uint32 count = 0;
+
+			for (uint32 i = 0; i < type->operandCount; i++) {
+				count += GetLocationCount(module, type->operands[i]);
+			}
+
+			return count;
+		}
+	}
+
+	return 1;
+}
+
+//Returns the components of a 32 bit scalar or vector that fits in part of a location, 0 for anything else. scalar identifies the component type
+static uint32 GetComponentCount(const Module& module, const Instruction* variable, uint32& scalar) {
+	Instruction* type = module.GetDef(module.GetDef(variable->resultType)->operands[1]);
+	uint32 count = 1;
+
+	if (type->opCode == THC_SPIRV_OPCODE_OpTypeVector) {
+		count = type->operands[1];
+		type = module.GetDef(type->operands[0]);
+	}
+
+	if ((type->opCode != THC_SPIRV_OPCODE_OpTypeFloat && type->opCode != THC_SPIRV_OPCODE_OpTypeInt) || type->operands[0] != 32 || count > 3) return 0;
+
+	scalar = type->opCode;
+
+	return count;
+}
+
+//Varyings can only share a location if they are interpolated the same way
+static uint32 GetInterpolation(const Module& module, uint32 id) {
+	uint32 decorations[] = { THC_SPIRV_DECORATION_FLAT, THC_SPIRV_DECORATION_NO_PERSPECTIVE, THC_SPIRV_DECORATION_CENTEROID, THC_SPIRV_DECORATION_SAMPLE };
+	uint32 mask = 0;
+
+	for (uint32 i = 0; i < 4; i++) {
+		if (GetDecoration(module, id, decorations[i]) != ~0) mask |= 1 << i;
+	}
+
+	return mask;
+}
+
+static void SetLocation(Module& module, Instruction* variable, uint32 location, uint32 component) {
+	for (Instruction* inst = module.annotations.first; inst; inst = inst->next) {
+		if (inst->opCode == THC_SPIRV_OPCODE_OpDecorate && inst->operands[0] == variable->result && inst->operands[1] == THC_SPIRV_DECORATION_LOCATION) inst->operands[2] = location;
+	}
+
+	if (component == 0) return;
+
+	uint32 operands[] = { variable->result, THC_SPIRV_DECORATION_COMPONENT, component };
+
+	module.Add(module.annotations, module.CreateInstruction(THC_SPIRV_OPCODE_OpDecorate, 0, 0, 3, operands));
+}
+
+//Packing leaves the locations it emptied unused, moves the varyings down so both stages use the fewest locations
+static void CompactLocations(Module& vertex, const Instruction* vertexEntry, Module& fragment, const Instruction* fragmentEntry) {
+	List<Varying> inputs = GetVaryings(fragment, fragmentEntry, THC_SPIRV_STORAGE_CLASS_INPUT);
+	List<Varying> outputs = GetVaryings(vertex, vertexEntry, THC_SPIRV_STORAGE_CLASS_OUTPUT);
+
+	List<uint32> used(inputs.GetCount() + outputs.GetCount());
+
+	auto use = [&used](const Module& module, const Varying& varying) {
+		uint32 count = GetLocationCount(module, module.GetDef(varying.variable->resultType)->operands[1]);
+
+		for (uint32 i = 0; i < count; i++) {
+			if (used.Find(varying.location + i) == ~0) used.Add(varying.location + i);
+		}
+	};
+
+	for (uint64 i = 0; i < inputs.GetCount(); i++) use(fragment, inputs[i]);
+	for (uint64 i = 0; i < outputs.GetCount(); i++) use(vertex, outputs[i]);
+
+	//The new location is the number of used locations below the old one, the stages still match and multi location varyings stay contiguous
+	auto move = [&used](Module& module, const Varying& varying) {
+		uint32 location = 0;
+
+		for (uint64 i = 0; i < used.GetCount(); i++) {
+			if (used[i] < varying.location) location++;
+		}
+
+		if (location != varying.location) SetLocation(module, varying.variable, location, 0);
+	};
+
+	for (uint64 i = 0; i < inputs.GetCount(); i++) move(fragment, inputs[i]);
+	for (uint64 i = 0; i < outputs.GetCount(); i++) move(vertex, outputs[i]);
+}
+
+struct PackedVarying {
+	Instruction* output;
+	Instruction* input;
+	uint32 size;
+	uint32 group;
+
+	uint64 slot;
+	uint32 component;
+};
+
+struct LocationSlot {
+	uint32 location;
+	uint32 used;
+	uint32 group;
+};
+
+void Optimizer::PackVaryings(Module& vertex, Module& fragment) {
+	Instruction* vertexEntry = GetEntryPoint(vertex);
+	Instruction* fragmentEntry = GetEntryPoint(fragment);
+
+	List<Varying> inputs = GetVaryings(fragment, fragmentEntry, THC_SPIRV_STORAGE_CLASS_INPUT);
+	List<Varying> outputs = GetVaryings(vertex, vertexEntry, THC_SPIRV_STORAGE_CLASS_OUTPUT);
+
+	List<PackedVarying> packed(outputs.GetCount());
+	List<uint32> reserved(outputs.GetCount() + inputs.GetCount());
+
+	auto reserve = [&reserved](const Module& module, const Varying& varying) {
+		uint32 count = GetLocationCount(module, module.GetDef(varying.variable->resultType)->operands[1]);
+
+		for (uint32 i = 0; i < count; i++) {
+			reserved.Add(varying.location + i);
+		}
+	};
+
+	for (uint64 i = 0; i < inputs.GetCount(); i++) {
+		const Varying& input = inputs[i];
+		const Varying* output = nullptr;
+
+		for (uint64 j = 0; j < outputs.GetCount() && !output; j++) {
+			if (outputs[j].GetKey() == input.GetKey()) output = &outputs[j];
+		}
+
+		uint32 inputScalar = 0;
+		uint32 outputScalar = 0;
+
+		PackedVarying varying;
+
+		varying.input = input.variable;
+		varying.size = GetComponentCount(fragment, input.variable, inputScalar);
+
+		//Varyings that already pick their components are left where they are
+		if (!output || input.component != 0 || varying.size == 0 || GetComponentCount(vertex, output->variable, outputScalar) != varying.size || inputScalar != outputScalar) {
+			reserve(fragment, input);
+			continue;
+		}
+
+		varying.output = output->variable;
+		varying.group = (inputScalar << 4) | GetInterpolation(fragment, input.variable->result);
+
+		packed.Add(varying);
+	}
+
+	for (uint64 i = 0; i < outputs.GetCount(); i++) {
+		bool isPacked = false;
+
+		for (uint64 j = 0; j < packed.GetCount() && !isPacked; j++) {
+			isPacked = packed[j].output == outputs[i].variable;
+		}
+
+		if (!isPacked) reserve(vertex, outputs[i]);
+	}
+
+	List<LocationSlot> slots(packed.GetCount());
+
+	uint32 next = 0;
+
+	//Largest first, smaller varyings fill the gaps they leave
+	for (uint32 size = 3; size > 0; size--) {
+		for (uint64 i = 0; i < packed.GetCount(); i++) {
+			PackedVarying& varying = packed[i];
+
+			if (varying.size != size) continue;
+
+			uint64 slot = 0;
+
+			while (slot < slots.GetCount() && (slots[slot].group != varying.group || slots[slot].used + size > 4)) slot++;
+
+			if (slot == slots.GetCount()) {
+				while (reserved.Find(next) != ~0) next++;
+
+				LocationSlot s;
+
+				s.location = next++;
+				s.used = 0;
+				s.group = varying.group;
+
+				slots.Add(s);
+			}
+
+			varying.slot = slot;
+			varying.component = slots[slot].used;
+
+			slots[slot].used += size;
+		}
+	}
+
+	//Nothing is gained if every varying still needs a location of its own
+	if (slots.GetCount() >= packed.GetCount()) return;
+
+	for (uint64 i = 0; i < packed.GetCount(); i++) {
+		const PackedVarying& varying = packed[i];
+		uint32 location = slots[varying.slot].location;
+
+		SetLocation(vertex, varying.output, location, varying.component);
+		SetLocation(fragment, varying.input, location, varying.component);
+	}
+
+	CompactLocations(vertex, vertexEntry, fragment, fragmentEntry);
+}
+
+void Optimizer::LinkStages(Module& vertex, Module& fragment) {
+	Instruction* vertexEntry = GetEntryPoint(vertex);
+	Instruction* fragmentEntry = GetEntryPoint(fragment);
+
+	if (!vertexEntry || !fragmentEntry) return;
+
+	List<Varying> inputs = GetVaryings(fragment, fragmentEntry, THC_SPIRV_STORAGE_CLASS_INPUT);
+	List<Varying> outputs = GetVaryings(vertex, vertexEntry, THC_SPIRV_STORAGE_CLASS_OUTPUT);
+
+	List<uint32> read(inputs.GetCount());
+
+	for (uint64 i = 0; i < inputs.GetCount(); i++) {
+		const Varying& input = inputs[i];
+
+		if (!IsRead(fragment, input.variable->result)) {
+			RemoveInterface(fragment, fragmentEntry, input.variable->result);
+			continue;
+		}
+
+		read.Add(input.GetKey());
+
+		bool written = false;
+
+		for (uint64 j = 0; j < outputs.GetCount() && !written; j++) {
+			written = outputs[j].GetKey() == input.GetKey();
+		}
+
+		if (!written) Log::Warning("Fragment input at location %u component %u isn't written by the vertex stage", input.location, input.component);
+	}
+
+	for (uint64 i = 0; i < outputs.GetCount(); i++) {
+		const Varying& output = outputs[i];
+
+		if (read.Find(output.GetKey()) != ~0) continue;
+
+		List<Instruction*> stores(8);
+
+		//The vertex stage may read its own output, those have to stay
+		if (!GetStores(vertex, output.variable->result, stores)) continue;
+
+		for (uint64 j = 0; j < stores.GetCount(); j++) {
+			vertex.Remove(stores[j]);
+		}
+
+		RemoveInterface(vertex, vertexEntry, output.variable->result);
+	}
+
+	if (CompilerOptions::PackVaryings()) PackVaryings(vertex, fragment);
+
+	//Whatever only fed the removed outputs is dead now
+	EliminateDeadCode(vertex);
+	EliminateDeadCode(fragment);
+
+	Renumber(vertex);
+	Renumber(fragment);
+}
+
+bool Optimizer::Link(List<uint32>& vertex, List<uint32>& fragment) {
+	Module vertexModule;
+	Module fragmentModule;
+
+	if (!vertexModule.Load(vertex.GetData(), vertex.GetCount()) || !fragmentModule.Load(fragment.GetData(), fragment.GetCount())) {
+		Log::Warning("Optimizer can't load the modules, skipping linking");
+		return false;
+	}
+
+	vertexModule.BuildDefUse();
+	fragmentModule.BuildDefUse();
+
+	LinkStages(vertexModule, fragmentModule);
+
+	vertex.Resize(0);
+	fragment.Resize(0);
+
+	vertexModule.Write(vertex);
+	fragmentModule.Write(fragment);
+
+	return true;
+}
+
+}
+}
+}
@@ -0,0 +1,265 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+static Instruction* GetTypeOf(const Module& module, uint32 id) {
+	Instruction* def = module.GetDef(id);
+
+	return def ? module.GetDef(def->resultType) : nullptr;
+}
+
+static uint32 GetColumnType(const Module& module, uint32 matrix) {
+	return GetTypeOf(module, matrix)->operands[0];
+}
+
+static uint32 GetRows(const Module& module, uint32 matrix) {
+	return module.GetDef(GetColumnType(module, matrix))->operands[1];
+}
+
+static uint32 GetColumns(const Module& module, uint32 matrix) {
+	return GetTypeOf(module, matrix)->operands[1];
+}
+
+//Products are only split up when nothing else uses them, otherwise they would be computed twice
+static bool IsSplittable(const Module& module, uint32 id) {
+	Instruction* def = module.GetDef(id);
+
+	return def && def->opCode == THC_SPIRV_OPCODE_OpMatrixTimesMatrix && module.GetUseCount(id) == 1;
+}
+
+static bool IsInChain(const Module& module, uint32 id) {
+	if (!IsSplittable(module, id)) return false;
+
+	for (Use* use = module.GetUses(id); use; use = use->next) {
+		if (Module::IsLive(use, id)) return use->user->opCode == THC_SPIRV_OPCODE_OpMatrixTimesMatrix;
+	}
+
+	return false;
+}
+
+//Flattens the product tree into its factors from left to right
+static void CollectFactors(const Module& module, uint32 id, List<uint32>& factors) {
+	if (!IsSplittable(module, id)) {
+		factors.Add(id);
+		return;
+	}
+
+	Instruction* def = module.GetDef(id);
+
+	CollectFactors(module, def->operands[0], factors);
+	CollectFactors(module, def->operands[1], factors);
+}
+
+//Multiplications done by the product tree as it is
+static uint64 GetProductCost(const Module& module, uint32 id, bool root) {
+	if (!root && !IsSplittable(module, id)) return 0;
+
+	Instruction* def = module.GetDef(id);
+
+	uint32 left = def->operands[0];
+	uint32 right = def->operands[1];
+
+	return (uint64)GetRows(module, left) * GetColumns(module, left) * GetColumns(module, right) + GetProductCost(module, left, false) + GetProductCost(module, right, false);
+}
+
+struct MatrixChain {
+	Module* module;
+	Instruction* root;
+
+	List<uint32> factors;
+	List<uint32> dimensions; //Factor i is dimensions[i] x dimensions[i + 1]
+	List<uint64> splits;
+
+	uint32 componentType;
+};
+
+static uint32 BuildProduct(MatrixChain& chain, uint64 first, uint64 last) {
+	if (first == last) return chain.factors[first];
+
+	Module& module = *chain.module;
+	uint64 count = chain.factors.GetCount();
+	uint64 split = chain.splits[first * count + last];
+
+	uint32 left = BuildProduct(chain, first, split);
+	uint32 right = BuildProduct(chain, split + 1, last);
+
+	uint32 vectorOperands[] = { chain.componentType, chain.dimensions[first] };
+	uint32 matrixOperands[] = { module.GetType(THC_SPIRV_OPCODE_OpTypeVector, 2, vectorOperands), chain.dimensions[last + 1] };
+	uint32 operands[] = { left, right };
+
+	if (first == 0 && last == count - 1) {
+		module.SetOperands(chain.root, 2, operands);
+		return chain.root->result;
+	}
+
+	Instruction* product = module.CreateInstruction(THC_SPIRV_OPCODE_OpMatrixTimesMatrix, module.GetType(THC_SPIRV_OPCODE_OpTypeMatrix, 2, matrixOperands), module.NewId(), 2, operands);
+
+	module.InsertBefore(chain.root, product);
+
+	return product->result;
+}
+
+//Picks the cheapest order for a product of three or more matrices
+static void ReorderMatrixChain(Module& module, Instruction* root) {
+	MatrixChain chain;
+
+	chain.module = &module;
+	chain.root = root;
+
+	CollectFactors(module, root->operands[0], chain.factors);
+	CollectFactors(module, root->operands[1], chain.factors);
+
+	uint64 count = chain.factors.GetCount();
+
+	if (count < 3) return;
+
+	for (uint64 i = 0; i < count; i++) {
+		chain.dimensions.Add(GetRows(module, chain.factors[i]));
+	}
+
+	chain.dimensions.Add(GetColumns(module, chain.factors[count - 1]));
+
+	List<uint64> costs(count * count);
+
+	for (uint64 i = 0; i < count * count; i++) {
+		costs.Add(0);
+		chain.splits.Add(0);
+	}
+
+	for (uint64 length = 2; length <= count; length++) {
+		for (uint64 first = 0; first + length <= count; first++) {
+			uint64 last = first + length - 1;
+			uint64& cost = costs[first * count + last];
+
+			cost = ~0ULL;
+
+			for (uint64 split = first; split < last; split++) {
+				uint64 c = costs[first * count + split] + costs[(split + 1) * count + last] + (uint64)chain.dimensions[first] * chain.dimensions[split + 1] * chain.dimensions[last + 1];
+
+				if (c < cost) {
+					cost = c;
+					chain.splits[first * count + last] = split;
+				}
+			}
+		}
+	}
+
+	if (costs[count - 1] >= GetProductCost(module, root->result, true)) return;
+
+	chain.componentType = module.GetDef(GetColumnType(module, root->result))->operands[0];
+
+	BuildProduct(chain, 0, count - 1);
+}
+
+//M0 * M1 * ... * v is done as M0 * (M1 * (... * v))
+static void ReassociateMatrixTimesVector(Module& module, Instruction* inst) {
+	if (!IsSplittable(module, inst->operands[0])) return;
+
+	List<uint32> factors(8);
+
+	CollectFactors(module, inst->operands[0], factors);
+
+	uint32 vector = inst->operands[1];
+
+	for (uint64 i = factors.GetCount() - 1; i > 0; i--) {
+		uint32 operands[] = { factors[i], vector };
+
+		Instruction* product = module.CreateInstruction(THC_SPIRV_OPCODE_OpMatrixTimesVector, GetColumnType(module, factors[i]), module.NewId(), 2, operands);
+
+		module.InsertBefore(inst, product);
+
+		vector = product->result;
+	}
+
+	uint32 operands[] = { factors[0], vector };
+
+	module.SetOperands(inst, 2, operands);
+}
+
+//v * M0 * M1 * ... is done as ((v * M0) * M1) * ...
+static void ReassociateVectorTimesMatrix(Module& module, Instruction* inst) {
+	if (!IsSplittable(module, inst->operands[1])) return;
+
+	List<uint32> factors(8);
+
+	CollectFactors(module, inst->operands[1], factors);
+
+	uint32 vector = inst->operands[0];
+	uint32 componentType = GetTypeOf(module, vector)->operands[0];
+
+	for (uint64 i = 0; i < factors.GetCount() - 1; i++) {
+		uint32 typeOperands[] = { componentType, GetColumns(module, factors[i]) };
+		uint32 operands[] = { vector, factors[i] };
+
+		Instruction* product = module.CreateInstruction(THC_SPIRV_OPCODE_OpVectorTimesMatrix, module.GetType(THC_SPIRV_OPCODE_OpTypeVector, 2, typeOperands), module.NewId(), 2, operands);
+
+		module.InsertBefore(inst, product);
+
+		vector = product->result;
+	}
+
+	uint32 operands[] = { vector, factors[factors.GetCount() - 1] };
+
+	module.SetOperands(inst, 2, operands);
+}
+
+void Optimizer::ReassociateMatrices(Module& module) {
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			for (Instruction* inst = function->blocks[j]->instructions.first; inst; inst = inst->next) {
+				switch (inst->opCode) {
+					case THC_SPIRV_OPCODE_OpMatrixTimesVector:
+						ReassociateMatrixTimesVector(module, inst);
+						break;
+					case THC_SPIRV_OPCODE_OpVectorTimesMatrix:
+						ReassociateVectorTimesMatrix(module, inst);
+						break;
+				}
+			}
+		}
+
+		//Chains that end in a vector are already split, what remains are products that are used as matrices
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			for (Instruction* inst = function->blocks[j]->instructions.first; inst; inst = inst->next) {
+				if (inst->opCode != THC_SPIRV_OPCODE_OpMatrixTimesMatrix || !module.HasUses(inst->result) || IsInChain(module, inst->result)) continue;
+
+				ReorderMatrixChain(module, inst);
+			}
+		}
+	}
+}
+
+}
+}
+}
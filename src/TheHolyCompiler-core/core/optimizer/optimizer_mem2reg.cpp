@@ -0,0 +1,324 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+struct PromotionContext {
+	Module* module;
+
+	List<Instruction*> variables;
+	Map<uint32, uint32> variableIndices; //Variable id to index in variables
+	Map<uint32, uint32> phiIndices; //Phi result to index in variables
+
+	List<uint32>* values; //The current value of each variable while renaming
+};
+
+//Only variables that are loaded and stored directly can be promoted, the pointer escapes through anything else
+static bool IsPromotable(const Module& module, const Instruction* variable) {
+	uint32 id = variable->result;
+
+	for (Use* use = module.GetUses(id); use; use = use->next) {
+		if (!Module::IsLive(use, id)) continue;
+
+		const Instruction* user = use->user;
+
+		switch (user->opCode) {
+			case THC_SPIRV_OPCODE_OpLoad:
+			case THC_SPIRV_OPCODE_OpStore:
+				if (use->operand != user->operands) return false;
+				break;
+			case THC_SPIRV_OPCODE_OpName:
+			case THC_SPIRV_OPCODE_OpDecorate:
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static void RenameBlock(PromotionContext& context, BasicBlock* block) {
+	Module& module = *context.module;
+
+	List<uint32> pushed(8);
+
+	for (Instruction* inst = block->instructions.first; inst;) {
+		Instruction* next = inst->next;
+
+		if (inst->opCode == THC_SPIRV_OPCODE_OpPhi) {
+			uint32* index = context.phiIndices.Get(inst->result);
+
+			if (index) {
+				context.values[*index].Add(inst->result);
+				pushed.Add(*index);
+			}
+		} else if (inst->opCode == THC_SPIRV_OPCODE_OpLoad) {
+			uint32* index = context.variableIndices.Get(inst->operands[0]);
+
+			if (index) {
+				List<uint32>& values = context.values[*index];
+
+				module.ReplaceAllUses(inst->result, values[values.GetCount() - 1]);
+				module.Remove(inst);
+			}
+		} else if (inst->opCode == THC_SPIRV_OPCODE_OpStore) {
+			uint32* index = context.variableIndices.Get(inst->operands[0]);
+
+			if (index) {
+				context.values[*index].Add(inst->operands[1]);
+				pushed.Add(*index);
+				module.Remove(inst);
+			}
+		}
+
+		inst = next;
+	}
+
+	for (uint64 i = 0; i < block->successors.GetCount(); i++) {
+		BasicBlock* successor = block->successors[i];
+
+		uint32 slot = (uint32)successor->predecessors.Find(block) * 2;
+
+		for (Instruction* inst = successor->instructions.first; inst && inst->opCode == THC_SPIRV_OPCODE_OpPhi; inst = inst->next) {
+			uint32* index = context.phiIndices.Get(inst->result);
+
+			if (!index) continue;
+
+			List<uint32>& values = context.values[*index];
+
+			module.SetOperand(inst, slot, values[values.GetCount() - 1]);
+		}
+	}
+
+	for (uint64 i = 0; i < block->children.GetCount(); i++) {
+		RenameBlock(context, block->children[i]);
+	}
+
+	for (uint64 i = 0; i < pushed.GetCount(); i++) {
+		List<uint32>& values = context.values[pushed[i]];
+
+		values.RemoveAt(values.GetCount() - 1);
+	}
+}
+
+static void PromoteFunction(Module& module, Function* function) {
+	if (function->blocks.GetCount() == 0) return;
+
+	PromotionContext context;
+
+	context.module = &module;
+
+	BasicBlock* entry = function->blocks[0];
+
+	for (Instruction* inst = entry->instructions.first; inst; inst = inst->next) {
+		if (inst->opCode != THC_SPIRV_OPCODE_OpVariable || inst->operands[0] != THC_SPIRV_STORAGE_CLASS_FUNCTION) continue;
+		if (!IsPromotable(module, inst)) continue;
+
+		context.variableIndices.Set(inst->result, (uint32)context.variables.GetCount());
+		context.variables.Add(inst);
+	}
+
+	uint32 variableCount = (uint32)context.variables.GetCount();
+
+	if (variableCount == 0) return;
+
+	module.BuildCFG(function);
+	module.BuildDominators(function);
+
+	List<BasicBlock*>& order = function->order;
+	uint64 blockCount = order.GetCount();
+
+	//Dominance frontiers, a join point is in the frontier of every block between its predecessors and its immediate dominator
+	List<List<BasicBlock*>> frontiers(blockCount);
+
+	for (uint64 i = 0; i < blockCount; i++) {
+		frontiers.Add(List<BasicBlock*>(4));
+	}
+
+	for (uint64 i = 0; i < blockCount; i++) {
+		BasicBlock* block = order[i];
+
+		if (block->predecessors.GetCount() < 2) continue;
+
+		for (uint64 j = 0; j < block->predecessors.GetCount(); j++) {
+			BasicBlock* runner = block->predecessors[j];
+
+			if (!runner->IsReachable()) continue;
+
+			while (runner != block->idom) {
+				List<BasicBlock*>& frontier = frontiers[runner->order];
+
+				if (frontier.Find(block) == ~0) frontier.Add(block);
+
+				runner = runner->idom;
+			}
+		}
+	}
+
+	//Place phis at the iterated dominance frontier of the blocks storing to each variable
+	List<Instruction*> phis(64);
+	List<uint32> hasPhi(blockCount);
+	List<uint32> isQueued(blockCount);
+
+	for (uint64 i = 0; i < blockCount; i++) {
+		hasPhi.Add(~0);
+		isQueued.Add(~0);
+	}
+
+	for (uint32 i = 0; i < variableCount; i++) {
+		Instruction* variable = context.variables[i];
+		uint32 valueType = module.GetDef(variable->resultType)->operands[1];
+
+		List<BasicBlock*> queue(16);
+
+		for (Use* use = module.GetUses(variable->result); use; use = use->next) {
+			if (!Module::IsLive(use, variable->result) || use->user->opCode != THC_SPIRV_OPCODE_OpStore) continue;
+
+			BasicBlock* block = use->user->block;
+
+			if (!block->IsReachable() || isQueued[block->order] == i) continue;
+
+			isQueued[block->order] = i;
+			queue.Add(block);
+		}
+
+		while (queue.GetCount()) {
+			BasicBlock* block = queue[queue.GetCount() - 1];
+
+			queue.RemoveAt(queue.GetCount() - 1);
+
+			List<BasicBlock*>& frontier = frontiers[block->order];
+
+			for (uint64 j = 0; j < frontier.GetCount(); j++) {
+				BasicBlock* join = frontier[j];
+
+				if (hasPhi[join->order] == i) continue;
+
+				hasPhi[join->order] = i;
+
+				uint32 predecessorCount = (uint32)join->predecessors.GetCount();
+
+				Instruction* phi = module.CreateInstruction(THC_SPIRV_OPCODE_OpPhi, valueType, module.NewId(), predecessorCount * 2);
+
+				module.InsertBefore(join->instructions.first, phi);
+
+				for (uint32 k = 0; k < predecessorCount; k++) {
+					module.SetOperand(phi, k * 2 + 1, join->predecessors[k]->GetId());
+				}
+
+				context.phiIndices.Set(phi->result, i);
+				phis.Add(phi);
+
+				if (isQueued[join->order] != i) {
+					isQueued[join->order] = i;
+					queue.Add(join);
+				}
+			}
+		}
+	}
+
+	//Rename along the dominator tree, every variable starts with its initializer or undefined
+	context.values = new List<uint32>[variableCount];
+
+	for (uint32 i = 0; i < variableCount; i++) {
+		Instruction* variable = context.variables[i];
+
+		context.values[i].Add(variable->operandCount > 1 ? variable->operands[1] : module.GetUndef(module.GetDef(variable->resultType)->operands[1]));
+	}
+
+	RenameBlock(context, entry);
+
+	//Unreachable blocks never run, their accesses only have to stay valid
+	for (uint64 i = 0; i < function->blocks.GetCount(); i++) {
+		BasicBlock* block = function->blocks[i];
+
+		if (block->IsReachable()) continue;
+
+		for (Instruction* inst = block->instructions.first; inst;) {
+			Instruction* next = inst->next;
+
+			if ((inst->opCode == THC_SPIRV_OPCODE_OpLoad || inst->opCode == THC_SPIRV_OPCODE_OpStore) && context.variableIndices.Get(inst->operands[0])) {
+				if (inst->opCode == THC_SPIRV_OPCODE_OpLoad) module.ReplaceAllUses(inst->result, module.GetUndef(inst->resultType));
+
+				module.Remove(inst);
+			}
+
+			inst = next;
+		}
+	}
+
+	for (uint64 i = 0; i < phis.GetCount(); i++) {
+		Instruction* phi = phis[i];
+
+		for (uint32 j = 0; j < phi->operandCount; j += 2) {
+			if (phi->operands[j] == 0) module.SetOperand(phi, j, module.GetUndef(phi->resultType));
+		}
+	}
+
+	for (uint32 i = 0; i < variableCount; i++) {
+		Instruction* variable = context.variables[i];
+
+		for (Use* use = module.GetUses(variable->result); use; use = use->next) {
+			if (Module::IsLive(use, variable->result)) module.Remove(use->user);
+		}
+
+		module.Remove(variable);
+	}
+
+	//Phis are placed wherever a value might merge, drop the ones nothing reads
+	bool changed = true;
+
+	while (changed) {
+		changed = false;
+
+		for (uint64 i = 0; i < phis.GetCount(); i++) {
+			Instruction* phi = phis[i];
+
+			if (phi->removed || module.HasUses(phi->result)) continue;
+
+			module.Remove(phi);
+			changed = true;
+		}
+	}
+
+	delete[] context.values;
+}
+
+void Optimizer::PromoteVariables(Module& module) {
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		PromoteFunction(module, module.functions[i]);
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,405 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "optimizer.h"
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+//Returns the width of the components if the type is a float scalar, vector or matrix, 0 otherwise
+static uint32 GetFloatWidth(const Module& module, uint32 typeId) {
+	Instruction* type = module.GetDef(typeId);
+
+	while (type && (type->opCode == THC_SPIRV_OPCODE_OpTypeVector || type->opCode == THC_SPIRV_OPCODE_OpTypeMatrix)) {
+		type = module.GetDef(type->operands[0]);
+	}
+
+	return type && type->opCode == THC_SPIRV_OPCODE_OpTypeFloat ? type->operands[0] : 0;
+}
+
+static bool IsConstant(const Instruction* def) {
+	switch (def->opCode) {
+		case THC_SPIRV_OPCODE_OpUndef:
+		case THC_SPIRV_OPCODE_OpConstant:
+		case THC_SPIRV_OPCODE_OpConstantComposite:
+		case THC_SPIRV_OPCODE_OpConstantNull:
+		case THC_SPIRV_OPCODE_OpSpecConstant:
+		case THC_SPIRV_OPCODE_OpSpecConstantComposite:
+		case THC_SPIRV_OPCODE_OpSpecConstantOp:
+			return true;
+	}
+
+	return false;
+}
+
+static bool IsAccessChain(uint32 opCode) {
+	return opCode == THC_SPIRV_OPCODE_OpAccessChain || opCode == THC_SPIRV_OPCODE_OpInBoundsAccessChain;
+}
+
+//A pointer is relaxed if the variable it points into is or if it passes through a relaxed struct member
+static bool IsRelaxedPointer(const Module& module, const List<uint8>& relaxed, const List<uint64>& members, uint32 pointer) {
+	if (relaxed[pointer]) return true;
+
+	Instruction* def = module.GetDef(pointer);
+
+	if (!def || !IsAccessChain(def->opCode)) return false;
+
+	uint32 base = def->operands[0];
+
+	if (IsRelaxedPointer(module, relaxed, members, base)) return true;
+
+	Instruction* pointerType = module.GetDef(module.GetDef(base)->resultType);
+	Instruction* type = module.GetDef(pointerType->operands[1]);
+
+	for (uint32 i = 1; i < def->operandCount && type; i++) {
+		if (type->opCode != THC_SPIRV_OPCODE_OpTypeStruct) {
+			type = module.GetDef(type->operands[0]);
+			continue;
+		}
+
+		//Struct members are always indexed by constants
+		uint32 member = module.GetDef(def->operands[i])->operands[0];
+
+		if (members.Find(((uint64)type->result << 32) | member) != ~0) return true;
+
+		type = module.GetDef(type->operands[member]);
+	}
+
+	return false;
+}
+
+//Results that are computed from relaxed values and constants only can be relaxed themselves
+static bool IsRelaxedResult(Module& module, const List<uint8>& relaxed, Instruction* inst) {
+	bool pure = inst->HasFlag(THC_IR_FLAG_PURE) || inst->opCode == THC_SPIRV_OPCODE_OpPhi || (inst->opCode == THC_SPIRV_OPCODE_OpExtInst && module.IsRemovable(inst));
+
+	if (!pure || inst->result == 0 || GetFloatWidth(module, inst->resultType) == 0) return false;
+
+	bool any = false;
+	bool all = true;
+
+	inst->ForEachId([&](uint32& id) {
+		Instruction* def = module.GetDef(id);
+
+		if (!def || def->resultType == 0 || GetFloatWidth(module, def->resultType) == 0) return;
+
+		if (relaxed[id]) {
+			any = true;
+		} else if (!IsConstant(def)) {
+			all = false;
+		}
+	});
+
+	return any && all;
+}
+
+void Optimizer::PropagatePrecision(Module& module) {
+	List<uint8> relaxed(module.bound);
+	List<uint64> members(16);
+
+	for (uint32 i = 0; i < module.bound; i++) {
+		relaxed.Add(0);
+	}
+
+	for (Instruction* inst = module.annotations.first; inst; inst = inst->next) {
+		if (inst->opCode == THC_SPIRV_OPCODE_OpDecorate && inst->operands[1] == THC_SPIRV_DECORATION_RELAXED_PRECISION) {
+			relaxed[inst->operands[0]] = 1;
+		} else if (inst->opCode == THC_SPIRV_OPCODE_OpMemberDecorate && inst->operands[2] == THC_SPIRV_DECORATION_RELAXED_PRECISION) {
+			members.Add(((uint64)inst->operands[0] << 32) | inst->operands[1]);
+		}
+	}
+
+	List<uint32> added(64);
+
+	auto mark = [&relaxed, &added](uint32 id) {
+		relaxed[id] = 1;
+		added.Add(id);
+	};
+
+	bool changed = true;
+
+	while (changed) {
+		changed = false;
+
+		for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+			Function* function = module.functions[i];
+
+			for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+				for (Instruction* inst = function->blocks[j]->instructions.first; inst; inst = inst->next) {
+					if (inst->result && relaxed[inst->result]) continue;
+
+					if (inst->opCode == THC_SPIRV_OPCODE_OpStore) {
+						//A value that is only computed to be stored in relaxed memory doesn't need more precision than the memory has
+						uint32 value = inst->operands[1];
+						Instruction* def = module.GetDef(value);
+
+						if (!relaxed[value] && def && def->block && def->HasFlag(THC_IR_FLAG_PURE) && GetFloatWidth(module, def->resultType) != 0 && module.GetUseCount(value) == 1 && IsRelaxedPointer(module, relaxed, members, inst->operands[0])) {
+							mark(value);
+							changed = true;
+						}
+
+						continue;
+					}
+
+					bool res = inst->opCode == THC_SPIRV_OPCODE_OpLoad ? GetFloatWidth(module, inst->resultType) != 0 && IsRelaxedPointer(module, relaxed, members, inst->operands[0]) : IsRelaxedResult(module, relaxed, inst);
+
+					if (res) {
+						mark(inst->result);
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+
+	for (uint64 i = 0; i < added.GetCount(); i++) {
+		uint32 operands[] = { added[i], THC_SPIRV_DECORATION_RELAXED_PRECISION };
+
+		module.Add(module.annotations, module.CreateInstruction(THC_SPIRV_OPCODE_OpDecorate, 0, 0, 2, operands));
+	}
+}
+
+//Round to nearest even, returns false if the value can't be represented
+static bool FloatToHalf(uint32 bits, uint32& half) {
+	uint32 sign = (bits >> 16) & 0x8000;
+	uint32 exponent = (bits >> 23) & 0xFF;
+	uint32 mantissa = bits & 0x7FFFFF;
+
+	if (exponent == 0xFF) return false;
+
+	//Anything below half of the smallest 16 bit denormal rounds to zero
+	if (exponent < 102) {
+		half = sign;
+		return true;
+	}
+
+	uint32 shift = 13;
+
+	if (exponent < 113) {
+		mantissa |= 0x800000;
+		shift = 126 - exponent;
+		exponent = 0;
+	} else {
+		exponent -= 112;
+	}
+
+	uint32 rest = mantissa & ((1 << shift) - 1);
+	uint32 halfway = 1 << (shift - 1);
+
+	half = (exponent << 10) + (mantissa >> shift);
+
+	if (rest > halfway || (rest == halfway && (half & 1))) half++;
+
+	if (half >= 0x7C00) return false;
+
+	half |= sign;
+
+	return true;
+}
+
+//Returns the 16 bit version of a float scalar or vector type
+static uint32 GetHalfType(Module& module, uint32 typeId) {
+	uint32 width = 16;
+	uint32 half = module.GetType(THC_SPIRV_OPCODE_OpTypeFloat, 1, &width);
+
+	Instruction* type = module.GetDef(typeId);
+
+	if (type->opCode != THC_SPIRV_OPCODE_OpTypeVector) return half;
+
+	uint32 operands[] = { half, type->operands[1] };
+
+	return module.GetType(THC_SPIRV_OPCODE_OpTypeVector, 2, operands);
+}
+
+//Returns 0 if the constant can't be converted
+static uint32 GetHalfConstant(Module& module, Instruction* constant) {
+	uint32 typeId = GetHalfType(module, constant->resultType);
+
+	switch (constant->opCode) {
+		case THC_SPIRV_OPCODE_OpConstant: {
+			uint32 value;
+
+			if (!FloatToHalf(constant->operands[0], value)) return 0;
+
+			return module.GetConstant(THC_SPIRV_OPCODE_OpConstant, typeId, 1, &value);
+		}
+		case THC_SPIRV_OPCODE_OpConstantNull:
+			return module.GetConstant(THC_SPIRV_OPCODE_OpConstantNull, typeId, 0, nullptr);
+		case THC_SPIRV_OPCODE_OpConstantComposite: {
+			uint32 components[4];
+
+			for (uint32 i = 0; i < constant->operandCount; i++) {
+				components[i] = GetHalfConstant(module, module.GetDef(constant->operands[i]));
+
+				if (components[i] == 0) return 0;
+			}
+
+			return module.GetConstant(THC_SPIRV_OPCODE_OpConstantComposite, typeId, constant->operandCount, components);
+		}
+	}
+
+	return 0;
+}
+
+static bool IsDemotable(const Module& module, const List<uint8>& relaxed, const Instruction* inst) {
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpFAdd:
+		case THC_SPIRV_OPCODE_OpFSub:
+		case THC_SPIRV_OPCODE_OpFMul:
+		case THC_SPIRV_OPCODE_OpFDiv:
+		case THC_SPIRV_OPCODE_OpFMod:
+		case THC_SPIRV_OPCODE_OpFNegate:
+		case THC_SPIRV_OPCODE_OpVectorTimesScalar:
+		case THC_SPIRV_OPCODE_OpDot:
+			break;
+		default:
+			return false;
+	}
+
+	return relaxed[inst->result] && module.GetDef(inst->resultType)->opCode != THC_SPIRV_OPCODE_OpTypeMatrix && GetFloatWidth(module, inst->resultType) == 32;
+}
+
+//Converts a 32 bit value defined outside of the demoted chain, conversions are shared by every use in the function
+static uint32 ConvertToHalf(Module& module, Function* function, Map<uint32, uint32>& halves, uint32 id) {
+	uint32* existing = halves.Get(id);
+
+	if (existing) return *existing;
+
+	Instruction* def = module.GetDef(id);
+	Instruction* convert = module.CreateInstruction(THC_SPIRV_OPCODE_OpFConvert, GetHalfType(module, def->resultType), module.NewId(), 1, &id);
+
+	if (!def->block) {
+		//Parameters and globals are converted at the start of the function, after the variables
+		Instruction* position = function->blocks[0]->instructions.first;
+
+		while (position->opCode == THC_SPIRV_OPCODE_OpVariable) position = position->next;
+
+		module.InsertBefore(position, convert);
+	} else if (def->opCode == THC_SPIRV_OPCODE_OpPhi) {
+		Instruction* position = def;
+
+		while (position->next->opCode == THC_SPIRV_OPCODE_OpPhi) position = position->next;
+
+		module.InsertAfter(position, convert);
+	} else {
+		module.InsertAfter(def, convert);
+	}
+
+	halves.Set(id, convert->result);
+
+	return convert->result;
+}
+
+static bool DemoteInstruction(Module& module, Function* function, Map<uint32, uint32>& halves, Instruction* inst) {
+	uint32 operands[2];
+
+	for (uint32 i = 0; i < inst->operandCount; i++) {
+		uint32 id = inst->operands[i];
+		Instruction* def = module.GetDef(id);
+
+		uint32* half = halves.Get(id);
+
+		if (half) {
+			operands[i] = *half;
+		} else if (def->opCode == THC_SPIRV_OPCODE_OpConstant || def->opCode == THC_SPIRV_OPCODE_OpConstantComposite || def->opCode == THC_SPIRV_OPCODE_OpConstantNull) {
+			operands[i] = GetHalfConstant(module, def);
+
+			if (operands[i] == 0) return false;
+		} else {
+			operands[i] = 0;
+		}
+	}
+
+	//Conversions are only created once the constants are known to fit
+	for (uint32 i = 0; i < inst->operandCount; i++) {
+		if (operands[i] == 0) operands[i] = ConvertToHalf(module, function, halves, inst->operands[i]);
+	}
+
+	Instruction* half = module.CreateInstruction(inst->opCode, GetHalfType(module, inst->resultType), module.NewId(), inst->operandCount, operands);
+
+	module.InsertBefore(inst, half);
+
+	//Users that aren't demoted still get the 32 bit value
+	inst->opCode = THC_SPIRV_OPCODE_OpFConvert;
+
+	module.SetOperands(inst, 1, &half->result);
+
+	halves.Set(inst->result, half->result);
+
+	return true;
+}
+
+void Optimizer::DemotePrecision(Module& module) {
+	List<uint8> relaxed(module.bound);
+
+	for (uint32 i = 0; i < module.bound; i++) {
+		relaxed.Add(0);
+	}
+
+	for (Instruction* inst = module.annotations.first; inst; inst = inst->next) {
+		if (inst->opCode == THC_SPIRV_OPCODE_OpDecorate && inst->operands[1] == THC_SPIRV_DECORATION_RELAXED_PRECISION) relaxed[inst->operands[0]] = 1;
+	}
+
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		module.BuildCFG(function);
+		module.BuildDominators(function);
+
+		//A single operation would spend more on the conversions than it saves, only chains are demoted
+		List<Instruction*> chain(32);
+
+		for (uint64 j = 0; j < function->order.GetCount(); j++) {
+			for (Instruction* inst = function->order[j]->instructions.first; inst; inst = inst->next) {
+				if (!IsDemotable(module, relaxed, inst)) continue;
+
+				bool linked = false;
+
+				for (uint32 k = 0; k < inst->operandCount && !linked; k++) {
+					Instruction* def = module.GetDef(inst->operands[k]);
+
+					linked = def && def->block && IsDemotable(module, relaxed, def);
+				}
+
+				for (Use* use = module.GetUses(inst->result); use && !linked; use = use->next) {
+					linked = Module::IsLive(use, inst->result) && use->user->result && IsDemotable(module, relaxed, use->user);
+				}
+
+				if (linked) chain.Add(inst);
+			}
+		}
+
+		Map<uint32, uint32> halves(chain.GetCount() * 2 + 16);
+
+		for (uint64 j = 0; j < chain.GetCount(); j++) {
+			DemoteInstruction(module, function, halves, chain[j]);
+		}
+	}
+}
+
+}
+}
+}
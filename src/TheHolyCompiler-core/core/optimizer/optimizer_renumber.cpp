@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+#include <util/log.h>
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+void Optimizer::Renumber(Module& module) {
+	List<uint32> remap(module.bound);
+
+	for (uint32 i = 0; i < module.bound; i++) {
+		remap.Add(0);
+	}
+
+	uint32 next = 1;
+
+	auto map = [&remap, &next](uint32& id) {
+		uint32& newId = remap[id];
+
+		if (newId == 0) newId = next++;
+
+		id = newId;
+	};
+
+	module.ForEachInstruction([&map](Instruction* inst) {
+		if (inst->GetInfo()->hasResultType) map(inst->resultType);
+		if (inst->GetInfo()->hasResult) map(inst->result);
+
+		inst->ForEachId(map);
+	});
+
+	module.bound = next;
+
+	if (module.IsDefUseBuilt()) module.BuildDefUse();
+}
+
+bool Optimizer::Compact(List<uint32>& code, uint64 offset) {
+	Module module;
+
+	if (!module.Load(code.GetData() + offset, code.GetCount() - offset)) {
+		Log::Warning("Optimizer can't load the module, ids are not renumbered");
+		return false;
+	}
+
+	RemoveUnusedTypes(module);
+	Renumber(module);
+
+	code.Resize(offset);
+	module.Write(code);
+
+	return true;
+}
+
+}
+}
+}
@@ -0,0 +1,210 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+
+#define THC_SHUFFLE_UNDEFINED 0xFFFFFFFF
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+
+//Returns 0 if the id isn't a vector
+static uint32 GetComponentCount(const Module& module, uint32 id) {
+	Instruction* def = module.GetDef(id);
+
+	if (!def || def->resultType == 0) return 0;
+
+	Instruction* type = module.GetDef(def->resultType);
+
+	return type && type->opCode == THC_SPIRV_OPCODE_OpTypeVector ? type->operands[1] : 0;
+}
+
+//Follows shuffles back to the vector the component is taken from, source is 0 if the component is undefined
+static void ResolveComponent(const Module& module, uint32& source, uint32& index) {
+	Instruction* def;
+
+	while ((def = module.GetDef(source)) && def->opCode == THC_SPIRV_OPCODE_OpVectorShuffle) {
+		uint32 component = def->operands[2 + index];
+
+		if (component == THC_SHUFFLE_UNDEFINED) {
+			source = 0;
+			return;
+		}
+
+		uint32 size = GetComponentCount(module, def->operands[0]);
+
+		source = component < size ? def->operands[0] : def->operands[1];
+		index = component < size ? component : component - size;
+	}
+}
+
+static bool CoalesceShuffle(Module& module, Instruction* inst) {
+	uint32 count = inst->operandCount - 2;
+	uint32 size = GetComponentCount(module, inst->operands[0]);
+
+	List<uint32> sources(count);
+	List<uint32> indices(count);
+
+	uint32 first = 0;
+	uint32 second = 0;
+
+	for (uint32 i = 0; i < count; i++) {
+		uint32 component = inst->operands[2 + i];
+		uint32 source = 0;
+		uint32 index = THC_SHUFFLE_UNDEFINED;
+
+		if (component != THC_SHUFFLE_UNDEFINED) {
+			source = component < size ? inst->operands[0] : inst->operands[1];
+			index = component < size ? component : component - size;
+
+			ResolveComponent(module, source, index);
+		}
+
+		sources.Add(source);
+		indices.Add(index);
+
+		if (source == 0 || source == first || source == second) continue;
+
+		if (first == 0) {
+			first = source;
+		} else if (second == 0) {
+			second = source;
+		} else {
+			//A shuffle can only read from two vectors
+			return false;
+		}
+	}
+
+	if (first == 0) return false;
+	if (second == 0) second = first;
+
+	uint32 firstSize = GetComponentCount(module, first);
+
+	List<uint32> operands(count + 2);
+
+	operands.Add(first);
+	operands.Add(second);
+
+	bool identity = second == first && module.GetDef(first)->resultType == inst->resultType;
+
+	for (uint32 i = 0; i < count; i++) {
+		uint32 component = THC_SHUFFLE_UNDEFINED;
+
+		if (sources[i] == first) {
+			component = indices[i];
+		} else if (sources[i] == second) {
+			component = firstSize + indices[i];
+		}
+
+		if (component != i) identity = false;
+
+		operands.Add(component);
+	}
+
+	if (identity) {
+		module.ReplaceAllUses(inst->result, first);
+		module.Remove(inst);
+		return true;
+	}
+
+	if (memcmp(operands.GetData(), inst->operands, (count + 2) * sizeof(uint32)) == 0) return false;
+
+	module.SetOperands(inst, count + 2, operands.GetData());
+
+	return true;
+}
+
+//Only extracts of a single component are handled, returns true if the instruction was changed or removed
+static bool CoalesceExtract(Module& module, Instruction* inst) {
+	if (inst->operandCount != 2) return false;
+
+	uint32 index = inst->operands[1];
+	Instruction* def = module.GetDef(inst->operands[0]);
+
+	if (!def) return false;
+
+	switch (def->opCode) {
+		case THC_SPIRV_OPCODE_OpVectorShuffle: {
+			uint32 component = def->operands[2 + index];
+
+			if (component == THC_SHUFFLE_UNDEFINED) return false;
+
+			uint32 size = GetComponentCount(module, def->operands[0]);
+
+			inst->operands[1] = component < size ? component : component - size;
+			module.SetOperand(inst, 0, component < size ? def->operands[0] : def->operands[1]);
+
+			return true;
+		}
+		case THC_SPIRV_OPCODE_OpCompositeInsert:
+			if (def->operandCount != 3) return false;
+
+			if (def->operands[2] == index) {
+				module.ReplaceAllUses(inst->result, def->operands[0]);
+				module.Remove(inst);
+			} else {
+				module.SetOperand(inst, 0, def->operands[1]);
+			}
+
+			return true;
+		case THC_SPIRV_OPCODE_OpCompositeConstruct:
+			//A vector constructed from scalars, vector operands would spread over several components
+			if (def->operandCount != GetComponentCount(module, def->result)) return false;
+
+			module.ReplaceAllUses(inst->result, def->operands[index]);
+			module.Remove(inst);
+
+			return true;
+	}
+
+	return false;
+}
+
+void Optimizer::CoalesceShuffles(Module& module) {
+	for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+		Function* function = module.functions[i];
+
+		for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+			for (Instruction* inst = function->blocks[j]->instructions.first; inst;) {
+				Instruction* next = inst->next;
+
+				if (inst->opCode == THC_SPIRV_OPCODE_OpVectorShuffle) {
+					CoalesceShuffle(module, inst);
+				} else if (inst->opCode == THC_SPIRV_OPCODE_OpCompositeExtract) {
+					while (!inst->removed && CoalesceExtract(module, inst));
+				}
+
+				inst = next;
+			}
+		}
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,408 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "optimizer.h"
+#include <core/compiler/options.h>
+
+#define THC_FLOAT_ONE 0x3F800000
+#define THC_FLOAT_MINUS_ONE 0xBF800000
+
+namespace thc {
+namespace core {
+namespace optimizer {
+
+using namespace utils;
+using namespace compiler;
+
+//Returns the scalar type of a scalar or vector type
+static Instruction* GetComponentType(const Module& module, uint32 typeId) {
+	Instruction* type = module.GetDef(typeId);
+
+	if (type && type->opCode == THC_SPIRV_OPCODE_OpTypeVector) type = module.GetDef(type->operands[0]);
+
+	return type;
+}
+
+static uint32 GetTypeOf(const Module& module, uint32 id) {
+	Instruction* def = module.GetDef(id);
+
+	return def ? def->resultType : 0;
+}
+
+//Only constants of at most 32 bits are handled, vectors must have the same value in every component
+static bool GetConstant(const Module& module, uint32 id, uint32& value) {
+	Instruction* def = module.GetDef(id);
+
+	if (!def) return false;
+
+	switch (def->opCode) {
+		case THC_SPIRV_OPCODE_OpConstant:
+			if (def->operandCount != 1) return false;
+
+			value = def->operands[0];
+			return true;
+		case THC_SPIRV_OPCODE_OpConstantNull:
+			value = 0;
+			return true;
+		case THC_SPIRV_OPCODE_OpConstantComposite:
+			if (!GetConstant(module, def->operands[0], value)) return false;
+
+			for (uint32 i = 1; i < def->operandCount; i++) {
+				uint32 component;
+
+				if (!GetConstant(module, def->operands[i], component) || component != value) return false;
+			}
+
+			return true;
+	}
+
+	return false;
+}
+
+//Creates the value in every component if the type is a vector
+static uint32 CreateConstant(Module& module, uint32 typeId, uint32 value) {
+	Instruction* type = module.GetDef(typeId);
+
+	if (type->opCode != THC_SPIRV_OPCODE_OpTypeVector) return module.GetConstant(THC_SPIRV_OPCODE_OpConstant, typeId, 1, &value);
+
+	uint32 component = module.GetConstant(THC_SPIRV_OPCODE_OpConstant, type->operands[0], 1, &value);
+	uint32 components[4] = { component, component, component, component };
+
+	return module.GetConstant(THC_SPIRV_OPCODE_OpConstantComposite, typeId, type->operands[1], components);
+}
+
+static bool IsPowerOfTwo(uint32 value) {
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+static uint32 Log2(uint32 value) {
+	uint32 res = 0;
+
+	while (value >>= 1) res++;
+
+	return res;
+}
+
+static uint32 GetWidth(const Module& module, uint32 typeId) {
+	return GetComponentType(module, typeId)->operands[0];
+}
+
+//Bits a float of the width can represent exactly, including the implicit one
+static uint32 GetMantissaBits(uint32 width) {
+	switch (width) {
+		case 16: return 11;
+		case 32: return 24;
+		case 64: return 53;
+	}
+
+	return 0;
+}
+
+//Operands may differ from the result in signedness, those can't replace it
+static bool Replace(Module& module, Instruction* inst, uint32 id) {
+	if (GetTypeOf(module, id) != inst->resultType) return false;
+
+	module.ReplaceAllUses(inst->result, id);
+	module.Remove(inst);
+
+	return true;
+}
+
+static bool Rewrite(Module& module, Instruction* inst, uint32 opCode, uint32 operandCount, uint32 a, uint32 b = 0) {
+	uint32 operands[] = { a, b };
+
+	inst->opCode = opCode;
+
+	module.SetOperands(inst, operandCount, operands);
+
+	return true;
+}
+
+//Returns the operand of a unary instruction of the opcode, or 0
+static uint32 GetUnaryOperand(const Module& module, uint32 id, uint32 opCode) {
+	Instruction* def = module.GetDef(id);
+
+	return def && def->opCode == opCode ? def->operands[0] : 0;
+}
+
+static bool SimplifyInteger(Module& module, Instruction* inst) {
+	uint32 width = GetWidth(module, inst->resultType);
+
+	//New constants are created with a single word
+	if (width > 32) return false;
+
+	uint32 mask = width == 32 ? ~0U : (1U << width) - 1;
+
+	uint32 a = inst->operands[0];
+	uint32 b = inst->operandCount > 1 ? inst->operands[1] : 0;
+
+	uint32 ca = 0;
+	uint32 cb = 0;
+
+	bool constA = GetConstant(module, a, ca);
+	bool constB = b && GetConstant(module, b, cb);
+
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpIAdd:
+		case THC_SPIRV_OPCODE_OpBitwiseOr:
+		case THC_SPIRV_OPCODE_OpBitwiseXor:
+			if (constB && cb == 0) return Replace(module, inst, a);
+			if (constA && ca == 0) return Replace(module, inst, b);
+			break;
+		case THC_SPIRV_OPCODE_OpISub:
+		case THC_SPIRV_OPCODE_OpShiftLeftLogical:
+		case THC_SPIRV_OPCODE_OpShiftRightLogical:
+		case THC_SPIRV_OPCODE_OpShiftRightArithmetic:
+			if (constB && cb == 0) return Replace(module, inst, a);
+			break;
+		case THC_SPIRV_OPCODE_OpIMul:
+			if (constA && !constB) {
+				uint32 tmp = a;
+				a = b;
+				b = tmp;
+				cb = ca;
+				constB = true;
+			}
+
+			if (!constB) break;
+
+			if (cb == 0) return Replace(module, inst, CreateConstant(module, inst->resultType, 0));
+			if (cb == 1) return Replace(module, inst, a);
+
+			if (IsPowerOfTwo(cb)) {
+				return Rewrite(module, inst, THC_SPIRV_OPCODE_OpShiftLeftLogical, 2, a, CreateConstant(module, GetTypeOf(module, a), Log2(cb)));
+			}
+
+			break;
+		case THC_SPIRV_OPCODE_OpSDiv:
+			//Signed division rounds towards zero, a shift would round negative values down
+			if (constB && cb == 1) return Replace(module, inst, a);
+			break;
+		case THC_SPIRV_OPCODE_OpUDiv:
+			if (!constB) break;
+
+			if (cb == 1) return Replace(module, inst, a);
+
+			if (IsPowerOfTwo(cb)) {
+				return Rewrite(module, inst, THC_SPIRV_OPCODE_OpShiftRightLogical, 2, a, CreateConstant(module, GetTypeOf(module, a), Log2(cb)));
+			}
+
+			break;
+		case THC_SPIRV_OPCODE_OpUMod:
+			if (constB && IsPowerOfTwo(cb)) {
+				return Rewrite(module, inst, THC_SPIRV_OPCODE_OpBitwiseAnd, 2, a, CreateConstant(module, GetTypeOf(module, b), cb - 1));
+			}
+
+			break;
+		case THC_SPIRV_OPCODE_OpBitwiseAnd:
+			if ((constB && cb == 0) || (constA && ca == 0)) return Replace(module, inst, CreateConstant(module, inst->resultType, 0));
+			if (constB && (cb & mask) == mask) return Replace(module, inst, a);
+			if (constA && (ca & mask) == mask) return Replace(module, inst, b);
+			break;
+		case THC_SPIRV_OPCODE_OpSNegate:
+		case THC_SPIRV_OPCODE_OpNot: {
+			//Negative literals are parsed as a negation of the constant
+			if (constA) return Replace(module, inst, CreateConstant(module, inst->resultType, (inst->opCode == THC_SPIRV_OPCODE_OpSNegate ? 0U - ca : ~ca) & mask));
+
+			uint32 operand = GetUnaryOperand(module, a, inst->opCode);
+
+			if (operand) return Replace(module, inst, operand);
+
+			break;
+		}
+	}
+
+	return false;
+}
+
+static bool SimplifyFloat(Module& module, Instruction* inst) {
+	//Other widths would need their own bit patterns for the constants
+	if (GetWidth(module, inst->resultType) != 32) return false;
+
+	bool fastMath = CompilerOptions::FastMath();
+
+	uint32 a = inst->operands[0];
+	uint32 b = inst->operandCount > 1 ? inst->operands[1] : 0;
+
+	uint32 ca = 0;
+	uint32 cb = 0;
+
+	bool constA = GetConstant(module, a, ca);
+	bool constB = b && GetConstant(module, b, cb);
+
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpFAdd:
+			//-0 + 0 is 0, so this only holds when the sign of zero doesn't matter
+			if (!fastMath) break;
+			if (constB && (cb << 1) == 0) return Replace(module, inst, a);
+			if (constA && (ca << 1) == 0) return Replace(module, inst, b);
+			break;
+		case THC_SPIRV_OPCODE_OpFSub:
+			if (constB && cb == 0) return Replace(module, inst, a);
+
+			if (fastMath && constA && (ca << 1) == 0) {
+				return Rewrite(module, inst, THC_SPIRV_OPCODE_OpFNegate, 1, b);
+			}
+
+			break;
+		case THC_SPIRV_OPCODE_OpFMul:
+		case THC_SPIRV_OPCODE_OpVectorTimesScalar:
+			if (constA && !constB && inst->opCode == THC_SPIRV_OPCODE_OpFMul) {
+				uint32 tmp = a;
+				a = b;
+				b = tmp;
+				cb = ca;
+				constB = true;
+			}
+
+			if (!constB) break;
+
+			if (cb == THC_FLOAT_ONE) return Replace(module, inst, a);
+
+			if (cb == THC_FLOAT_MINUS_ONE) {
+				return Rewrite(module, inst, THC_SPIRV_OPCODE_OpFNegate, 1, a);
+			}
+
+			//x * 0 is NaN for infinite x and -0 for negative x
+			if (fastMath && (cb << 1) == 0) return Replace(module, inst, CreateConstant(module, inst->resultType, 0));
+
+			break;
+		case THC_SPIRV_OPCODE_OpFDiv: {
+			if (!constB) break;
+
+			if (cb == THC_FLOAT_ONE) return Replace(module, inst, a);
+
+			float divisor;
+			float reciprocal;
+
+			memcpy(&divisor, &cb, sizeof(float));
+
+			reciprocal = 1.0f / divisor;
+
+			uint32 bits;
+
+			memcpy(&bits, &reciprocal, sizeof(float));
+
+			uint32 exponent = (bits >> 23) & 0xFF;
+
+			if (exponent == 0 || exponent == 0xFF) break;
+
+			//The reciprocal of a power of two is exact, anything else rounds differently than the division
+			if ((cb & 0x7FFFFF) != 0 && !fastMath) break;
+
+			return Rewrite(module, inst, THC_SPIRV_OPCODE_OpFMul, 2, a, CreateConstant(module, GetTypeOf(module, b), bits));
+		}
+		case THC_SPIRV_OPCODE_OpFNegate: {
+			if (constA) return Replace(module, inst, CreateConstant(module, inst->resultType, ca ^ 0x80000000));
+
+			uint32 operand = GetUnaryOperand(module, a, THC_SPIRV_OPCODE_OpFNegate);
+
+			if (operand) return Replace(module, inst, operand);
+
+			break;
+		}
+	}
+
+	return false;
+}
+
+//Conversions that widen and then convert back give the original value
+static bool SimplifyConversion(Module& module, Instruction* inst) {
+	Instruction* def = module.GetDef(inst->operands[0]);
+
+	if (!def) return false;
+
+	uint32 width = GetWidth(module, inst->resultType);
+	uint32 middle = GetWidth(module, def->resultType);
+
+	bool exact = false;
+
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpFConvert:
+		case THC_SPIRV_OPCODE_OpUConvert:
+		case THC_SPIRV_OPCODE_OpSConvert:
+			exact = def->opCode == inst->opCode && middle > width;
+			break;
+		case THC_SPIRV_OPCODE_OpConvertFToS:
+			exact = def->opCode == THC_SPIRV_OPCODE_OpConvertSToF && GetMantissaBits(middle) >= width;
+			break;
+		case THC_SPIRV_OPCODE_OpConvertFToU:
+			exact = def->opCode == THC_SPIRV_OPCODE_OpConvertUToF && GetMantissaBits(middle) >= width;
+			break;
+		case THC_SPIRV_OPCODE_OpBitcast:
+			exact = def->opCode == THC_SPIRV_OPCODE_OpBitcast;
+			break;
+	}
+
+	return exact && Replace(module, inst, def->operands[0]);
+}
+
+static bool Simplify(Module& module, Instruction* inst) {
+	switch (inst->opCode) {
+		case THC_SPIRV_OPCODE_OpFConvert:
+		case THC_SPIRV_OPCODE_OpUConvert:
+		case THC_SPIRV_OPCODE_OpSConvert:
+		case THC_SPIRV_OPCODE_OpConvertFToS:
+		case THC_SPIRV_OPCODE_OpConvertFToU:
+		case THC_SPIRV_OPCODE_OpBitcast:
+			return SimplifyConversion(module, inst);
+	}
+
+	Instruction* type = GetComponentType(module, inst->resultType);
+
+	if (!type) return false;
+
+	if (type->opCode == THC_SPIRV_OPCODE_OpTypeInt) return SimplifyInteger(module, inst);
+	if (type->opCode == THC_SPIRV_OPCODE_OpTypeFloat) return SimplifyFloat(module, inst);
+
+	return false;
+}
+
+void Optimizer::SimplifyArithmetic(Module& module) {
+	bool changed = true;
+
+	//A simplification can expose another one in a later instruction, like a negation of a removed negation
+	while (changed) {
+		changed = false;
+
+		for (uint64 i = 0; i < module.functions.GetCount(); i++) {
+			Function* function = module.functions[i];
+
+			for (uint64 j = 0; j < function->blocks.GetCount(); j++) {
+				for (Instruction* inst = function->blocks[j]->instructions.first; inst;) {
+					Instruction* next = inst->next;
+
+					if (inst->result && inst->operandCount > 0 && inst->HasFlag(THC_IR_FLAG_PURE) && Simplify(module, inst)) changed = true;
+
+					inst = next;
+				}
+			}
+		}
+	}
+}
+
+}
+}
+}
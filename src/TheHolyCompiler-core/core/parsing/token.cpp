@@ -52,8 +52,8 @@ Token::Token(TokenType type, const String& string, uint64 column) : type(type),
 Token::Token(TokenType type, uint64 value, const String& string, uint64 column) : type(type), value(value), valueType(TokenType::None), bits(0), sign(0), rows(0), columns(0), string(string), column(column) { }
 Token::Token(TokenType type, const String& string, const Line& line, uint64 column) : type(type), value(0), valueType(TokenType::None), bits(0), sign(0), rows(0), columns(0), string(string), line(line), column(column) { }
 Token::Token(TokenType type, uint64 value, const String& string, const Line& line, uint64 column) : type(type), value(value), valueType(TokenType::None), bits(0), sign(0), rows(0), columns(0), string(string), line(line), column(column) { }
-Token::Token(const Token& other) : type(other.type), value(other.value), valueType(other.valueType), bits(0), sign(0), rows(0), columns(0), string(other.string), line(other.line), column(other.column) { }
-Token::Token(const Token* other) : type(other->type), value(other->value), valueType(other->valueType), bits(0), sign(0), rows(0), columns(0), string(other->string), line(other->line), column(other->column) { }
+Token::Token(const Token& other) : type(other.type), value(other.value), valueType(other.valueType), bits(other.bits), sign(other.sign), rows(other.rows), columns(other.columns), string(other.string), line(other.line), column(other.column) { }
+Token::Token(const Token* other) : type(other->type), value(other->value), valueType(other->valueType), bits(other->bits), sign(other->sign), rows(other->rows), columns(other->columns), string(other->string), line(other->line), column(other->column) { }
 Token::Token(Token&& other) noexcept {
 	type = other.type;
 	value = other.value;
@@ -106,8 +106,12 @@ enum class TokenType {
 	DataIn,
 	DataOut,
 	DataUniform,
+	DataShared,
 
 	ModifierConst,
+	ModifierHighp,
+	ModifierMediump,
+	ModifierLowp,
 	ModifierReference = OperatorBitwiseAnd,
 };
 
@@ -672,7 +672,7 @@ SOFTWARE.
 #define THC_SPIRV_OPCODE_OpShiftRightLogical 194
 #define THC_SPIRV_OPCODE_OpShiftRightArithmetic 195
 #define THC_SPIRV_OPCODE_OpShiftLeftLogical 196
-#define THC_SPIRV_OPCODE_OpBitwiseOr 147
+#define THC_SPIRV_OPCODE_OpBitwiseOr 197
 #define THC_SPIRV_OPCODE_OpBitwiseXor 198
 #define THC_SPIRV_OPCODE_OpBitwiseAnd 199
 #define THC_SPIRV_OPCODE_OpNot 200
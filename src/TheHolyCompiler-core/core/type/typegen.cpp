@@ -81,7 +81,6 @@ void InstTypeArray::GetInstWords(uint32* words) const {
 }
 
 void InstTypeStruct::GetInstWords(uint32* words) const {
-	wordCount += memberCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = id->id;
@@ -100,7 +99,6 @@ void InstTypePointer::GetInstWords(uint32* words) const {
 }
 
 void InstTypeFunction::GetInstWords(uint32* words) const {
-	wordCount += parameterCount;
 	InstBase::GetInstWords(words);
 
 	words[1] = id->id;
@@ -30,6 +30,7 @@ namespace core {
 namespace type {
 
 using namespace parsing;
+using namespace utils;
 
 Type ConvertToType(TokenType type) {
 	switch (type) {
@@ -53,33 +54,33 @@ Type ConvertToType(TokenType type) {
 }
 
 
-InstTypeBase::InstTypeBase(Type type, uint32 opCode, uint32 wordCount, const char* const literalName) : InstBase(opCode, wordCount, literalName, true, instruction::InstType::Type), type(type) { }
+InstTypeBase::InstTypeBase(Type type, uint32 opCode, uint32 wordCount) : InstBase(opCode, wordCount, true, instruction::InstType::Type), type(type) { }
 
 InstTypeBase::~InstTypeBase() { }
 
-InstTypeVoid::InstTypeVoid() : InstTypeBase(Type::Void, THC_SPIRV_OPCODE_OpTypeVoid, 2, "OpTypeVoid") {  }
+InstTypeVoid::InstTypeVoid() : InstTypeBase(Type::Void, THC_SPIRV_OPCODE_OpTypeVoid, 2) {  }
 
-InstTypeBool::InstTypeBool() : InstTypeBase(Type::Bool, THC_SPIRV_OPCODE_OpTypeBool, 2, "OpTypeBool") { }
+InstTypeBool::InstTypeBool() : InstTypeBase(Type::Bool, THC_SPIRV_OPCODE_OpTypeBool, 2) { }
 
-InstTypeInt::InstTypeInt(uint32 bits, uint32 sign) : InstTypeBase(Type::Int, THC_SPIRV_OPCODE_OpTypeInt, 4, "OpTypeInt"), bits(bits), sign(sign) { }
+InstTypeInt::InstTypeInt(uint32 bits, uint32 sign) : InstTypeBase(Type::Int, THC_SPIRV_OPCODE_OpTypeInt, 4), bits(bits), sign(sign) { }
 
-InstTypeFloat::InstTypeFloat(uint32 bits) : InstTypeBase(Type::Float, THC_SPIRV_OPCODE_OpTypeFloat, 3, "OpTypeFloat"), bits(bits) { }
+InstTypeFloat::InstTypeFloat(uint32 bits) : InstTypeBase(Type::Float, THC_SPIRV_OPCODE_OpTypeFloat, 3), bits(bits) { }
 
-InstTypeVector::InstTypeVector(uint32 compCount, compiler::ID* compTypeId) : InstTypeBase(Type::Vector, THC_SPIRV_OPCODE_OpTypeVector, 4, "OpTypeVector"), componentCount(compCount), componentTypeId(compTypeId) {}
+InstTypeVector::InstTypeVector(uint32 compCount, compiler::ID* compTypeId) : InstTypeBase(Type::Vector, THC_SPIRV_OPCODE_OpTypeVector, 4), componentCount(compCount), componentTypeId(compTypeId) {}
 
-InstTypeMatrix::InstTypeMatrix(uint32 columnCount, compiler::ID* columnTypeId) : InstTypeBase(Type::Matrix, THC_SPIRV_OPCODE_OpTypeMatrix, 4, "OpTypeMatrix"), columnCount(columnCount), columnTypeId(columnTypeId) {}
+InstTypeMatrix::InstTypeMatrix(uint32 columnCount, compiler::ID* columnTypeId) : InstTypeBase(Type::Matrix, THC_SPIRV_OPCODE_OpTypeMatrix, 4), columnCount(columnCount), columnTypeId(columnTypeId) {}
 
-InstTypeArray::InstTypeArray(compiler::ID* elementCountId, compiler::ID* elementTypeId) : InstTypeBase(Type::Array, THC_SPIRV_OPCODE_OpTypeArray, 4, "OpTypeArray"), elementCountId(elementCountId), elementTypeId(elementTypeId) {}
+InstTypeArray::InstTypeArray(compiler::ID* elementCountId, compiler::ID* elementTypeId) : InstTypeBase(Type::Array, THC_SPIRV_OPCODE_OpTypeArray, 4), elementCountId(elementCountId), elementTypeId(elementTypeId) {}
 
-InstTypeStruct::InstTypeStruct(uint32 memberCount, compiler::ID** memberTypeIds) : InstTypeBase(Type::Struct, THC_SPIRV_OPCODE_OpTypeStruct, 2, "OpTypeStruct"), memberCount(memberCount) { memcpy(memberTypeId, memberTypeIds, memberCount * sizeof(void*)); }
+InstTypeStruct::InstTypeStruct(uint32 memberCount, compiler::ID** memberTypeIds) : InstTypeBase(Type::Struct, THC_SPIRV_OPCODE_OpTypeStruct, 2), memberCount(memberCount) { wordCount += memberCount; memcpy(memberTypeId, memberTypeIds, memberCount * sizeof(void*)); }
 
-InstTypePointer::InstTypePointer(uint32 storageClass, compiler::ID* typeId) : InstTypeBase(Type::Pointer, THC_SPIRV_OPCODE_OpTypePointer, 4, "OpTypePointer"), storageClass(storageClass), typeId(typeId) {}
+InstTypePointer::InstTypePointer(uint32 storageClass, compiler::ID* typeId) : InstTypeBase(Type::Pointer, THC_SPIRV_OPCODE_OpTypePointer, 4), storageClass(storageClass), typeId(typeId) {}
 
-InstTypeFunction::InstTypeFunction(compiler::ID* returnTypeId, uint32 parameterCount, compiler::ID** parameterIds) : InstTypeBase(Type::Function, THC_SPIRV_OPCODE_OpTypeFunction, 3, "OpTypeFunction"), returnTypeId(returnTypeId), parameterCount(parameterCount) { memcpy(parameterId, parameterIds, parameterCount * sizeof(void*)); }
+InstTypeFunction::InstTypeFunction(compiler::ID* returnTypeId, uint32 parameterCount, compiler::ID** parameterIds) : InstTypeBase(Type::Function, THC_SPIRV_OPCODE_OpTypeFunction, 3), returnTypeId(returnTypeId), parameterCount(parameterCount) { wordCount += parameterCount; memcpy(parameterId, parameterIds, parameterCount * sizeof(void*)); }
 
-InstTypeImage::InstTypeImage(compiler::ID* sampledType, uint32 dim, uint32 depth, uint32 arrayed, uint32 multiSampled, uint32 sampled, uint32 imageFormat) : InstTypeBase(Type::SampledImage, THC_SPIRV_OPCODE_OpTypeImage, 9, "OpTypeImage"), sampledType(sampledType), dim(dim), depth(depth), arrayed(arrayed), multiSampled(multiSampled), sampled(sampled), imageFormat(imageFormat) {}
+InstTypeImage::InstTypeImage(compiler::ID* sampledType, uint32 dim, uint32 depth, uint32 arrayed, uint32 multiSampled, uint32 sampled, uint32 imageFormat) : InstTypeBase(Type::Image, THC_SPIRV_OPCODE_OpTypeImage, 9), sampledType(sampledType), dim(dim), depth(depth), arrayed(arrayed), multiSampled(multiSampled), sampled(sampled), imageFormat(imageFormat) {}
 
-InstTypeSampledImage::InstTypeSampledImage(compiler::ID* imageType) : InstTypeBase(Type::SampledImage, THC_SPIRV_OPCODE_OpTypeSampledImage, 3, "OpTypeSampledImage"), imageType(imageType) { }
+InstTypeSampledImage::InstTypeSampledImage(compiler::ID* imageType) : InstTypeBase(Type::SampledImage, THC_SPIRV_OPCODE_OpTypeSampledImage, 3), imageType(imageType) { }
 
 bool InstTypeVoid::operator==(const InstTypeBase* type) const {
 	return this->type == type->type;
@@ -175,6 +176,59 @@ bool InstTypeSampledImage::operator==(const InstTypeBase* type) const {
 	return imageType == ((InstTypeSampledImage*)type)->imageType;
 }
 
+uint64 InstTypeVoid::Hash() const {
+	return HashCombine(0, opCode);
+}
+
+uint64 InstTypeBool::Hash() const {
+	return HashCombine(0, opCode);
+}
+
+uint64 InstTypeInt::Hash() const {
+	return HashCombine(HashCombine(HashCombine(0, opCode), bits), sign);
+}
+
+uint64 InstTypeFloat::Hash() const {
+	return HashCombine(HashCombine(0, opCode), bits);
+}
+
+uint64 InstTypeVector::Hash() const {
+	return HashCombine(HashCombine(HashCombine(0, opCode), componentCount), (uint64)componentTypeId);
+}
+
+uint64 InstTypeMatrix::Hash() const {
+	return HashCombine(HashCombine(HashCombine(0, opCode), columnCount), (uint64)columnTypeId);
+}
+
+uint64 InstTypeArray::Hash() const {
+	return HashCombine(HashCombine(HashCombine(0, opCode), (uint64)elementCountId), (uint64)elementTypeId);
+}
+
+uint64 InstTypeStruct::Hash() const {
+	return HashBytes(memberTypeId, memberCount * sizeof(compiler::ID*), HashCombine(0, opCode));
+}
+
+uint64 InstTypePointer::Hash() const {
+	return HashCombine(HashCombine(HashCombine(0, opCode), storageClass), (uint64)typeId);
+}
+
+uint64 InstTypeFunction::Hash() const {
+	return HashBytes(parameterId, parameterCount * sizeof(compiler::ID*), HashCombine(HashCombine(0, opCode), (uint64)returnTypeId));
+}
+
+uint64 InstTypeImage::Hash() const {
+	uint64 hash = HashCombine(HashCombine(0, opCode), (uint64)sampledType);
+
+	hash = HashCombine(HashCombine(hash, dim), depth);
+	hash = HashCombine(HashCombine(hash, arrayed), multiSampled);
+
+	return HashCombine(HashCombine(hash, sampled), imageFormat);
+}
+
+uint64 InstTypeSampledImage::Hash() const {
+	return HashCombine(HashCombine(0, opCode), (uint64)imageType);
+}
+
 }
 }
 }
\ No newline at end of file
@@ -28,6 +28,7 @@ SOFTWARE.
 
 #include <core/spirvlimits.h>
 #include <core/instruction/instructions.h>
+#include <util/map.h>
 #include <core/parsing/token.h>
 
 namespace thc {
@@ -56,12 +57,15 @@ class InstTypeBase : public instruction::InstBase {
 public:
 	Type type;
 
-	InstTypeBase(Type type, uint32 opCode, uint32 wordCount, const char* const literalName);
+	InstTypeBase(Type type, uint32 opCode, uint32 wordCount);
 	virtual ~InstTypeBase();
 
 	virtual void GetInstWords(uint32* words) const = 0;
 
 	virtual bool operator==(const InstTypeBase* other) const = 0;
+
+	//Must be equal for types where operator== returns true
+	virtual uint64 Hash() const = 0;
 };
 
 class InstTypeVoid : public InstTypeBase {
@@ -71,6 +75,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeBool : public InstTypeBase {
@@ -80,6 +86,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeInt : public InstTypeBase {
@@ -92,6 +100,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeFloat : public InstTypeBase {
@@ -103,6 +113,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeVector : public InstTypeBase {
@@ -115,6 +127,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeMatrix : public InstTypeBase {
@@ -127,6 +141,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeArray : public InstTypeBase {
@@ -139,6 +155,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeStruct : public InstTypeBase {
@@ -151,6 +169,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypePointer : public InstTypeBase {
@@ -163,6 +183,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeFunction : public InstTypeBase {
@@ -176,6 +198,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeImage : public InstTypeBase {
@@ -193,6 +217,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 class InstTypeSampledImage : public InstTypeBase {
@@ -204,6 +230,8 @@ public:
 	void GetInstWords(uint32* words) const override;
 
 	bool operator==(const InstTypeBase* type) const override;
+
+	uint64 Hash() const override;
 };
 
 }
@@ -387,11 +387,17 @@ public:
 	/*Removes a range of items*/
 	inline void Remove(uint64 start, uint64 end) {
 		THC_ASSERT(start >= 0 && end < count);
-		uint64 count = end - start + 1;
+		uint64 num = end - start + 1;
 
-		for (uint64 i = 0; i < count; i++) {
-			RemoveAt(start);
+		for (uint64 i = start; i <= end; i++) {
+			T tmp(std::move(items[i]));
 		}
+
+		memmove(items+start, items+end+1, (count - end - 1) * sizeof(T));
+
+		count -= num;
+
+		memset(items+count, 0, num * sizeof(T));
 	}
 
 	/*Finds the item*/
@@ -39,6 +39,7 @@ using namespace core::parsing;
 
 HANDLE Log::logHandle = INVALID_HANDLE_VALUE;
 LogCallback Log::logCallback = nullptr;
+List<Diagnostic>* Log::diagnostics = nullptr;
 
 void Log::LogInternal(LogLevel level, const char* const message, va_list list) {
 	if (logHandle != INVALID_HANDLE_VALUE) {
@@ -78,11 +79,18 @@ void Log::LogInternal(LogLevel level, const char* const message, va_list list) {
 		SetConsoleTextAttribute(logHandle, info.wAttributes);
 	}
 
-	if (logCallback) {
+	if (logCallback || diagnostics) {
 		char buffer[4096] = { 0 };
 		vsprintf(buffer, message, list);
 
-		logCallback(level, buffer);
+		if (logCallback) logCallback(level, buffer);
+
+		if (diagnostics) {
+			if (level == LogLevel::Debug && !CompilerOptions::DebugMessages()) return;
+			if (level == LogLevel::Warning && !CompilerOptions::WarningMessages()) return;
+
+			diagnostics->Emplace(level, buffer);
+		}
 	}
 }
 
@@ -232,6 +240,10 @@ void Log::SetLogCallback(LogCallback logCallback) {
 	Log::logCallback = logCallback;
 }
 
+void Log::SetDiagnostics(List<Diagnostic>* diagnostics) {
+	Log::diagnostics = diagnostics;
+}
+
 
 }
 }
\ No newline at end of file
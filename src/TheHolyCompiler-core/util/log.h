@@ -41,11 +41,20 @@ enum class LogLevel {
 
 typedef void(*LogCallback)(LogLevel, const String& message);
 
+struct Diagnostic {
+	LogLevel level;
+	String message;
+
+	Diagnostic() : level(LogLevel::Info) {}
+	Diagnostic(LogLevel level, const char* const message) : level(level), message(message) {}
+};
+
 class Log {
 private:
 	static HANDLE logHandle;
 
 	static LogCallback logCallback;
+	static List<Diagnostic>* diagnostics;
 
 	static void LogInternal(LogLevel level, const char* const message, va_list list);
 
@@ -73,6 +82,8 @@ public:
 
 	static void SetOutputHandle(HANDLE logHandle);
 	static void SetLogCallback(LogCallback logCallback);
+	//Every message is also added to diagnostics until it's set to nullptr
+	static void SetDiagnostics(List<Diagnostic>* diagnostics);
 };
 
 }
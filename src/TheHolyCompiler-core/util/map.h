@@ -0,0 +1,254 @@
+/*
+MIT License
+
+Copyright (c) 2018 Jesper Hammarstrm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "thc_assert.h"
+#include "string.h"
+#include <core/thctypes.h>
+
+#define THC_MAP_INITIAL_CAPACITY 16
+
+namespace thc {
+namespace utils {
+
+inline uint64 HashBytes(const void* data, uint64 size, uint64 hash = 0xCBF29CE484222325) {
+	const uint8* bytes = (const uint8*)data;
+
+	for (uint64 i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * 0x100000001B3;
+	}
+
+	return hash;
+}
+
+inline uint64 HashCombine(uint64 hash, uint64 value) {
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCD;
+	value ^= value >> 33;
+
+	return (hash ^ value) * 0x100000001B3;
+}
+
+//Keys that aren't listed here must implement "uint64 Hash() const" and operator==
+template<typename K>
+struct Hasher {
+	static uint64 Hash(const K& key) { return key.Hash(); }
+};
+
+template<>
+struct Hasher<String> {
+	static uint64 Hash(const String& key) { return HashBytes(key.str, key.length); }
+};
+
+template<>
+struct Hasher<uint64> {
+	static uint64 Hash(const uint64& key) { return HashCombine(0, key); }
+};
+
+template<>
+struct Hasher<uint32> {
+	static uint64 Hash(const uint32& key) { return HashCombine(0, key); }
+};
+
+template<typename T>
+struct Hasher<T*> {
+	static uint64 Hash(T* const& key) { return HashCombine(0, (uint64)key); }
+};
+
+//Open addressing hash map with linear probing
+template<typename K, typename V>
+class Map {
+private:
+	struct Entry {
+		K key;
+		V value;
+
+		uint64 hash;
+		bool used;
+
+		Entry() : hash(0), used(false) {}
+	};
+
+	Entry* entries;
+
+	uint64 count;
+	uint64 capacity; //Always a power of two
+
+	inline uint64 FindIndex(const K& key, uint64 hash) const {
+		uint64 mask = capacity - 1;
+
+		for (uint64 i = hash & mask;; i = (i + 1) & mask) {
+			const Entry& e = entries[i];
+
+			if (!e.used) return ~0;
+			if (e.hash == hash && e.key == key) return i;
+		}
+	}
+
+	inline void Rehash(uint64 newCapacity) {
+		Entry* old = entries;
+		uint64 oldCapacity = capacity;
+
+		entries = new Entry[newCapacity];
+		capacity = newCapacity;
+
+		uint64 mask = capacity - 1;
+
+		for (uint64 i = 0; i < oldCapacity; i++) {
+			Entry& e = old[i];
+
+			if (!e.used) continue;
+
+			uint64 index = e.hash & mask;
+
+			while (entries[index].used) index = (index + 1) & mask;
+
+			Entry& n = entries[index];
+
+			n.key = std::move(e.key);
+			n.value = std::move(e.value);
+			n.hash = e.hash;
+			n.used = true;
+		}
+
+		delete[] old;
+	}
+
+public:
+	Map(uint64 reserve = THC_MAP_INITIAL_CAPACITY) : count(0), capacity(THC_MAP_INITIAL_CAPACITY) {
+		while (capacity < reserve) capacity <<= 1;
+
+		entries = new Entry[capacity];
+	}
+
+	Map(const Map& other) = delete;
+	Map& operator=(const Map& other) = delete;
+
+	~Map() {
+		delete[] entries;
+	}
+
+	/*Returns a pointer to the value or nullptr if the key doesn't exist*/
+	inline V* Get(const K& key) {
+		uint64 index = FindIndex(key, Hasher<K>::Hash(key));
+
+		return index == ~0 ? nullptr : &entries[index].value;
+	}
+
+	inline const V* Get(const K& key) const {
+		uint64 index = FindIndex(key, Hasher<K>::Hash(key));
+
+		return index == ~0 ? nullptr : &entries[index].value;
+	}
+
+	/*Adds the key or replaces the value if it already exist*/
+	inline void Set(const K& key, const V& value) {
+		uint64 hash = Hasher<K>::Hash(key);
+		uint64 index = FindIndex(key, hash);
+
+		if (index != ~0) {
+			entries[index].value = value;
+			return;
+		}
+
+		if ((count + 1) * 4 > capacity * 3) {
+			Rehash(capacity << 1);
+		}
+
+		uint64 mask = capacity - 1;
+
+		index = hash & mask;
+
+		while (entries[index].used) index = (index + 1) & mask;
+
+		Entry& e = entries[index];
+
+		e.key = key;
+		e.value = value;
+		e.hash = hash;
+		e.used = true;
+
+		count++;
+	}
+
+	/*Removes the key, returns false if it doesn't exist*/
+	inline bool Remove(const K& key) {
+		uint64 index = FindIndex(key, Hasher<K>::Hash(key));
+
+		if (index == ~0) return false;
+
+		uint64 mask = capacity - 1;
+
+		entries[index].used = false;
+
+		//Shift back the following entries so no probe sequence is broken
+		for (uint64 i = (index + 1) & mask; entries[i].used; i = (i + 1) & mask) {
+			Entry& e = entries[i];
+
+			uint64 home = e.hash & mask;
+
+			bool stays = index < i ? (home > index && home <= i) : (home > index || home <= i);
+
+			if (stays) continue;
+
+			Entry& hole = entries[index];
+
+			hole.key = std::move(e.key);
+			hole.value = std::move(e.value);
+			hole.hash = e.hash;
+			hole.used = true;
+
+			e.used = false;
+			index = i;
+		}
+
+		count--;
+
+		return true;
+	}
+
+	inline void Clear() {
+		delete[] entries;
+
+		count = 0;
+		capacity = THC_MAP_INITIAL_CAPACITY;
+		entries = new Entry[capacity];
+	}
+
+	inline uint64 GetCount() const { return count; }
+
+	/*Calls func(key, value) for every entry, in no particular order*/
+	template<typename F>
+	inline void ForEach(F func) {
+		for (uint64 i = 0; i < capacity; i++) {
+			Entry& e = entries[i];
+
+			if (e.used) func(e.key, e.value);
+		}
+	}
+};
+
+}
+}
@@ -250,10 +250,9 @@ ValueResult Utils::StringToValue(const char* string, uint64* length, const Line&
 		value += v * (uint64)pow((double)base, (double)i);
 	}
 
-	if (sign) value *= -1;
-
 	*length = len;
 
+	//The minus is a separate token that negates the value, only the magnitude is kept here
 	ValueResult res;
 	
 	if (string[len] == '.') {
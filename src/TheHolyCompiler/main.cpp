@@ -43,8 +43,17 @@ int main() {
 int main(int argc, char** argv) {
 	Log::SetOutputHandle(GetStdHandle(STD_OUTPUT_HANDLE));
 
-	CompilerOptions::ParseOptions(argc, argv);
-	Compiler::Run(CompilerOptions::InputFile(), CompilerOptions::PredefinedDefines(), CompilerOptions::IncludeDirectories(), CompilerOptions::OutputFile());
+	if (!CompilerOptions::ParseOptions(argc, argv)) return 1;
+
+	if (CompilerOptions::RecompileFile().length != 0) {
+		return Compiler::CheckRecompile(CompilerOptions::InputFile(), CompilerOptions::RecompileFile(), CompilerOptions::PredefinedDefines(), CompilerOptions::IncludeDirectories(), CompilerOptions::OutputFile()) ? 0 : 1;
+	}
+
+	if (CompilerOptions::Link()) {
+		Compiler::Link(CompilerOptions::InputFile(), CompilerOptions::LinkFile(), CompilerOptions::PredefinedDefines(), CompilerOptions::IncludeDirectories(), CompilerOptions::OutputFile());
+	} else {
+		Compiler::Run(CompilerOptions::InputFile(), CompilerOptions::PredefinedDefines(), CompilerOptions::IncludeDirectories(), CompilerOptions::OutputFile());
+	}
 
 	/*String s = Line::ToString(PreProcessor::Run(path+"/test.thsl", defines, includes));
 